@@ -12,13 +12,14 @@ mkdir -p build
 echo "[BUILD] Compiling CCM EdgeVision (Professional Edition)..."
 
 # 2. Define Source Files (Explicit list to avoid linking old test files)
-SOURCES="src/main.cpp src/camera_input.cpp src/config.cpp src/detector.cpp src/overlay_renderer.cpp src/tracker.cpp"
+SOURCES="src/main.cpp src/assignment.cpp src/batch_scheduler.cpp src/camera_input.cpp src/config.cpp src/config_watcher.cpp src/detector.cpp src/frame_sink.cpp src/http_server.cpp src/inference_backend.cpp src/kalman_filter.cpp src/logger.cpp src/mat_pool.cpp src/metrics.cpp src/metrics_exporter.cpp src/mjpeg_sink.cpp src/motion_gate.cpp src/nms.cpp src/onnxruntime_backend.cpp src/opencv_dnn_backend.cpp src/overlay_renderer.cpp src/pipeline.cpp src/preprocessor.cpp src/rtsp_sink.cpp src/shm_publisher.cpp src/spatial_grid.cpp src/tiling.cpp src/tracker.cpp src/video_output.cpp src/yolo_decoder.cpp src/zone_engine.cpp src/zone_index.cpp"
 
 # 3. Compile
 # We use pkg-config to automatically find OpenCV paths
 g++ $SOURCES -o build/ccm_edgevision \
     -std=c++17 \
     -I include \
+    -pthread -lrt \
     $(pkg-config --cflags --libs opencv4)
 
 # 4. Check Status
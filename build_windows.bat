@@ -12,7 +12,7 @@ IF NOT EXIST build mkdir build
 echo [BUILD] Compiling CCM EdgeVision (Professional Edition)...
 
 REM We explicitly list source files to avoid linking conflicts with old test files
-set SOURCES=src\main.cpp src\camera_input.cpp src\config.cpp src\detector.cpp src\overlay_renderer.cpp src\tracker.cpp
+set SOURCES=src\main.cpp src\assignment.cpp src\batch_scheduler.cpp src\camera_input.cpp src\config.cpp src\config_watcher.cpp src\detector.cpp src\frame_sink.cpp src\http_server.cpp src\inference_backend.cpp src\kalman_filter.cpp src\logger.cpp src\mat_pool.cpp src\metrics.cpp src\metrics_exporter.cpp src\mjpeg_sink.cpp src\motion_gate.cpp src\nms.cpp src\onnxruntime_backend.cpp src\opencv_dnn_backend.cpp src\overlay_renderer.cpp src\pipeline.cpp src\preprocessor.cpp src\rtsp_sink.cpp src\shm_publisher.cpp src\spatial_grid.cpp src\tiling.cpp src\tracker.cpp src\video_output.cpp src\yolo_decoder.cpp src\zone_engine.cpp src\zone_index.cpp
 
 cl /EHsc /W4 /wd4127 %SOURCES% /Fo:build\ /I include /I C:\opencv\build\include ^
    /Fe:build\ccm_edgevision.exe ^
@@ -1,5 +1,5 @@
-import cv2
-import time
+import urllib.error
+import urllib.request
 import yaml
 import os
 from flask import Flask, Response, render_template_string
@@ -38,7 +38,8 @@ PAGE_HTML = """
     <style>
         body { background-color: #121212; color: #ffffff; font-family: monospace; text-align: center; }
         h1 { color: #00ff00; margin-top: 20px; }
-        .container { display: flex; justify-content: center; margin-top: 20px; }
+        .container { display: flex; flex-wrap: wrap; justify-content: center; margin-top: 20px; }
+        .stream { margin: 10px; }
         img { border: 2px solid #333; box-shadow: 0 0 20px rgba(0, 255, 0, 0.2); }
         .stats { margin-top: 20px; color: #888; }
     </style>
@@ -46,58 +47,46 @@ PAGE_HTML = """
 <body>
     <h1>CCM EdgeVision // Remote Stream</h1>
     <div class="container">
-        <img src="/video_feed" width="{{ width }}" height="{{ height }}">
+    {% for name in streams %}
+        <div class="stream">
+            <div>{{ name }}</div>
+            <img src="/video_feed/{{ name }}" width="{{ width }}" height="{{ height }}">
+        </div>
+    {% endfor %}
     </div>
     <div class="stats">
-        Status: LIVE | Device: Jetson/Pi | Protocol: MJPEG <br>
-        Resolution: {{ width }}x{{ height }} | MJPEG Mode: {{ mjpg }}
+        Status: LIVE | Device: Jetson/Pi | Protocol: MJPEG (annotated, from ccm_edgevision) <br>
+        Resolution: {{ width }}x{{ height }} | Source: {{ source }}
     </div>
 </body>
 </html>
 """
 
-def gen_frames(config):
-    # Extract settings with safe defaults
-    cam_conf = config.get('camera', {})
-    idx = cam_conf.get('index', 0)
-    width = cam_conf.get('width', 640)
-    height = cam_conf.get('height', 480)
-    fps = cam_conf.get('fps', 30)
-    force_mjpg = cam_conf.get('force_mjpg', False)
+def stream_names(config):
+    # Same defaults as AppConfig::load: cameras[].name, or cam<N>
+    cameras = config.get('cameras') or [config.get('camera', {})]
+    return [c.get('name') or 'cam%d' % i for i, c in enumerate(cameras)]
 
-    print(f"[System] Opening Camera {idx} at {width}x{height} (MJPEG={force_mjpg})...")
+def source_url(config):
+    # The C++ process captures, infers and encodes; the dashboard only relays its MJPEG output
+    out = config.get('output', {})
+    host = out.get('bind', '127.0.0.1')
+    if host == '0.0.0.0':
+        host = '127.0.0.1'
+    return 'http://%s:%d' % (host, out.get('mjpeg_port', 8090))
 
-    # 1. Access Camera with V4L2 backend
-    camera = cv2.VideoCapture(idx, cv2.CAP_V4L2)
-    
-    # 2. Apply Configuration
-    if force_mjpg:
-        camera.set(cv2.CAP_PROP_FOURCC, cv2.VideoWriter_fourcc(*'MJPG'))
-    
-    camera.set(cv2.CAP_PROP_FRAME_WIDTH, width)
-    camera.set(cv2.CAP_PROP_FRAME_HEIGHT, height)
-    camera.set(cv2.CAP_PROP_FPS, fps)
-
-    if not camera.isOpened():
-        print("❌ Error: Could not open camera.")
+def relay(url):
+    try:
+        upstream = urllib.request.urlopen(url, timeout=5)
+    except (urllib.error.URLError, OSError) as e:
+        print(f"❌ Error: Cannot reach {url} ({e}). Is ccm_edgevision running with output.mjpeg_port set?")
         return
-
-    while True:
-        success, frame = camera.read()
-        
-        if not success:
-            print("⚠️ Warning: Dropped frame (retrying...)")
-            time.sleep(0.1)
-            continue 
-        
-        # Timestamp Overlay
-        cv2.putText(frame, f"REC: {time.time():.2f}", (20, height - 20), 
-                    cv2.FONT_HERSHEY_SIMPLEX, 0.5, (255, 255, 255), 1)
-
-        ret, buffer = cv2.imencode('.jpg', frame)
-        frame = buffer.tobytes()
-        yield (b'--frame\r\n'
-               b'Content-Type: image/jpeg\r\n\r\n' + frame + b'\r\n')
+    with upstream:
+        while True:
+            chunk = upstream.read(16384)
+            if not chunk:
+                break
+            yield chunk
 
 @app.route('/')
 def index():
@@ -105,13 +94,16 @@ def index():
     config = load_config()
     w = config.get('camera', {}).get('width', 640)
     h = config.get('camera', {}).get('height', 480)
-    m = config.get('camera', {}).get('force_mjpg', False)
-    return render_template_string(PAGE_HTML, width=w, height=h, mjpg=m)
+    return render_template_string(PAGE_HTML, width=w, height=h, streams=stream_names(config),
+                                  source=source_url(config))
 
 @app.route('/video_feed')
-def video_feed():
+@app.route('/video_feed/<name>')
+def video_feed(name=None):
     config = load_config()
-    return Response(gen_frames(config), mimetype='multipart/x-mixed-replace; boundary=frame')
+    path = '/stream/%s.mjpg' % name if name else '/stream.mjpg'
+    # ccm_edgevision uses the same multipart boundary ("frame"), so bytes pass through unchanged
+    return Response(relay(source_url(config) + path), mimetype='multipart/x-mixed-replace; boundary=frame')
 
 if __name__ == '__main__':
-    app.run(host='0.0.0.0', port=5000)
\ No newline at end of file
+    app.run(host='0.0.0.0', port=5000, threaded=True)
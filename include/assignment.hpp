@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief Minimum-cost rectangular assignment (Hungarian / Kuhn-Munkres with potentials).
+ * Runs in O(n^2 * m) for an n x m matrix (n <= m after an internal transpose).
+ * Scratch buffers are members so repeated per-frame solves do not allocate once warmed up.
+ */
+class HungarianSolver {
+public:
+    // Costs at or above this value mark pairs that must never be matched.
+    static constexpr float kInfeasible = 1e6f;
+
+    /**
+     * @param cost       Row-major rows x cols cost matrix.
+     * @param rows       Number of rows (e.g. tracks).
+     * @param cols       Number of columns (e.g. detections).
+     * @param row_to_col Output: matched column per row, or -1 (unmatched or infeasible).
+     * @return Number of feasible matches.
+     */
+    int solve(const std::vector<float>& cost, int rows, int cols, std::vector<int>& row_to_col);
+
+private:
+    std::vector<float> work_;    // Transposed copy when rows > cols
+    std::vector<double> u_, v_, min_v_;
+    std::vector<int> p_, way_;
+    std::vector<char> used_;
+};
+
+} // namespace CCM
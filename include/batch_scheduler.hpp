@@ -0,0 +1,110 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "config.hpp"
+#include "config_store.hpp"
+#include "detector.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Collects frames from several camera streams into one Detector::detectBatch() call.
+ * One scheduler (and one worker thread) serves every stream, so the model is loaded once and
+ * only one forward pass runs at a time.
+ *
+ * A batch is dispatched as soon as either:
+ *   - `max_batch` frames are pending, or
+ *   - every registered stream has a frame pending, or
+ *   - the oldest pending frame has waited `max_wait_ms` (bounded latency).
+ *
+ * When more streams are waiting than fit in a batch, `batching.policy` decides who goes first:
+ *   - "round_robin": one frame per stream in turn, starting after the last stream served.
+ *   - "priority":    higher CameraConfig::priority first; a frame that has waited more than
+ *                    4 x max_wait_ms is served regardless, so low-priority streams cannot starve.
+ *
+ * The scheduler does not allocate in steady state: completion is a per-stream slot rather than a
+ * promise, the queue and batch scratch are reused members, and results are copied element-wise
+ * into the caller's list. That copy only reuses storage if the caller recycles its lists (the
+ * pipeline hands them back from the output stage); a fresh list is allocated by the copy.
+ */
+class BatchScheduler {
+public:
+    BatchScheduler(Detector& detector, const AppConfig& config);
+    ~BatchScheduler();
+
+    BatchScheduler(const BatchScheduler&) = delete;
+    BatchScheduler& operator=(const BatchScheduler&) = delete;
+
+    void start();
+    void stop();
+
+    /**
+     * @brief Registers a stream before start(). Its config supplies the thresholds and zones used
+     * to filter its detections and `camera.priority`; each batch uses the newest snapshot. The
+     * store must outlive the scheduler.
+     * @return Stream id to pass to submit().
+     */
+    int addStream(const ConfigStore& stream_config);
+
+    /**
+     * @brief Runs a frame through the next batch and waits for it. One call at a time per stream.
+     * @param detections Receives the frame's detections; overwritten in place, so keep one list
+     *                   per stream and pass it every frame.
+     * @return false (and no detections) if the scheduler is stopped or the stream id is unknown.
+     */
+    bool submit(int stream_id, const cv::Mat& frame, std::vector<Detection>& detections);
+
+private:
+    struct Request {
+        int stream_id;
+        cv::Mat frame;
+        std::chrono::steady_clock::time_point enqueued_at;
+        std::vector<Detection>* output;   // Caller-owned, filled before the stream's slot is marked done
+    };
+
+    // Completion slot of one stream, reused for each of its frames (guarded by mutex_)
+    struct Slot {
+        std::condition_variable done_cv;
+        bool done = true;
+    };
+
+    void workerLoop();
+
+    // Moves up to `max_batch` requests from pending_ into `batch` according to the policy (lock held)
+    void takeBatch(std::vector<Request>& batch, size_t max_batch);
+
+    // Marks a stream's request done and wakes its submit() (lock held)
+    void complete(int stream_id);
+
+    Detector& detector_;
+    const AppConfig& config_;
+    bool priority_policy_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Request> pending_;   // FIFO; taken requests are erased in place
+    std::vector<const ConfigStore*> streams_;
+    std::vector<std::unique_ptr<Slot>> slots_;   // Per stream
+    std::vector<std::shared_ptr<const AppConfig>> snapshots_;   // Per stream, refreshed once per batch
+    std::vector<uint64_t> snapshot_versions_;
+    size_t next_stream_ = 0;   // Round-robin cursor
+
+    // takeBatch() scratch
+    std::vector<uint8_t> taken_;
+    std::vector<size_t> picks_;
+    std::vector<size_t> order_;
+
+    // Worker-thread scratch
+    std::vector<std::vector<Detection>> results_;
+    bool running_ = false;
+
+    std::thread worker_;
+};
+
+} // namespace CCM
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief What a producer does when the downstream stage is not keeping up.
+ */
+enum class BackpressurePolicy {
+    Block,      // Producer waits for a free slot (no frame is ever lost).
+    DropOldest  // Oldest queued item is discarded so the newest frame always gets in (lowest latency).
+};
+
+/**
+ * @brief Fixed-capacity FIFO connecting two pipeline stages.
+ * Slots are allocated once in the constructor; push/pop only move items in and out.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity, BackpressurePolicy policy = BackpressurePolicy::DropOldest)
+        : slots_(capacity > 0 ? capacity : 1), policy_(policy) {}
+
+    /**
+     * @brief Enqueue an item according to the backpressure policy.
+     * @return false if the queue has been closed (item is discarded).
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (policy_ == BackpressurePolicy::Block) {
+            not_full_.wait(lock, [this] { return closed_ || count_ < slots_.size(); });
+        }
+        if (closed_) return false;
+
+        if (count_ == slots_.size()) {
+            // DropOldest: overwrite the head slot and advance
+            head_ = (head_ + 1) % slots_.size();
+            --count_;
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        slots_[(head_ + count_) % slots_.size()] = std::move(item);
+        ++count_;
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Dequeue the oldest item, blocking until one is available.
+     * @return false once the queue is closed and fully drained.
+     */
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || count_ > 0; });
+        if (count_ == 0) return false;
+
+        out = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Dequeue the oldest item if one is available, without waiting.
+     */
+    bool tryPop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (count_ == 0) return false;
+
+        out = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Wake all waiters. Pending items can still be popped; new pushes are rejected.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+    // Number of items discarded by DropOldest since construction.
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool closed_ = false;
+    BackpressurePolicy policy_;
+    std::atomic<size_t> dropped_{0};
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+} // namespace CCM
@@ -0,0 +1,100 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "config.hpp"
+
+namespace CCM {
+
+/**
+ * @brief A captured frame as delivered by the driver.
+ * For the V4L2 backend `image` is a header over the kernel's mmap buffer (no copy):
+ *   - YUYV  -> CV_8UC2, height x width
+ *   - MJPEG -> CV_8UC1, 1 x bytesused (compressed bitstream)
+ * For the OpenCV fallback `image` is already BGR.
+ * The data is only valid until the frame is handed back with CameraInput::release().
+ */
+struct CameraFrame {
+    cv::Mat image;
+    uint32_t fourcc = 0;     // V4L2 pixel format, 0 when already BGR
+    int buffer_index = -1;   // Driver buffer slot, -1 when not backed by an mmap buffer
+    uint64_t sequence = 0;   // Driver frame counter (detects drops at the source)
+};
+
+/**
+ * @brief Camera capture with a zero-copy V4L2 mmap backend and a cv::VideoCapture fallback.
+ *
+ * Backend selection (CameraConfig::backend):
+ *   - "v4l2"   : Streaming I/O on /dev/videoN with `buffer_count` mmap buffers. Fails if unavailable.
+ *   - "opencv" : cv::VideoCapture (also used for video files / non-Linux hosts).
+ *   - "auto"   : Try V4L2 first, then fall back to OpenCV.
+ *
+ * `CameraConfig::device` may point at a v4l2loopback node (e.g. /dev/video10) or at a
+ * recorded video file, which makes the capture path testable without real hardware.
+ */
+class CameraInput {
+public:
+    explicit CameraInput(const CameraConfig& config);
+    ~CameraInput();
+
+    CameraInput(const CameraInput&) = delete;
+    CameraInput& operator=(const CameraInput&) = delete;
+
+    bool open();
+    void close();
+    bool isOpened() const;
+
+    /**
+     * @brief Dequeue the next frame without copying it.
+     * Caller must call release() once done so the driver can refill the buffer.
+     * @return false on timeout or device error.
+     */
+    bool grab(CameraFrame& frame);
+
+    /**
+     * @brief Return a grabbed buffer to the driver queue.
+     */
+    void release(CameraFrame& frame);
+
+    /**
+     * @brief Grab, convert to BGR directly from the mapped buffer into `bgr`, and release.
+     * `bgr` storage is reused when its size/type already match.
+     */
+    bool read(cv::Mat& bgr);
+
+    CameraInput& operator>>(cv::Mat& bgr);
+
+    // "v4l2", "opencv" or "none"
+    const char* backendName() const;
+    cv::Size frameSize() const { return frame_size_; }
+
+private:
+    std::string devicePath() const;
+
+    bool openV4L2();
+    void closeV4L2();
+    bool openFallback();
+
+    struct MappedBuffer {
+        void* start = nullptr;
+        size_t length = 0;
+    };
+
+    CameraConfig config_;
+
+    // V4L2 state
+    int fd_ = -1;
+    bool streaming_ = false;
+    uint32_t pixel_format_ = 0;
+    size_t bytes_per_line_ = 0;
+    std::vector<MappedBuffer> buffers_;
+
+    // OpenCV fallback
+    cv::VideoCapture cap_;
+    bool use_fallback_ = false;
+
+    cv::Size frame_size_;
+};
+
+} // namespace CCM
@@ -1,17 +1,21 @@
 #pragma once
 #include <opencv2/opencv.hpp>
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace CCM {
 
+class ZoneIndex;
+
 /**
  * @brief Represents a user-defined area of interest in the camera feed.
  * Loaded dynamically from zones.yaml.
  */
 struct ZoneConfig {
     std::string name;
-    cv::Rect rect;
+    cv::Rect rect;                     // For polygon zones: the polygon's bounding box
+    std::vector<cv::Point> polygon;    // Optional; empty = the zone is `rect`
     cv::Scalar color;
     std::string trigger_class; // The object class (e.g., "person") that triggers an alert here.
     
@@ -19,6 +23,22 @@ struct ZoneConfig {
     std::string toJSON() const;
 };
 
+/**
+ * @brief Directional counting line (see ZoneEngine). A track crossing segment a->b raises a
+ * crossing event; "in" is from the left to the right side of a->b as seen on screen.
+ */
+struct LineConfig {
+    std::string name;
+    cv::Point a;
+    cv::Point b;
+    cv::Scalar color;
+    std::string trigger_class;         // Empty = every class
+    std::string direction = "both";    // Which crossings raise events: "both", "in" or "out"
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
 // Hardware configuration struct
 struct CameraConfig {
     int index = 0;
@@ -26,6 +46,16 @@ struct CameraConfig {
     int height = 480;
     int fps = 30;
     bool force_mjpg = false;
+    std::string device;             // Optional override: "/dev/video10" (v4l2loopback) or a video file path
+    std::string backend = "auto";   // "auto" (V4L2 then OpenCV), "v4l2", or "opencv"
+    int buffer_count = 4;           // V4L2 mmap ring size
+
+    // Multi-camera (`cameras:` list)
+    std::string name;               // Window title / log tag. Defaults to "cam<N>"
+    int priority = 0;               // batching.policy "priority": higher is served first
+    std::vector<ZoneConfig> zones;  // Per-camera zones; empty = use the global `zones`
+    std::vector<std::string> active_search_zones; // Per-camera restriction; empty = use the global list
+    std::vector<LineConfig> lines;  // Per-camera counting lines; empty = use the global `lines`
 
     std::string toString() const;
     std::string toJSON() const;
@@ -35,6 +65,164 @@ struct ModelConfig {
     int input_width = 640;
     int input_height = 640;
 
+    // Inference runtime (see inference_backend.hpp)
+    std::string backend = "auto";  // "auto" (startup self-benchmark), "opencv_cpu", "opencv_opencl",
+                                   // "opencv_openvino", "opencv_vulkan", "opencv_cuda", "onnxruntime"
+    int intra_op_threads = 0;      // onnxruntime: threads inside one operator (0 = runtime default)
+    int inter_op_threads = 0;      // onnxruntime: operators run in parallel (0 = sequential)
+    int benchmark_runs = 10;       // auto: timed forward passes per candidate backend
+    std::string precision = "fp32"; // "fp32", "fp16" or "int8" (QDQ). fp16/int8 load <model>.<precision>.onnx
+                                    // when it exists (see scripts/quantize_model.py)
+    std::string output_layout = "auto"; // "auto" (from the output shape), "yolov5" ([25200 x 85] rows with
+                                        // objectness), "yolov8" ([84 x 8400], YOLOv8/v11) or "yolov8_transposed"
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Multi-object tracker settings
+struct TrackerConfig {
+    std::string mode = "hungarian"; // "hungarian" (global IoU/distance assignment) or "greedy" (nearest centroid)
+    int max_lost_frames = 5;        // Frames a track survives without a matching detection
+    float dist_threshold = 50.0f;   // Max centroid distance (px) for a match
+    float iou_threshold = 0.1f;     // hungarian: pairs below this IoU are matched on centroid distance only
+    int grid_cell = 0;              // hungarian: spatial index cell size (px). 0 = 2 x dist_threshold
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Detection scheduling: run the network on a subset of frames, Kalman-predict tracks in between
+struct DetectionConfig {
+    int every_n_frames = 1;        // 1 = every frame, 3 = every 3rd frame
+    bool adaptive = false;         // Also detect on every frame while nothing is tracked or tracks move fast
+    float adaptive_speed = 8.0f;   // Track speed (px/frame) above which adaptive mode detects every frame
+    bool roi_inference = false;    // With active_search_zones: run the network only on crops around them
+    int roi_max_tiles = 4;         // More crops than this: fall back to one full-frame pass
+    int tile_overlap = 32;         // Pixels shared by neighbouring crops, so edge objects appear whole in one
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Non-maximum suppression (see nms.hpp); the IoU threshold is the top-level nms_threshold
+struct NmsConfig {
+    std::string method = "greedy";   // "greedy", "soft" (Gaussian Soft-NMS) or "matrix" (Matrix NMS)
+    bool per_class = true;           // false = one class can suppress another (cv::dnn::NMSBoxes behaviour)
+    int top_k = 1000;                // Best candidates that enter suppression; 0 = all
+    int max_detections = 300;        // Results per frame at most; 0 = all
+    float sigma = 0.5f;              // soft / matrix: Gaussian decay width
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Motion gate: skip the detector on frames where nothing changed (see motion_gate.hpp)
+struct MotionConfig {
+    bool enabled = false;
+    int width = 160;               // Frames are compared downsampled to this width
+    int pixel_threshold = 25;      // Grey-level difference that counts a pixel as changed
+    float min_changed = 0.002f;    // Fraction of changed pixels that counts as motion
+    int max_skip_frames = 30;      // Detect at least this often even in a static scene
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Tiled (SAHI-style) inference for high-resolution frames with small objects
+struct TilingConfig {
+    std::string mode = "off";        // "off", "grid" (tile the whole frame) or "adaptive" (tile around coarse hits)
+    int tile_width = 0;              // Tile size in frame pixels; 0 = the model input size (no rescaling)
+    int tile_height = 0;
+    int overlap = 64;                // Pixels shared by neighbouring tiles
+    bool full_frame = true;          // grid: also run a downscaled full-frame pass (large objects)
+    std::string merge = "nms";       // "nms" (per-class) or "wbf" (weighted box fusion, then NMS)
+    float merge_iou = 0.55f;         // wbf: overlap at which boxes of one class are fused
+    float coarse_threshold = 0.1f;   // adaptive: confidence of full-frame candidates that seed tiles
+    int max_tiles = 16;              // Tiles run per frame at most; tiles are enlarged (downscaled) to fit
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Threaded pipeline settings (capture -> inference -> render/output)
+struct PipelineConfig {
+    int queue_depth = 2;                  // Frames buffered between two stages
+    std::string backpressure = "drop_oldest"; // "drop_oldest" (lowest latency) or "block" (never lose a frame)
+    int mat_pool_mb = 64;                 // Freed cv::Mat buffers kept for reuse (see mat_pool.hpp). 0 = off
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Multi-stream batched inference settings
+struct BatchConfig {
+    int max_batch = 4;     // Max frames per forward pass (N in N x 3 x H x W)
+    int max_wait_ms = 8;   // Max time the oldest frame waits for the batch to fill
+    std::string policy = "round_robin"; // Which streams fill a batch first: "round_robin" (fair) or "priority"
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Annotated video outputs (see video_output.hpp)
+struct OutputConfig {
+    bool display = true;              // cv::imshow window per camera. false = headless
+    int mjpeg_port = 8090;            // MJPEG over HTTP at http://<bind>:<port>/. 0 disables
+    std::string bind = "127.0.0.1";   // Use "0.0.0.0" to watch from another host
+    int jpeg_quality = 80;
+    int max_fps = 15;                 // Encoded frames per second per stream (0 = every frame)
+    std::string rtsp_url;             // H.264 via ffmpeg, e.g. "rtsp://127.0.0.1:8554/{name}". Empty disables
+    int rtsp_bitrate_kbps = 2000;
+    std::string ffmpeg = "ffmpeg";    // ffmpeg executable
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Shared-memory frame + detection bus for out-of-process readers (see shm_publisher.hpp)
+struct ShmConfig {
+    bool enabled = false;
+    std::string name = "/ccm_{name}";   // POSIX shm name per camera; {name} = camera name
+    int slots = 4;                      // Ring length; a zero-copy reader has slots-1 frame periods
+    int max_width = 0;                  // Slot capacity. 0 = size of the first frame
+    int max_height = 0;
+    int max_detections = 256;           // Records per frame; extra tracks are not published
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Zone / line events per track (see zone_engine.hpp)
+struct EventsConfig {
+    bool enabled = true;
+    int debounce_frames = 3;      // Frames a track must stay inside/outside before enter/exit fires (1-255)
+    float dwell_s = 10.0f;        // Dwell event after this long inside a zone (0 disables)
+    int line_margin = 4;          // Pixels from a line within which the side is not updated (jitter)
+    int queue_capacity = 1024;    // Lock-free event queue shared by all cameras; full = event dropped
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Logger settings (see logger.hpp)
+struct LoggingConfig {
+    std::string level;   // "trace", "debug", "info", "warn", "error", "off". Empty: derived from debug.enabled
+    bool json = false;   // One JSON object per line instead of plain text
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
+// Metrics surface (see metrics.hpp)
+struct MetricsConfig {
+    bool enabled = true;
+    int http_port = 9100;            // Prometheus text at /metrics, JSON at /metrics.json. 0 disables
+    std::string bind = "127.0.0.1";  // Use "0.0.0.0" to expose the endpoint on the network
+    std::string json_path;           // Periodic JSON dump (written atomically). Empty disables
+    int json_interval_s = 10;
+    bool overlay = true;             // FPS / latency header bar on the output frame
+
     std::string toString() const;
     std::string toJSON() const;
 };
@@ -47,6 +235,15 @@ struct DebugConfig {
     std::string toJSON() const;
 };
 
+// Config file hot reload (see config_watcher.hpp)
+struct ReloadConfig {
+    bool enabled = true;
+    int debounce_ms = 200;        // Quiet time after the last write before the file is re-read
+
+    std::string toString() const;
+    std::string toJSON() const;
+};
+
 /**
  * @brief Global application configuration settings.
  * Handles the "Customization Package" requirements without recompilation.
@@ -57,18 +254,33 @@ struct AppConfig {
     std::string class_names;
     
     // Detection Sensitivity
-    float confidence_threshold; // Minimum confidence (0.0 - 1.0) to consider a detection valid.
-    float nms_threshold;        // Overlap threshold for Non-Maximum Suppression (avoids duplicate boxes).
+    float confidence_threshold = 0.25f; // Minimum confidence (0.0 - 1.0) to consider a detection valid.
+    float nms_threshold = 0.4f;         // Overlap threshold for Non-Maximum Suppression (avoids duplicate boxes).
     
     // Model Preprocessing Params
     float pixel_scale = 1.0f; 
     int input_width = 640;
     int input_height = 640;
     bool swap_rb = true;
+    bool letterbox = true;      // Keep aspect ratio (pad to the input size) instead of stretching
 
-    CameraConfig camera; 
+    CameraConfig camera;                 // First entry of `cameras` (single-camera code paths)
+    std::vector<CameraConfig> cameras;   // One pipeline per entry, all sharing one Detector
     ModelConfig model;
+    TrackerConfig tracker;
+    DetectionConfig detection;
+    NmsConfig nms;
+    MotionConfig motion;
+    TilingConfig tiling;
+    PipelineConfig pipeline;
+    BatchConfig batching;
+    OutputConfig output;
+    ShmConfig shm;
+    EventsConfig events;
+    LoggingConfig logging;
+    MetricsConfig metrics;
     DebugConfig debug;
+    ReloadConfig reload;
     
     // Custom Zones
     std::vector<ZoneConfig> zones;
@@ -76,12 +288,40 @@ struct AppConfig {
     // Vector of Active Search Zones
     std::vector<std::string> active_search_zones;
 
+    // Counting Lines
+    std::vector<LineConfig> lines;
+
+    // zones + lines + active_search_zones + trigger classes compiled for O(1) lookups (see zone_index.hpp).
+    // Built by load() and forStream(); call buildZoneIndex() again after editing the zones.
+    std::shared_ptr<const ZoneIndex> zone_index;
+
     /**
      * @brief Factory method to parse the YAML configuration.
      * @param filepath Path to the .yaml file.
      * @return A fully populated AppConfig object.
      */    
     static AppConfig load(const std::string& filepath);
+
+    /**
+     * @brief Same, but reports failure instead of falling back to defaults (hot reload).
+     * @return false if the file cannot be opened or is not valid YAML; `config` is then unspecified.
+     */
+    static bool load(const std::string& filepath, AppConfig& config);
+
+    // Range checks on the values a running system relies on; logs each problem. false = reject.
+    bool validate() const;
+
+    /**
+     * @brief Configuration seen by one camera's pipeline: `camera` is cameras[index] and its
+     * zones / active_search_zones / lines replace the global ones when it defines any.
+     */
+    AppConfig forStream(size_t index) const;
+
+    // (Re)compiles zone_index, resolving trigger classes against the `class_names` file
+    void buildZoneIndex();
+
+    // No `cameras:` list means one stream from `camera`; unnamed cameras become cam0, cam1, ...
+    void normalizeCameras();
     
     std::string toString() const;
     std::string toJSON() const;
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "config.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Current configuration of one stream as an immutable snapshot (RCU style).
+ *
+ * A reload publishes a complete new AppConfig; readers keep the shared_ptr they took for as long
+ * as they use it, so a frame is always processed against one consistent config and the old
+ * snapshot is freed by whichever reader drops it last. Hot loops call refresh() once per frame:
+ * one atomic load of the version counter, and the pointer itself is only re-read after a publish.
+ */
+class ConfigStore {
+public:
+    explicit ConfigStore(AppConfig config)
+        : current_(std::make_shared<const AppConfig>(std::move(config))) {}
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    std::shared_ptr<const AppConfig> snapshot() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    void publish(std::shared_ptr<const AppConfig> config) {
+        std::atomic_store_explicit(&current_, std::move(config), std::memory_order_release);
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Replaces `config` with the current snapshot if one was published since `seen`.
+     * @return true if `config` changed.
+     */
+    bool refresh(std::shared_ptr<const AppConfig>& config, uint64_t& seen) const {
+        const uint64_t v = version();
+        if (config && v == seen) return false;
+        config = snapshot();
+        seen = v;
+        return true;
+    }
+
+private:
+    std::shared_ptr<const AppConfig> current_;
+    std::atomic<uint64_t> version_{0};
+};
+
+} // namespace CCM
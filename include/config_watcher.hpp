@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Which parts of the configuration differ between two loads, by what applying them costs.
+ */
+struct ConfigChanges {
+    bool any = false;                    // Anything at all differs
+    bool model = false;                  // Model file, class list, backend or input size: Detector::reload()
+    std::vector<std::string> restart;    // Sections only read at startup (camera, queues, sinks, ...)
+};
+
+ConfigChanges diffConfig(const AppConfig& before, const AppConfig& after);
+
+// Copies the startup-only sections of `running` into `next`, so a published snapshot always
+// describes what is actually running. Per-camera zones and lines stay as in `next`.
+void keepStartupSettings(const AppConfig& running, AppConfig& next);
+
+/**
+ * @brief Watches the config file and hands every new version that loads and validates to a callback.
+ *
+ * On Linux this is inotify on the file's directory (editors save by writing a temp file and
+ * renaming it over the original, which would orphan a watch on the file itself); elsewhere the
+ * modification time is polled. Writes are coalesced: the file is re-read once it has been quiet
+ * for `reload.debounce_ms`. A file that fails to parse or validate is logged and ignored; the
+ * running configuration stays in effect.
+ *
+ * The watcher and the callback run on a background thread.
+ */
+class ConfigWatcher {
+public:
+    using Callback = std::function<void(AppConfig&& config)>;
+
+    ConfigWatcher(const std::string& path, int debounce_ms, Callback on_change);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // false if the file cannot be watched (hot reload is then off; everything else keeps running)
+    bool start();
+    void stop();
+
+private:
+    void watchLoop();
+    void reload();
+
+    std::string path_;
+    std::string dir_;
+    std::string file_;
+    int debounce_ms_;
+    Callback on_change_;
+
+    int inotify_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace CCM
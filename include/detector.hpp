@@ -1,9 +1,16 @@
 #pragma once
 #include <opencv2/dnn.hpp>
 #include <opencv2/opencv.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include "config.hpp"
+#include "inference_backend.hpp"
+#include "nms.hpp"
+#include "preprocessor.hpp"
+#include "yolo_decoder.hpp"
 
 namespace CCM {
 
@@ -16,14 +23,124 @@ struct Detection {
 
 class Detector {
 public:
-    Detector(const std::string& model_path, const std::string& classes_path);
-    
+    /**
+     * @brief Loads the class list and the model on the backend chosen by `config.model.backend`
+     * (see selectBackend()).
+     */
+    Detector(const std::string& model_path, const std::string& classes_path, const AppConfig& config);
+
+    // false if no inference backend could load the model
+    bool isReady() const { return backend_ != nullptr; }
+
+    /**
+     * @brief Loads another model / class list (config reload) on the calling thread, while the
+     * current model keeps serving. The next detect() / detectBatch() swaps it in between frames.
+     * @return false if no backend could load it; the current model then stays in use.
+     */
+    bool reload(const std::string& model_path, const std::string& classes_path, const AppConfig& config);
+
+    // Backend actually in use (after "auto" selection / fallback)
+    std::string backendName() const { return backend_ ? backend_->name() : std::string("none"); }
+
     // Main inference method
     std::vector<Detection> detect(const cv::Mat& frame, const AppConfig& config);
 
+    /**
+     * @brief Same, writing into the caller's list. Keep one list per stream and pass it every
+     * frame: its storage (and the class-name strings) is reused instead of reallocated.
+     */
+    void detect(const cv::Mat& frame, const AppConfig& config, std::vector<Detection>& results);
+
+    /**
+     * @brief Runs one forward pass over an N x 3 x H x W tensor built from all frames.
+     * Falls back to per-frame detect() if the model only accepts a batch of 1.
+     * @return One detection list per input frame, in the same order.
+     */
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat>& frames, const AppConfig& config);
+
+    /**
+     * @brief Same, with one config per frame (multi-camera: each stream filters by its own zones).
+     * Preprocessing parameters (input size, scale, channel order) are taken from configs[0].
+     */
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat>& frames,
+                                                    const std::vector<const AppConfig*>& configs);
+
+    /**
+     * @brief Same, writing into the caller's lists (resized to frames.size()). Passing the same
+     * `results` every batch reuses the inner lists' storage, as detect() does.
+     */
+    void detectBatch(const std::vector<cv::Mat>& frames, const std::vector<const AppConfig*>& configs,
+                     std::vector<std::vector<Detection>>& results);
+
 private:
-    cv::dnn::Net net_;
+    // Steps 3-6: flatten, decode, NMS and zone filtering for a single image's output
+    void postprocess(cv::Mat output, const LetterboxInfo& letterbox, const AppConfig& config,
+                     std::vector<Detection>& results);
+
+    // model.output_layout, or guessed from the [rows x cols] output and the class count ("auto")
+    YoloLayout outputLayout(int rows, int cols, const AppConfig& config) const;
+
+    // Flatten + decode one image's output into decoder_ (candidates >= threshold); false on an unusable shape
+    bool decodeOutput(cv::Mat output, const LetterboxInfo& letterbox, const AppConfig& config, float threshold);
+
+    // NMS (nms: section), class names and active-zone filtering of candidates in frame coordinates
+    void finalize(const std::vector<cv::Rect>& boxes, const std::vector<float>& confidences,
+                  const std::vector<int>& class_ids, const AppConfig& config, std::vector<Detection>& results);
+
+    /**
+     * @brief ROI mode (detection.roi_inference): input-sized crops covering the active search
+     * zones at native resolution. false = run on the full frame (mode off, no restriction, frame
+     * already fits the input, or more than roi_max_tiles crops needed).
+     */
+    bool planTiles(const cv::Size& frame_size, const AppConfig& config, std::vector<cv::Rect>& tiles) const;
+
+    // Runs the crops (batched when possible) and merges their boxes with one NMS over the frame
+    void detectTiles(const cv::Mat& frame, const std::vector<cv::Rect>& tiles, const AppConfig& config,
+                     std::vector<Detection>& results);
+
+    /**
+     * @brief Tiled mode (`tiling:`): "grid" slices the whole frame into tiles (plus an optional
+     * low-res full-frame pass), "adaptive" runs the full-frame pass first and tiles only around
+     * its coarse candidates. Boxes are merged with per-class NMS, optionally after box fusion.
+     */
+    void detectTiled(const cv::Mat& frame, const AppConfig& config, std::vector<Detection>& results);
+
+    // Preprocess + infer + decode crops of `frame` (one batch when possible), appended to tile_*
+    void inferCrops(const cv::Mat& frame, const std::vector<cv::Rect>& tiles, const AppConfig& config);
+
+    // Appends decoder_'s candidates >= min_confidence, shifted by a crop's offset, to the tile_* lists
+    void appendTile(const cv::Point& offset, float min_confidence);
+
+    // Installs a model staged by reload(); called on the inference thread
+    void applyReload();
+
+    std::unique_ptr<InferenceBackend> backend_;
     std::vector<std::string> classes_;
+    Preprocessor preprocessor_;
+    std::vector<LetterboxInfo> letterboxes_;
+    std::vector<const AppConfig*> batch_configs_;   // Single-config detectBatch()
+    std::vector<cv::Mat> outputs_;   // Network outputs, reused across frames
+    YoloDecoder decoder_;
+    const char* logged_layout_ = nullptr;   // Output layout last reported (changes with a model reload)
+    NmsEngine nms_;
+    std::vector<int> nms_keep_;
+    std::vector<float> nms_scores_;
+    bool batch_supported_ = true;
+
+    // ROI / tiled-mode scratch, reused across frames
+    std::vector<cv::Rect> tiles_;
+    std::vector<cv::Rect> tile_regions_;   // Tiled mode: areas to cover (whole frame, or merged coarse hits)
+    cv::Size logged_tile_size_;            // Enlarged grid tile size last reported
+    std::vector<cv::Mat> tile_crops_;
+    std::vector<cv::Rect> tile_boxes_;
+    std::vector<float> tile_confidences_;
+    std::vector<int> tile_class_ids_;
+
+    // Staged by reload(), picked up by the inference thread
+    std::mutex reload_mutex_;
+    std::unique_ptr<InferenceBackend> next_backend_;
+    std::vector<std::string> next_classes_;
+    std::atomic<bool> reload_pending_{false};
 };
 
 } // namespace CCM
\ No newline at end of file
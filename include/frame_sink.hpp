@@ -0,0 +1,78 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace CCM {
+
+/**
+ * @brief Consumer of rendered frames (MJPEG server, RTSP encoder, ...).
+ * encode() always runs on the sink's own EncoderThread, never on the pipeline.
+ */
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+
+    virtual const char* name() const = 0;
+
+    // Encode and publish one frame. Returning false disables the sink (fatal error).
+    virtual bool encode(const cv::Mat& frame) = 0;
+
+    // False while nobody consumes the output (e.g. no MJPEG client): frames are not even copied.
+    virtual bool wanted() const { return true; }
+
+    // Release encoder resources; called on the encoder thread after the last encode().
+    virtual void close() {}
+};
+
+/**
+ * @brief Runs a FrameSink on its own thread behind a single "latest frame" slot.
+ * submit() copies the frame into the slot and returns immediately; if the encoder is still busy
+ * with the previous frame, the older pending frame is overwritten (counted in skipped()).
+ * A slow encoder or client therefore lowers the output frame rate, never the pipeline's.
+ */
+class EncoderThread {
+public:
+    /**
+     * @param sink    Sink to drive; must outlive this object.
+     * @param max_fps Upper bound on encoded frames per second (0 = no cap).
+     */
+    EncoderThread(FrameSink& sink, int max_fps);
+    ~EncoderThread();
+
+    EncoderThread(const EncoderThread&) = delete;
+    EncoderThread& operator=(const EncoderThread&) = delete;
+
+    void start();
+    void stop();
+
+    void submit(const cv::Mat& frame);
+
+    uint64_t encoded() const { return encoded_.load(std::memory_order_relaxed); }
+    uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+
+private:
+    void loop();
+
+    FrameSink& sink_;
+    std::chrono::steady_clock::duration min_interval_;
+    std::chrono::steady_clock::time_point last_submit_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    cv::Mat pending_;        // Written by submit(), swapped out by the encoder (buffers are reused)
+    cv::Mat working_;
+    bool has_pending_ = false;
+    bool running_ = false;
+    bool failed_ = false;
+
+    std::atomic<uint64_t> encoded_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::thread thread_;
+};
+
+} // namespace CCM
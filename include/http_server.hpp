@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief One accepted client connection, passed to a route handler.
+ * Handlers may either send a complete response, or keep the connection open and stream
+ * (checking isOpen() between writes so they exit promptly on shutdown).
+ */
+class HttpConnection {
+public:
+    HttpConnection(int fd, std::string path, const std::atomic<bool>& server_running);
+
+    const std::string& path() const { return path_; }
+
+    // Writes the full buffer; returns false once the client has gone away (or the server stops
+    // while the client is not reading).
+    bool send(const void* data, size_t size);
+    bool send(const std::string& data) { return send(data.data(), data.size()); }
+
+    // Complete response with Content-Length; the connection is closed after the handler returns.
+    bool sendResponse(int status, const std::string& content_type, const std::string& body);
+
+    bool isOpen() const { return open_ && server_running_.load(std::memory_order_relaxed); }
+
+private:
+    int fd_;
+    std::string path_;
+    bool open_ = true;
+    const std::atomic<bool>& server_running_;
+};
+
+/**
+ * @brief Minimal embedded HTTP/1.1 server (GET only), one thread per connection.
+ * Intended for local endpoints: Prometheus metrics, MJPEG preview. Linux/POSIX only.
+ */
+class HttpServer {
+public:
+    using Handler = std::function<void(HttpConnection&)>;
+
+    HttpServer() = default;
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Register before start(). `path` is matched exactly (query string ignored).
+    void addRoute(const std::string& path, Handler handler);
+
+    bool start(const std::string& bind_address, int port);
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+private:
+    struct Client {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+        int fd;   // Closed by reapClients() after the join, so stop() can shut it down safely
+    };
+
+    void acceptLoop();
+    void handleClient(int fd);
+    void reapClients(bool all);
+
+    std::map<std::string, Handler> routes_;
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread accept_thread_;
+
+    std::mutex clients_mutex_;
+    std::vector<Client> clients_;
+};
+
+} // namespace CCM
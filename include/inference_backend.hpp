@@ -0,0 +1,67 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "config.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Runtime that executes the network: takes the preprocessed NCHW tensor, returns raw outputs.
+ * Detector owns one; decoding/NMS stay backend independent.
+ */
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    // Short identifier used in the config and logs (e.g. "opencv_cpu", "onnxruntime").
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief Loads the model and verifies the backend actually runs on this machine
+     * (one probe forward pass at `input_size`).
+     * @return false if the backend is unavailable or the model cannot run on it.
+     */
+    virtual bool load(const std::string& model_path, const cv::Size& input_size) = 0;
+
+    /**
+     * @brief One forward pass.
+     * @param input   N x 3 x H x W CV_32F tensor.
+     * @param outputs Raw output tensors. They may reference backend memory and stay valid
+     *                only until the next call.
+     * @return false on failure (e.g. the model has a static batch of 1 and N > 1).
+     */
+    virtual bool infer(const cv::Mat& input, std::vector<cv::Mat>& outputs) = 0;
+};
+
+/**
+ * @brief Names of the backends compiled into this binary (the candidates for "auto"):
+ * "opencv_cuda", "opencv_openvino", "onnxruntime", "opencv_vulkan", "opencv_opencl", "opencv_cpu".
+ */
+std::vector<std::string> compiledBackends();
+
+// Creates an unloaded backend by name, or nullptr if the name is unknown / not compiled in.
+std::unique_ptr<InferenceBackend> createBackend(const std::string& name, const ModelConfig& config);
+
+/**
+ * @brief Model file to load for `precision` ("fp32", "fp16", "int8").
+ * For fp16/int8, prefers the converted sibling written by scripts/quantize_model.py
+ * (models/yolov5s.onnx -> models/yolov5s.int8.onnx) and falls back to `model_path` itself,
+ * which is then assumed to already be the quantized model.
+ */
+std::string modelPathForPrecision(const std::string& model_path, const std::string& precision);
+
+/**
+ * @brief Creates and loads the backend selected by `config.backend`.
+ * Backends without kernels for `config.precision` are skipped (INT8: opencv_cpu and onnxruntime only).
+ * - "auto": loads every compiled backend, times `benchmark_runs` forward passes on each and keeps
+ *   the fastest.
+ * - a name: uses it, or falls back to opencv_cuda -> opencv_openvino -> onnxruntime -> opencv_cpu
+ *   if it is unavailable.
+ * @return nullptr if no backend could load the model.
+ */
+std::unique_ptr<InferenceBackend> selectBackend(const std::string& model_path, const ModelConfig& config,
+                                                const cv::Size& input_size);
+
+} // namespace CCM
@@ -0,0 +1,33 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+
+namespace CCM {
+
+/**
+ * @brief Constant-velocity Kalman filter over a bounding box (SORT-style).
+ * State: [cx, cy, w, h, vx, vy, vw, vh] in pixels and pixels/frame; measurement: [cx, cy, w, h].
+ * Noise scales with the box size, so small and large objects behave the same relative to their size.
+ * Fixed-size cv::Matx math: no heap allocation per predict/correct.
+ */
+class KalmanBoxFilter {
+public:
+    void init(const cv::Rect& box);
+
+    // Advances the state by one frame and returns the predicted box.
+    cv::Rect predict();
+
+    // Fuses a matched detection into the state.
+    void correct(const cv::Rect& box);
+
+    cv::Rect rect() const;
+    cv::Point2f velocity() const { return cv::Point2f(x_(4), x_(5)); }
+
+private:
+    typedef cv::Matx<float, 8, 1> State;
+    typedef cv::Matx<float, 8, 8> Covariance;
+
+    State x_;
+    Covariance P_;
+};
+
+} // namespace CCM
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "mpmc_ring.hpp"
+
+// Messages below this level are removed at compile time (the call site becomes dead code).
+// 0=trace, 1=debug, 2=info, 3=warn, 4=error. Production builds: -DCCM_LOG_COMPILE_LEVEL=2
+#ifndef CCM_LOG_COMPILE_LEVEL
+#define CCM_LOG_COMPILE_LEVEL 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CCM_PRINTF_FORMAT(fmt_idx, args_idx) __attribute__((format(printf, fmt_idx, args_idx)))
+#else
+#define CCM_PRINTF_FORMAT(fmt_idx, args_idx)
+#endif
+
+namespace CCM {
+
+enum class LogLevel : int {
+    Trace = 0,  // Per-candidate / per-box detail
+    Debug = 1,  // Per-frame summaries
+    Info = 2,   // Lifecycle events
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+/**
+ * @brief Asynchronous structured logger.
+ *
+ * Call sites format into a fixed-size record and push it onto a lock-free ring; a background
+ * thread does all terminal/journald I/O. A full ring drops the record (counted in dropped())
+ * rather than blocking the caller. When the writer thread is not running (tools, early start-up)
+ * records are written synchronously.
+ */
+class Logger {
+public:
+    static Logger& instance();
+
+    void start();
+    void stop();   // Drains pending records, then joins the writer thread
+
+    void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    // true: one JSON object per line ({"ts_us":..,"level":..,"tag":..,"msg":..}, ts_us in microseconds
+    // since the Unix epoch); false: plain text
+    void setJson(bool json) { json_.store(json, std::memory_order_relaxed); }
+
+    void log(LogLevel level, const char* tag, const char* fmt, ...) CCM_PRINTF_FORMAT(4, 5);
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    static LogLevel parseLevel(const std::string& name, LogLevel fallback = LogLevel::Info);
+    static const char* levelName(LogLevel level);
+
+private:
+    Logger();
+    ~Logger();
+
+    struct Record {
+        int64_t timestamp_us = 0;
+        LogLevel level = LogLevel::Info;
+        char tag[16] = {0};
+        char msg[232] = {0};
+    };
+
+    void writerLoop();
+    void write(const Record& rec);
+
+    MpmcRing<Record> ring_;
+    std::atomic<int> level_{static_cast<int>(LogLevel::Info)};
+    std::atomic<bool> json_{false};
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::thread writer_;
+};
+
+} // namespace CCM
+
+#define CCM_LOG(level, tag, ...)                                                        \
+    do {                                                                                \
+        if (static_cast<int>(level) >= CCM_LOG_COMPILE_LEVEL &&                         \
+            ::CCM::Logger::instance().enabled(level)) {                                 \
+            ::CCM::Logger::instance().log(level, tag, __VA_ARGS__);                     \
+        }                                                                               \
+    } while (0)
+
+#define CCM_LOG_TRACE(tag, ...) CCM_LOG(::CCM::LogLevel::Trace, tag, __VA_ARGS__)
+#define CCM_LOG_DEBUG(tag, ...) CCM_LOG(::CCM::LogLevel::Debug, tag, __VA_ARGS__)
+#define CCM_LOG_INFO(tag, ...)  CCM_LOG(::CCM::LogLevel::Info, tag, __VA_ARGS__)
+#define CCM_LOG_WARN(tag, ...)  CCM_LOG(::CCM::LogLevel::Warn, tag, __VA_ARGS__)
+#define CCM_LOG_ERROR(tag, ...) CCM_LOG(::CCM::LogLevel::Error, tag, __VA_ARGS__)
@@ -0,0 +1,68 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief cv::MatAllocator that recycles freed buffers instead of returning them to the heap.
+ *
+ * Installed as OpenCV's default allocator (install()), every cv::Mat buffer in the process goes
+ * through it: captured frames, resize / colour-conversion targets, input blobs, network outputs,
+ * crops. The sizes repeat from frame to frame, so after the first few frames each create() is
+ * served from a free list keyed by byte size, and large buffers stop bouncing through
+ * mmap/munmap (page faults, allocator lock contention) on every frame. The UMatData headers are
+ * recycled the same way.
+ *
+ * At most kMaxPerSize free buffers are kept per size, and `max_cached_bytes` in total. When a
+ * free would go over the total, whole size classes are released, least recently used first: sizes
+ * that stopped recurring (old crops, a previous resolution or model) go before the ones in use.
+ * Thread-safe (one mutex, held for a free-list push/pop). The pool is never destroyed, so Mats
+ * freed during static destruction still find it.
+ */
+class MatPool : public cv::MatAllocator {
+public:
+    static MatPool& instance();
+
+    static const size_t kMaxPerSize = 4;   // Free buffers kept per byte size
+
+    // Makes the pool OpenCV's default cv::Mat allocator (call once, before the pipelines start)
+    static void install(size_t max_cached_bytes);
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, cv::AccessFlag flags,
+                           cv::UMatUsageFlags usage) const CV_OVERRIDE;
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usage) const CV_OVERRIDE;
+    void deallocate(cv::UMatData* data) const CV_OVERRIDE;
+
+    // Buffers that had to come from the heap (pool misses), and buffers served from the pool
+    uint64_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+    uint64_t reuses() const { return reuses_.load(std::memory_order_relaxed); }
+    size_t cachedBytes() const;
+
+private:
+    MatPool() = default;
+
+    struct SizeClass {
+        std::vector<void*> buffers;
+        uint64_t last_used = 0;   // tick_ of the last allocate / deallocate of this size
+    };
+
+    // Releases least recently used size classes (other than `keep`) until `incoming` more bytes fit (lock held)
+    bool makeRoom(size_t incoming, size_t keep) const;
+
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<size_t, SizeClass> free_;   // Byte size -> free buffers
+    mutable std::vector<void*> free_headers_;              // Raw UMatData storage
+    mutable size_t cached_bytes_ = 0;
+    mutable uint64_t tick_ = 0;
+    size_t max_cached_bytes_ = 64u << 20;
+
+    mutable std::atomic<uint64_t> allocations_{0};
+    mutable std::atomic<uint64_t> reuses_{0};
+};
+
+} // namespace CCM
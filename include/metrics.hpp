@@ -0,0 +1,152 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace CCM {
+
+/**
+ * @brief Pipeline stages with their own latency histogram.
+ */
+enum class Stage : int {
+    Capture = 0,
+    Motion,     // Motion gate (downsampled frame difference)
+    Preprocess,
+    Inference,
+    Decode,
+    NMS,
+    ZoneFilter,
+    Track,
+    Render,
+    Output,
+    Publish,    // Copy into the shared-memory bus
+    Encode,     // Output sinks (JPEG / H.264), on their own threads
+    EndToEnd,   // Capture timestamp -> frame handed to the output sink
+    Count
+};
+
+const char* stageName(Stage stage);
+
+/**
+ * @brief HDR-style latency histogram (microseconds).
+ * Values below 32us get exact buckets; above that each power of two is split into 32
+ * sub-buckets, giving ~3% relative error from 1us up to ~1 hour with a fixed 1.2k buckets.
+ * record() is wait-free (relaxed atomics) so several threads can feed the same histogram.
+ */
+class LatencyHistogram {
+public:
+    struct Summary {
+        uint64_t count = 0;
+        double mean_us = 0.0;
+        double p50_us = 0.0;
+        double p95_us = 0.0;
+        double p99_us = 0.0;
+        double max_us = 0.0;
+    };
+
+    LatencyHistogram();
+
+    void record(uint64_t micros);
+    Summary summary() const;
+    void reset();
+
+private:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 42;
+    static constexpr int kBucketCount = kSubBuckets + (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    static int bucketIndex(uint64_t v);
+    static uint64_t bucketUpperBound(int index);
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Rolling frame rate: exponential moving average over roughly the last 30 frames.
+ * Not thread-safe; one instance per stream (Metrics guards its combined meter with a mutex).
+ */
+class FpsMeter {
+public:
+    // Called once per completed frame
+    void tick(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+    double fps() const { return fps_; }
+    void reset() { fps_ = 0.0; started_ = false; }
+
+private:
+    double fps_ = 0.0;
+    bool started_ = false;
+    std::chrono::steady_clock::time_point last_;
+};
+
+/**
+ * @brief Process-wide metrics: per-stage latency, rolling FPS and frame counters.
+ * Exposed as JSON (periodic dump) and Prometheus text (HTTP endpoint).
+ */
+class Metrics {
+public:
+    static Metrics& instance();
+
+    void record(Stage stage, uint64_t micros) { histograms_[static_cast<int>(stage)].record(micros); }
+    const LatencyHistogram& histogram(Stage stage) const { return histograms_[static_cast<int>(stage)]; }
+
+    // Called once per frame by each output stage; updates the rolling FPS estimate (all streams combined).
+    void frameCompleted();
+    void addCaptureError() { capture_errors_.fetch_add(1, std::memory_order_relaxed); }
+    // Queue drops are owned by the pipelines (one per camera); each adds its new drops here.
+    void addDroppedFrames(uint64_t n) { dropped_frames_.fetch_add(n, std::memory_order_relaxed); }
+
+    double fps() const { return fps_.load(std::memory_order_relaxed); }
+    uint64_t framesTotal() const { return frames_total_.load(std::memory_order_relaxed); }
+    uint64_t droppedFrames() const { return dropped_frames_.load(std::memory_order_relaxed); }
+    uint64_t captureErrors() const { return capture_errors_.load(std::memory_order_relaxed); }
+
+    std::string toJSON() const;
+    std::string toPrometheus() const;
+
+    void reset();
+
+private:
+    Metrics() = default;
+
+    std::array<LatencyHistogram, static_cast<int>(Stage::Count)> histograms_;
+
+    std::atomic<double> fps_{0.0};
+    std::atomic<uint64_t> frames_total_{0};
+    std::atomic<uint64_t> dropped_frames_{0};
+    std::atomic<uint64_t> capture_errors_{0};
+    std::mutex fps_mutex_;   // Several streams complete frames concurrently
+    FpsMeter fps_meter_;
+};
+
+/**
+ * @brief Records the lifetime of the scope into a stage histogram.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        Metrics::instance().record(
+            stage_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace CCM
+
+#define CCM_TIMER_CONCAT_INNER(a, b) a##b
+#define CCM_TIMER_CONCAT(a, b) CCM_TIMER_CONCAT_INNER(a, b)
+#define CCM_TIMED_SCOPE(stage) ::CCM::ScopedTimer CCM_TIMER_CONCAT(ccm_scoped_timer_, __LINE__)(stage)
@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "config.hpp"
+#include "http_server.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Publishes Metrics::instance() outside the process.
+ * - HTTP: GET /metrics (Prometheus text) and /metrics.json on metrics.bind:metrics.http_port.
+ * - File: JSON snapshot rewritten every json_interval_s (temp file + rename, so readers
+ *   never observe a partial write), plus a one-line summary in the log.
+ */
+class MetricsExporter {
+public:
+    explicit MetricsExporter(const MetricsConfig& config);
+    ~MetricsExporter();
+
+    void start();
+    void stop();
+
+private:
+    void reportLoop();
+    void writeJsonFile() const;
+
+    MetricsConfig config_;
+    HttpServer server_;
+
+    std::thread report_thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+} // namespace CCM
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "frame_sink.hpp"
+#include "http_server.hpp"
+
+namespace CCM {
+
+/**
+ * @brief JPEG-encodes one stream and serves it as multipart/x-mixed-replace (MJPEG) over HTTP.
+ * Each frame is encoded once and shared by all clients. A client always receives the newest
+ * frame, so a slow client skips frames instead of building up latency.
+ * Nothing is encoded while no client is connected.
+ */
+class MjpegSink : public FrameSink {
+public:
+    explicit MjpegSink(int jpeg_quality);
+
+    const char* name() const override { return "mjpeg"; }
+    bool encode(const cv::Mat& frame) override;
+    bool wanted() const override { return clients_.load(std::memory_order_relaxed) > 0; }
+
+    // HTTP handlers (run on the server's connection threads)
+    void serveStream(HttpConnection& conn);
+    void serveSnapshot(HttpConnection& conn);
+
+private:
+    using Jpeg = std::shared_ptr<const std::vector<uchar>>;
+
+    // Waits (bounded) for a frame newer than `seen`; returns nullptr on timeout
+    Jpeg waitForFrame(uint64_t& seen, int timeout_ms);
+
+    std::vector<int> params_;
+    std::vector<uchar> buffer_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    Jpeg latest_;
+    uint64_t sequence_ = 0;
+    std::atomic<int> clients_{0};
+};
+
+} // namespace CCM
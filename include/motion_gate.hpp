@@ -0,0 +1,42 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include "config.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Cheap "did anything change?" test run before the detector.
+ *
+ * Each frame is shrunk to `motion.width` pixels wide (area interpolation), converted to grey and
+ * compared with the frame at the last detection: absdiff, threshold, count. Those are plain
+ * per-pixel kernels that OpenCV vectorises, and at 160 px wide the whole test costs well under a
+ * millisecond, against tens of milliseconds for a forward pass.
+ *
+ * Comparing with the last *detected* frame rather than the previous one means slow changes add
+ * up until they cross the threshold instead of slipping under it one frame at a time.
+ *
+ * One gate per stream; not thread-safe.
+ */
+class MotionGate {
+public:
+    /**
+     * @brief Compares `frame` with the reference.
+     * @return true if more than `motion.min_changed` of the pixels differ by more than
+     *         `motion.pixel_threshold` grey levels (or there is no usable reference yet).
+     */
+    bool changed(const cv::Mat& frame, const MotionConfig& motion);
+
+    // The frame last passed to changed() becomes the reference (call when the detector runs on it)
+    void markDetected();
+
+    // Fraction of changed pixels measured by the last changed() call
+    double changedFraction() const { return changed_fraction_; }
+
+private:
+    cv::Mat small_;       // Current frame, downsampled grey
+    cv::Mat reference_;   // Same, at the last detection
+    cv::Mat diff_;
+    double changed_fraction_ = 1.0;
+};
+
+} // namespace CCM
@@ -0,0 +1,67 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+namespace CCM {
+
+enum class NmsMethod {
+    Greedy,   // Classic hard suppression (same result as cv::dnn::NMSBoxes)
+    Soft,     // Gaussian Soft-NMS: overlapping boxes lose score instead of being dropped
+    Matrix    // Matrix NMS: every box decayed in one parallel pass over the IoU matrix
+};
+
+// "greedy", "soft" or "matrix"; anything else is greedy (AppConfig::validate() rejects it)
+NmsMethod parseNmsMethod(const std::string& name);
+
+struct NmsParams {
+    NmsMethod method = NmsMethod::Greedy;
+    float iou_threshold = 0.4f;     // Greedy: suppress above this overlap
+    float score_threshold = 0.25f;  // Candidates (and Soft/Matrix rescored boxes) below this are dropped
+    int top_k = 0;                  // Only the best k candidates enter suppression; 0 = all
+    int max_detections = 0;         // Results kept at most; 0 = all
+    bool per_class = true;          // Boxes of different classes never suppress each other
+    float sigma = 0.5f;             // Soft / Matrix: Gaussian decay width
+};
+
+/**
+ * @brief Non-maximum suppression for large candidate sets.
+ *
+ * Candidates above the score threshold are ranked (a partial sort when top_k cuts the list) and
+ * copied into structure-of-arrays corner/area buffers, so the IoU of one box against all later
+ * boxes is a straight vector loop (OpenCV universal intrinsics). Per-class suppression uses the
+ * class-offset trick: every class is shifted to its own region of the plane, where it cannot
+ * overlap another class, and one class-agnostic pass handles all of them.
+ *
+ * Buffers are members and reused across calls. One engine per Detector; not thread-safe.
+ */
+class NmsEngine {
+public:
+    /**
+     * @param keep        Indices into `boxes` of the surviving candidates, best first.
+     * @param keep_scores Their scores (decayed by Soft / Matrix NMS; unchanged for Greedy).
+     */
+    void run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores, const std::vector<int>& class_ids,
+             const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores);
+
+private:
+    // Ranks and loads the candidates into the SoA buffers; returns their count
+    int load(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores, const std::vector<int>& class_ids,
+             const NmsParams& params);
+
+    // iou_[j] = IoU(box i, box j) for j in [begin, end)
+    void iouRow(int i, int begin, int end);
+
+    void greedy(int n, const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores);
+    void soft(int n, const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores);
+    void matrix(int n, const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores);
+
+    std::vector<int> order_;   // Input index of each loaded candidate, best first
+    std::vector<float> x1_, y1_, x2_, y2_, area_, score_;
+    std::vector<float> iou_;
+    std::vector<uint8_t> suppressed_;
+    std::vector<float> compensate_;   // Matrix: each box's largest IoU with a better box
+    std::vector<float> decay_;
+};
+
+} // namespace CCM
@@ -0,0 +1,32 @@
+#pragma once
+#include <memory>
+#include "inference_backend.hpp"
+
+namespace CCM {
+
+/**
+ * @brief ONNX Runtime CPU execution provider.
+ * Only functional when built with -DCCM_WITH_ONNXRUNTIME=ON; otherwise load() always fails.
+ * Outputs are wrapped without copying and stay valid until the next infer().
+ */
+class OnnxRuntimeBackend : public InferenceBackend {
+public:
+    /**
+     * @param intra_op_threads Threads used inside one operator (0 = runtime default).
+     * @param inter_op_threads Operators executed in parallel (0 = runtime default, sequential).
+     */
+    OnnxRuntimeBackend(int intra_op_threads, int inter_op_threads);
+    ~OnnxRuntimeBackend() override;
+
+    std::string name() const override { return "onnxruntime"; }
+    bool load(const std::string& model_path, const cv::Size& input_size) override;
+    bool infer(const cv::Mat& input, std::vector<cv::Mat>& outputs) override;
+
+private:
+    struct Impl;   // Keeps onnxruntime headers out of the rest of the build
+    std::unique_ptr<Impl> impl_;
+    int intra_op_threads_;
+    int inter_op_threads_;
+};
+
+} // namespace CCM
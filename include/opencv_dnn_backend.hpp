@@ -0,0 +1,33 @@
+#pragma once
+#include <opencv2/dnn.hpp>
+#include "inference_backend.hpp"
+
+namespace CCM {
+
+/**
+ * @brief OpenCV DNN module on an explicit backend/target pair.
+ * Availability is checked with cv::dnn::getAvailableTargets() and a probe forward pass,
+ * so a missing CUDA/OpenVINO/Vulkan build fails load() instead of silently running on the CPU.
+ */
+class OpenCvDnnBackend : public InferenceBackend {
+public:
+    /**
+     * @param target "cpu", "opencl", "openvino", "vulkan" or "cuda".
+     * @param half   Run in FP16 where the target has half-precision kernels (cuda, opencl).
+     */
+    explicit OpenCvDnnBackend(const std::string& target, bool half = false);
+
+    std::string name() const override { return "opencv_" + target_; }
+    bool load(const std::string& model_path, const cv::Size& input_size) override;
+    bool infer(const cv::Mat& input, std::vector<cv::Mat>& outputs) override;
+
+private:
+    std::string target_;
+    int dnn_backend_;
+    int dnn_target_;
+
+    cv::dnn::Net net_;
+    std::vector<std::string> output_names_;
+};
+
+} // namespace CCM
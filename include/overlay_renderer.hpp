@@ -1,10 +1,28 @@
 #pragma once
 #include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "config.hpp"
 #include "detector.hpp"
+#include "metrics.hpp"
 
 namespace CCM {
 
+class ZoneIndex;
+
+/**
+ * @brief Draws the annotated view of a frame.
+ *
+ * Zones, their labels and counting lines only change with the config, so they are rendered once
+ * per config snapshot and frame size into a static layer, stored as row runs of opaque pixels.
+ * Each frame copies those runs in (one memcpy per run) instead of redrawing shapes and measuring
+ * text. Detection labels and alert banners are blitted from cached glyph masks, so steady-state
+ * drawing does not build strings or rasterise text.
+ *
+ * One renderer per stream; not thread-safe.
+ */
 class OverlayRenderer {
 public:
     /**
@@ -15,9 +33,49 @@ public:
      */
     void draw(cv::Mat& frame, const std::vector<Detection>& detections, const AppConfig& config);
 
+    /**
+     * Draws the dashboard header: this stream's rolling FPS and dropped frames, plus inference p50/p95
+     * (shared by all streams through the batch scheduler).
+     * @param frame The video frame (modified in place).
+     * @param metrics Live metrics snapshot source.
+     * @param fps Rolling FPS of the stream that owns the frame.
+     * @param dropped Frames this stream's queues have dropped so far.
+     */
+    void drawHeader(cv::Mat& frame, const Metrics& metrics, double fps, uint64_t dropped);
+
 private:
-    // Helper to draw the dashboard header
-    void drawHeader(cv::Mat& frame, float fps);
+    // White-on-black text mask; `origin` is the putText() origin inside it
+    struct Glyph {
+        cv::Mat1b mask;
+        cv::Point origin;
+        int advance = 0;
+    };
+
+    // Horizontal run of static-layer pixels: frame row `y`, columns [x, x + length)
+    struct Run {
+        int y;
+        int x;
+        int length;
+        size_t offset;   // Into layer_pixels_, in bytes
+    };
+
+    void buildStaticLayer(const cv::Mat& frame, const AppConfig& config);
+    static void drawStatic(cv::Mat& canvas, const AppConfig& config, bool mask);
+
+    static Glyph renderGlyph(const std::string& text, double scale, int thickness);
+    const Glyph& cachedGlyph(std::unordered_map<std::string, Glyph>& cache, const std::string& text, double scale,
+                             int thickness);
+    static void blit(cv::Mat& frame, const Glyph& glyph, const cv::Point& origin, const cv::Scalar& color);
+
+    // Static layer; the index is held so its address cannot be reused by a later snapshot
+    std::shared_ptr<const ZoneIndex> layer_index_;
+    cv::Size layer_size_;
+    std::vector<Run> layer_runs_;
+    std::vector<uint8_t> layer_pixels_;
+
+    std::unordered_map<std::string, Glyph> label_glyphs_;    // Class names
+    std::vector<Glyph> percent_glyphs_;                       // " 0%" .. " 100%"
+    std::unordered_map<std::string, Glyph> banner_glyphs_;   // "ALERT: <zone>"
 };
 
-} // namespace CCM
\ No newline at end of file
+} // namespace CCM
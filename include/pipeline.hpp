@@ -0,0 +1,134 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "batch_scheduler.hpp"
+#include "bounded_queue.hpp"
+#include "camera_input.hpp"
+#include "config.hpp"
+#include "config_store.hpp"
+#include "detector.hpp"
+#include "motion_gate.hpp"
+#include "overlay_renderer.hpp"
+#include "shm_publisher.hpp"
+#include "tracker.hpp"
+#include "video_output.hpp"
+#include "zone_engine.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Unit of work flowing between pipeline stages.
+ * The frame is moved (not copied) from stage to stage.
+ */
+struct FramePacket {
+    uint64_t frame_id = 0;
+    cv::Mat frame;
+    std::vector<Detection> detections;
+    bool detected = false;   // False when the detector was skipped; tracks are predicted instead
+    std::chrono::steady_clock::time_point captured_at;
+};
+
+/**
+ * @brief Three-stage threaded runtime for one camera: Capture -> Inference -> Track/Render.
+ * Each stage runs concurrently so sustained throughput approaches the slowest stage
+ * instead of the sum of all stages. Several pipelines (one per `cameras:` entry) share one
+ * Detector through a BatchScheduler; each keeps its own tracker, zones and output window.
+ * With `shm.enabled` the output stage also publishes the raw frame and its tracks to shared memory.
+ * With an event queue set, it also runs a ZoneEngine over the tracks (zone/line events).
+ *
+ * Thresholds, zones, lines, tracker and scheduling settings follow config reloads: each stage
+ * picks up the stream's newest ConfigStore snapshot at the start of a frame. Queue sizes, the
+ * camera and the sinks are fixed when the pipeline is constructed.
+ */
+class Pipeline {
+public:
+    /**
+     * @param config    This stream's configuration (AppConfig::forStream snapshots): queue depth,
+     *                  backpressure, zones, thresholds. Must outlive the pipeline.
+     * @param camera    Opened capture device. Only the capture thread touches it.
+     * @param scheduler Shared inference scheduler, or nullptr in test mode.
+     * @param stream_id Id returned by BatchScheduler::addStream().
+     * @param test_mode Generate a simulated detection instead of running the network.
+     */
+    Pipeline(const ConfigStore& config, CameraInput& camera, BatchScheduler* scheduler, int stream_id,
+             bool test_mode);
+    ~Pipeline();
+
+    // Also send rendered frames to the MJPEG/H.264 sinks (call before start()).
+    void setVideoOutput(VideoOutput* output, int output_id);
+
+    // Emit zone enter/exit/dwell and line-crossing events to `events` (call before start()).
+    void setEventQueue(MpmcRing<ZoneEvent>* events);
+
+    /**
+     * @brief Starts the capture, inference and track/render threads. They run until `running`
+     * is cleared or stop() is called.
+     */
+    void start(std::atomic<bool>& running);
+
+    /**
+     * @brief Shows the newest rendered frame in this stream's window, if there is one
+     * (no-op when output.display is off).
+     * Must be called from the main thread (HighGUI); the caller pumps cv::waitKey().
+     * @return false once the stream has ended.
+     */
+    bool display();
+
+    void stop();
+
+    const std::string& name() const { return config_.camera.name; }
+
+private:
+    void captureLoop(std::atomic<bool>& running);
+    void inferenceLoop();
+    void outputLoop(std::atomic<bool>& running);
+
+    // Detection scheduler (inference thread): every Nth frame, or every frame when adaptive demands it,
+    // unless the motion gate finds the frame unchanged since the last detection
+    bool shouldDetect(const AppConfig& config, const cv::Mat& frame);
+
+    const ConfigStore& store_;
+    std::shared_ptr<const AppConfig> startup_;
+    const AppConfig& config_;   // Snapshot at construction: settings that are not reloaded
+    CameraInput& camera_;
+    BatchScheduler* scheduler_;
+    int stream_id_;
+    bool test_mode_;
+    std::string window_name_;
+    VideoOutput* output_ = nullptr;
+    int output_id_ = -1;
+    bool annotate_ = true;   // Some consumer (window or video sink) needs the rendered overlay
+
+    Tracker tracker_;
+    MotionGate motion_gate_;
+    OverlayRenderer renderer_;
+    std::unique_ptr<ShmPublisher> shm_;   // Set when shm.enabled
+    std::unique_ptr<ZoneEngine> zone_engine_;   // Set by setEventQueue()
+
+    BoundedQueue<FramePacket> capture_queue_;
+    BoundedQueue<FramePacket> result_queue_;
+    BoundedQueue<FramePacket> display_queue_;   // Newest rendered frame for the main thread
+    BoundedQueue<std::vector<Detection>> spare_detections_;   // Consumed lists, output -> inference stage
+
+    std::thread capture_thread_;
+    std::thread inference_thread_;
+    std::thread output_thread_;
+    std::atomic<bool> finished_{false};
+
+    // Published by the output stage for the adaptive scheduler
+    std::atomic<int> active_tracks_{0};
+    std::atomic<float> max_track_speed_{0.0f};
+    int frames_since_detection_ = 0;
+    uint64_t motion_skipped_ = 0;   // Frames the motion gate kept from the detector
+    uint64_t frames_seen_ = 0;
+    size_t reported_drops_ = 0;
+    FpsMeter stream_fps_;   // Output stage only
+};
+
+} // namespace CCM
@@ -0,0 +1,63 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief Geometry of one frame -> network input mapping.
+ * Network coordinates map back to the frame as (x - pad_x) / scale_x, (y - pad_y) / scale_y.
+ */
+struct LetterboxInfo {
+    cv::Size frame_size;   // Original frame
+    cv::Size input_size;   // Network input
+    float scale_x = 1.0f;  // Network pixels per frame pixel (equal on both axes when letterboxed)
+    float scale_y = 1.0f;
+    int pad_x = 0;         // Left padding, network pixels
+    int pad_y = 0;         // Top padding, network pixels
+
+    // Aspect-preserving fit, centred, padded (YOLOv5 letterbox)
+    static LetterboxInfo fit(const cv::Size& frame_size, const cv::Size& input_size);
+    // Plain resize to the input size (what blobFromImage does)
+    static LetterboxInfo stretch(const cv::Size& frame_size, const cv::Size& input_size);
+};
+
+/**
+ * @brief Builds the network input tensor (N x 3 x H x W, CV_32F) from BGR frames.
+ *
+ * Owns a persistent tensor and resize scratch, so steady-state frames do not allocate.
+ * After the resize (skipped when the frame already has the target size), a single pass per
+ * output row writes padding, swaps B/R, applies the pixel scale and repacks HWC -> CHW,
+ * using universal intrinsics when available. Rows are split across threads with cv::parallel_for_.
+ */
+class Preprocessor {
+public:
+    /**
+     * @param frame      8-bit BGR (grey and BGRA are converted first).
+     * @param input_size Network input size.
+     * @param scale      Pixel scale (e.g. 1/255).
+     * @param swap_rb    Produce RGB planes.
+     * @param letterbox  Preserve aspect ratio with padding (otherwise stretch).
+     * @param info       Output: mapping to convert boxes back to frame coordinates.
+     * @return 1 x 3 x H x W tensor, valid until the next call.
+     */
+    const cv::Mat& run(const cv::Mat& frame, const cv::Size& input_size, float scale, bool swap_rb,
+                       bool letterbox, LetterboxInfo& info);
+
+    /**
+     * @brief Batched variant: one N x 3 x H x W tensor, one LetterboxInfo per frame.
+     */
+    const cv::Mat& runBatch(const std::vector<cv::Mat>& frames, const cv::Size& input_size, float scale,
+                            bool swap_rb, bool letterbox, std::vector<LetterboxInfo>& infos);
+
+private:
+    void ensureTensor(int batch, const cv::Size& input_size);
+    void packImage(const cv::Mat& frame, int batch_index, float scale, bool swap_rb, bool letterbox,
+                   LetterboxInfo& info);
+
+    cv::Mat tensor_;
+    cv::Mat converted_;  // Non-BGR input converted to BGR
+    cv::Mat resized_;    // Resized image before packing
+};
+
+} // namespace CCM
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include "frame_sink.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Software H.264 (libx264) stream published by an ffmpeg child process.
+ * Raw BGR frames are piped to ffmpeg, which encodes with the zero-latency preset and pushes to
+ * `url`: rtsp:// (to an RTSP server such as mediamtx), udp:// / srt:// (MPEG-TS) or a file path.
+ * ffmpeg is started on the first frame, once the frame size is known. Linux/POSIX only.
+ */
+class RtspSink : public FrameSink {
+public:
+    /**
+     * @param url          Destination (see above).
+     * @param fps          Nominal frame rate; sets the GOP length (one keyframe every 2 s).
+     * @param bitrate_kbps Target bitrate.
+     * @param ffmpeg       ffmpeg executable (looked up in PATH).
+     */
+    RtspSink(const std::string& url, int fps, int bitrate_kbps, const std::string& ffmpeg);
+    ~RtspSink() override;
+
+    const char* name() const override { return "rtsp"; }
+    bool encode(const cv::Mat& frame) override;
+    void close() override;
+
+private:
+    bool launch(const cv::Size& size);
+
+    std::string url_;
+    int fps_;
+    int bitrate_kbps_;
+    std::string ffmpeg_;
+
+    cv::Size size_;
+    int pipe_fd_ = -1;
+    int pid_ = -1;
+};
+
+} // namespace CCM
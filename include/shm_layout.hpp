@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace CCM {
+
+/**
+ * @brief Binary layout of the shared-memory frame bus (see ShmPublisher / ShmReader and
+ * scripts/shm_reader.py, which mirrors these structs with the `struct` module).
+ *
+ * One POSIX shared-memory segment per camera:
+ *
+ *   ShmHeader | slot 0 | slot 1 | ... | slot N-1
+ *   slot = ShmSlotHeader | ShmDetection[max_detections] | pixels[max_frame_bytes]
+ *
+ * A single publisher fills the slots round-robin; any number of readers map the segment
+ * read-only. Every slot is a seqlock:
+ *
+ *   publisher: sequence = odd -> write metadata, detections, pixels -> sequence = even
+ *              -> write_index + 1
+ *   reader:    s1 = sequence (retry if odd) -> read/copy -> s2 = sequence;
+ *              the data is consistent only if s1 == s2
+ *
+ * Readers never block the publisher; a reader that is too slow just sees a torn slot and
+ * retries with the newest one. With N slots a zero-copy reader has N-1 frame periods to finish.
+ *
+ * All fields are little-endian and naturally aligned. Bump kShmVersion when changing them.
+ */
+constexpr char kShmMagic[8] = {'C', 'C', 'M', 'S', 'H', 'M', '\0', '\0'};
+constexpr uint32_t kShmVersion = 1;
+
+enum ShmFlags : uint32_t {
+    kShmDetected = 1u << 0,   // The detector ran on this frame (otherwise boxes are track predictions)
+    kShmNoPixels = 1u << 1,   // Frame was larger than the slot; only the detections are valid
+};
+
+struct alignas(64) ShmHeader {
+    char magic[8];                        // kShmMagic, written last by the publisher
+    uint32_t version;                     // kShmVersion
+    uint32_t header_size;                 // sizeof(ShmHeader): offset of slot 0
+    uint32_t slot_count;
+    uint32_t slot_size;                   // Bytes per slot (multiple of 64)
+    uint32_t max_detections;
+    uint32_t max_frame_bytes;
+    uint32_t detections_offset;           // From the start of a slot
+    uint32_t pixels_offset;               // From the start of a slot
+    int32_t writer_pid;
+    uint32_t reserved;
+    std::atomic<uint64_t> write_index;    // Frames published; the newest is slot (write_index - 1) % slot_count
+    std::atomic<uint32_t> writer_alive;   // Cleared when the publisher shuts down cleanly
+    uint32_t reserved2;
+    char stream_name[64];                 // Camera name, NUL terminated
+};
+
+struct alignas(64) ShmSlotHeader {
+    std::atomic<uint64_t> sequence;       // Seqlock counter, odd while the slot is being written
+    uint64_t frame_id;
+    int64_t timestamp_ns;                 // Capture time, CLOCK_MONOTONIC (Python: time.monotonic_ns())
+    uint32_t width;
+    uint32_t height;
+    uint32_t step;                        // Bytes per pixel row (rows are packed: width * channels)
+    int32_t type;                         // cv::Mat type, CV_8UC3 (16) = BGR
+    uint32_t detection_count;
+    uint32_t flags;                       // ShmFlags
+};
+
+/**
+ * @brief Compact per-object record: the pipeline's confirmed tracks for the frame.
+ */
+struct ShmDetection {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    float confidence;
+    int32_t class_id;
+    int32_t track_id;                     // Tracker id, stable across frames
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ShmHeader) == 128, "ShmHeader layout changed; update kShmVersion and shm_reader.py");
+static_assert(offsetof(ShmHeader, write_index) == 48, "ShmHeader layout changed");
+static_assert(sizeof(ShmSlotHeader) == 64, "ShmSlotHeader layout changed");
+static_assert(sizeof(ShmDetection) == 32, "ShmDetection layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The seqlock needs lock-free 64-bit atomics");
+
+} // namespace CCM
@@ -0,0 +1,61 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "config.hpp"
+#include "shm_layout.hpp"
+#include "tracker.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Publishes raw frames and their tracked detections to a POSIX shared-memory ring
+ * (layout and seqlock protocol in shm_layout.hpp) for out-of-process consumers.
+ *
+ * The segment is created on the first frame, once the frame size is known, and removed by
+ * close(). publish() is one memcpy of the frame plus the detection records and never waits for
+ * readers, so any number of them can attach without slowing the pipeline. Linux/POSIX only.
+ */
+class ShmPublisher {
+public:
+    /**
+     * @param config      The `shm:` section.
+     * @param stream_name Camera name; replaces `{name}` in config.name and is stored in the header.
+     */
+    ShmPublisher(const ShmConfig& config, const std::string& stream_name);
+    ~ShmPublisher();
+
+    ShmPublisher(const ShmPublisher&) = delete;
+    ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+    /**
+     * @brief Writes one frame into the next slot. Only tracks confirmed on this frame
+     * (lost_frames == 0) are published. Must always be called from the same thread.
+     * @return false if the segment could not be created (logged once; later calls are no-ops).
+     */
+    bool publish(uint64_t frame_id, std::chrono::steady_clock::time_point captured_at, const cv::Mat& frame,
+                 const std::vector<TrackedObject>& tracks, bool detected);
+
+    // Marks the segment as closed for readers and unlinks it (existing mappings stay valid)
+    void close();
+
+    const std::string& segmentName() const { return segment_name_; }
+
+private:
+    bool create(const cv::Mat& frame);
+
+    ShmConfig config_;
+    std::string stream_name_;
+    std::string segment_name_;
+
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    ShmHeader* header_ = nullptr;
+    uint64_t write_index_ = 0;
+    bool failed_ = false;
+    bool warned_oversize_ = false;
+};
+
+} // namespace CCM
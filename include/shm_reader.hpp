@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "shm_layout.hpp"
+
+namespace CCM {
+
+/**
+ * @brief One frame read from the bus. In a zero-copy view `pixels` / `detections` point into the
+ * shared segment and stay meaningful only while ShmReader::validate() returns true; after
+ * readLatest() they point into the caller's buffers.
+ */
+struct ShmFrame {
+    uint64_t index = 0;              // Publish counter (1 = first frame); gaps mean skipped frames
+    uint64_t frame_id = 0;
+    int64_t timestamp_ns = 0;        // Capture time, CLOCK_MONOTONIC
+    int width = 0;
+    int height = 0;
+    int step = 0;
+    int type = 0;                    // cv::Mat type, e.g. CV_8UC3: cv::Mat(height, width, type, pixels, step)
+    uint32_t flags = 0;              // ShmFlags
+    const uint8_t* pixels = nullptr; // nullptr when kShmNoPixels is set
+    const ShmDetection* detections = nullptr;
+    uint32_t detection_count = 0;
+
+    uint64_t sequence = 0;           // Seqlock value the view was taken at
+    uint32_t slot = 0;
+};
+
+/**
+ * @brief Read-only client of a ShmPublisher segment (see shm_layout.hpp). Uses only the standard
+ * library and POSIX (no OpenCV), so other processes can link it on its own (ccm_shm_reader).
+ * Readers never block the publisher; an overwritten frame is detected and skipped.
+ * Linux/POSIX only.
+ */
+class ShmReader {
+public:
+    explicit ShmReader(const std::string& segment_name);
+    ~ShmReader();
+
+    ShmReader(const ShmReader&) = delete;
+    ShmReader& operator=(const ShmReader&) = delete;
+
+    /**
+     * @brief Maps the segment. Fails (see error()) until the publisher has produced its first
+     * frame, so callers usually retry.
+     */
+    bool open();
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    // Frames published so far (0 before the first one)
+    uint64_t published() const;
+
+    // False once the publisher shut down or its process is gone; reopen to follow a restart
+    bool writerAlive() const;
+
+    /**
+     * @brief Zero-copy view of the newest frame newer than `after_index`.
+     * Check validate() after using the data: if it returns false the slot was overwritten meanwhile.
+     * @return false if there is no such frame yet.
+     */
+    bool latest(ShmFrame& view, uint64_t after_index = 0) const;
+    bool validate(const ShmFrame& view) const;
+
+    /**
+     * @brief Consistent copy of the newest frame newer than `after_index` into `pixels` /
+     * `detections` (resized as needed); `frame` points into them afterwards.
+     */
+    bool readLatest(ShmFrame& frame, std::vector<uint8_t>& pixels, std::vector<ShmDetection>& detections,
+                    uint64_t after_index = 0) const;
+
+    /**
+     * @brief Polls until a frame newer than `after_index` is published.
+     * @return false on timeout or if the writer went away.
+     */
+    bool waitFor(uint64_t after_index, int timeout_ms) const;
+
+    const ShmHeader* header() const { return header_; }
+    const std::string& error() const { return error_; }
+
+private:
+    std::string name_;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    const ShmHeader* header_ = nullptr;
+    std::string error_;
+};
+
+} // namespace CCM
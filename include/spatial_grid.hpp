@@ -0,0 +1,44 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief Uniform-grid index over a set of boxes, rebuilt every frame.
+ * Each box is registered in every cell it covers (CSR layout, no per-cell allocations),
+ * so a query returns every box that can overlap or lie near the query rectangle while
+ * skipping the rest of the scene.
+ */
+class SpatialGrid {
+public:
+    /**
+     * @param boxes     Boxes to index (indices into this vector are returned by query()).
+     * @param cell_size Cell edge in pixels. Roughly the typical object size works well.
+     */
+    void build(const std::vector<cv::Rect>& boxes, int cell_size);
+
+    /**
+     * @brief Appends to `out` the indices of boxes sharing at least one cell with `area`.
+     * Each index is reported once per query.
+     */
+    void query(const cv::Rect& area, std::vector<int>& out);
+
+private:
+    bool cellRange(const cv::Rect& r, int& c0, int& r0, int& c1, int& r1) const;
+
+    int cell_size_ = 64;
+    cv::Point origin_;
+    int cols_ = 0;
+    int rows_ = 0;
+
+    std::vector<int> cell_start_;   // cols_ * rows_ + 1 offsets into entries_
+    std::vector<int> entries_;      // Box indices grouped by cell
+    std::vector<int> fill_;         // Build scratch
+
+    std::vector<uint32_t> stamp_;   // Per-box "last reported in query N" for de-duplication
+    uint32_t query_id_ = 0;
+};
+
+} // namespace CCM
@@ -0,0 +1,35 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace CCM {
+
+/**
+ * @brief Network-input-sized windows over part of a frame, for inference at native resolution.
+ *
+ * Windows are `window` pixels (clamped to the frame), step by `window - overlap`, and are shifted
+ * rather than shrunk where they would leave the frame, so every crop reaches the network unscaled.
+ * A region smaller than a window gets one window centred on it (extra context, same resolution).
+ *
+ * @return Distinct windows, row-major; empty if `region` does not intersect the frame.
+ */
+std::vector<cv::Rect> tileRegion(const cv::Rect& region, const cv::Size& window, int overlap,
+                                 const cv::Size& frame_size);
+
+/**
+ * @brief Union of overlapping (or touching) rectangles, repeated until no two results overlap.
+ */
+std::vector<cv::Rect> mergeRects(std::vector<cv::Rect> rects);
+
+/**
+ * @brief Weighted box fusion: same-class candidates overlapping by at least `iou` are replaced by
+ * their confidence-weighted mean box, scored with their mean confidence.
+ *
+ * Used to merge tiled detections, where one object seen by two overlapping tiles (or a tile and
+ * the full-frame pass) gives two slightly different boxes that are both right. The lists are
+ * rewritten in place, in descending confidence order.
+ */
+void fuseBoxes(std::vector<cv::Rect>& boxes, std::vector<float>& confidences, std::vector<int>& class_ids,
+               float iou);
+
+} // namespace CCM
@@ -1,6 +1,11 @@
 #pragma once
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include "assignment.hpp"
+#include "config.hpp"
+#include "detector.hpp"
+#include "kalman_filter.hpp"
+#include "spatial_grid.hpp"
 
 namespace CCM {
 
@@ -12,11 +17,25 @@ struct TrackedObject {
     cv::Rect rect;       // Current bounding box
     cv::Point center;    // Centroid for distance calculations
     int lost_frames;     // How many consecutive frames this object has been missing
+    KalmanBoxFilter filter; // Constant-velocity motion model; drives rect between detections
+
+    // Label of the last matched detection (only set by the Detection overload of update())
+    int class_id = -1;
+    std::string className;
+    float confidence = 0.0f;
 };
 
 /**
- * @brief A simple Euclidean distance tracker (IoU-based logic can be added later).
- * Matches new detections to existing tracks to maintain consistent IDs.
+ * @brief Multi-object tracker. Matches new detections to existing tracks to maintain consistent IDs.
+ *
+ * Two matching modes:
+ * - greedy:    each track takes its nearest free detection (original behaviour, order dependent).
+ * - hungarian: a sparse IoU/distance cost matrix over candidate pairs from a uniform spatial grid,
+ *              solved globally so an early track cannot steal a later track's better match.
+ * Tracks live in a flat vector and are removed by swap-and-pop.
+ *
+ * Every track carries a Kalman filter: matching uses the predicted box, and predict() advances
+ * all tracks on frames where the detector is skipped.
  */
 class Tracker {
 public:
@@ -26,6 +45,16 @@ public:
      */
     Tracker(int max_lost_frames = 5, float dist_threshold = 50.0f);
 
+    /**
+     * @brief Tracker configured from the `tracker:` section (mode, thresholds, grid size).
+     */
+    explicit Tracker(const TrackerConfig& config);
+
+    /**
+     * @brief Applies new `tracker:` settings (config reload). Existing tracks are kept.
+     */
+    void configure(const TrackerConfig& config);
+
     /**
      * @brief Main tracking loop.
      * @param detections List of fresh bounding boxes from the Detector.
@@ -33,13 +62,58 @@ public:
      */
     std::vector<TrackedObject> update(const std::vector<cv::Rect>& detections);
 
+    /**
+     * @brief Same as update(), but tracks also keep the class and confidence of their detection.
+     */
+    std::vector<TrackedObject> update(const std::vector<Detection>& detections);
+
+    /**
+     * @brief Advances every track one frame with its motion model only (no detections this frame).
+     * Does not count as a miss; lost_frames is unchanged.
+     * @return Active tracks with their predicted boxes.
+     */
+    std::vector<TrackedObject> predict();
+
+    /**
+     * @brief update() / predict() writing the active tracks into the caller's list. Reusing one
+     * list per stream keeps its storage (and the class-name strings) across frames.
+     */
+    void update(const std::vector<Detection>& detections, std::vector<TrackedObject>& tracks);
+    void predict(std::vector<TrackedObject>& tracks);
+
 private:
-    void register_object(const cv::Rect& rect);
+    void updateImpl(const std::vector<cv::Rect>& detections, const std::vector<Detection>* labels);
+    void predictTracks();
+    void matchGreedy(const std::vector<cv::Rect>& detections);
+    void matchHungarian(const std::vector<cv::Rect>& detections);
+    float pairCost(const TrackedObject& track, const cv::Rect& det) const;
+    void register_object(const cv::Rect& rect, const Detection* label);
 
     std::vector<TrackedObject> tracks_;
     int next_id_;
     int max_lost_frames_;
     float dist_threshold_;
+    bool use_hungarian_ = false;
+    float iou_threshold_ = 0.1f;
+    int grid_cell_ = 0;
+
+    // Per-frame scratch, reused to keep update() allocation-free in steady state
+    struct Candidate {
+        int row;     // Index into row_track_
+        int det;     // Detection index
+        float cost;
+    };
+    SpatialGrid grid_;
+    HungarianSolver solver_;
+    std::vector<int> matched_track_;   // Detection index -> track index (-1 = unmatched)
+    std::vector<cv::Rect> rects_;
+    std::vector<int> nearby_;
+    std::vector<Candidate> candidates_;
+    std::vector<int> row_track_;   // Cost-matrix row -> track index
+    std::vector<int> col_det_;     // Cost-matrix column -> detection index
+    std::vector<int> det_col_;     // Detection index -> column (-1 if no candidate pair)
+    std::vector<float> cost_;
+    std::vector<int> assignment_;
 };
 
-} // namespace CCM
\ No newline at end of file
+} // namespace CCM
@@ -0,0 +1,63 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "config.hpp"
+#include "frame_sink.hpp"
+#include "http_server.hpp"
+#include "mjpeg_sink.hpp"
+#include "rtsp_sink.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Encoded outputs of the annotated video, per camera stream:
+ * - MJPEG over HTTP on output.bind:output.mjpeg_port
+ *     /                       index page with every stream
+ *     /stream/<name>.mjpg     live stream          (/stream.mjpg = first camera)
+ *     /snapshot/<name>.jpg    single JPEG          (/snapshot.jpg = first camera)
+ *     /streams.json           stream names
+ * - H.264 via ffmpeg to output.rtsp_url ("{name}" is replaced with the camera name).
+ * Every sink encodes on its own EncoderThread; submit() only copies the frame.
+ */
+class VideoOutput {
+public:
+    explicit VideoOutput(const OutputConfig& config);
+    ~VideoOutput();
+
+    VideoOutput(const VideoOutput&) = delete;
+    VideoOutput& operator=(const VideoOutput&) = delete;
+
+    /**
+     * @brief Registers a stream before start().
+     * @param fps Nominal camera rate (H.264 GOP length).
+     * @return Id to pass to submit().
+     */
+    int addStream(const std::string& name, int fps);
+
+    void start();
+    void stop();
+
+    // True if any sink is configured (otherwise pipelines can skip submit()).
+    bool enabled() const { return !streams_.empty() && (config_.mjpeg_port > 0 || !config_.rtsp_url.empty()); }
+
+    // Called from each pipeline's output thread with the rendered frame. Never waits for encoding.
+    void submit(int stream_id, const cv::Mat& frame);
+
+private:
+    struct Stream {
+        std::string name;
+        std::unique_ptr<MjpegSink> mjpeg;
+        std::unique_ptr<RtspSink> rtsp;
+        std::vector<std::unique_ptr<EncoderThread>> encoders;
+    };
+
+    std::string indexPage() const;
+
+    OutputConfig config_;
+    HttpServer server_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+};
+
+} // namespace CCM
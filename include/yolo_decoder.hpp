@@ -0,0 +1,83 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "preprocessor.hpp"
+
+namespace CCM {
+
+/**
+ * @brief Arrangement of one image's YOLO output, seen as a 2-D matrix.
+ *
+ * - YOLOv5:  [anchors x channels], channel = [cx, cy, w, h, obj, cls...]  (e.g. 25200 x 85)
+ * - YOLOv8 / v11: [channels x anchors], channel = [cx, cy, w, h, cls...], no objectness (e.g. 84 x 8400)
+ */
+struct YoloLayout {
+    bool channel_major = false;   // Channels are rows (one contiguous row per channel)
+    bool objectness = true;       // Channel 4 is objectness; class scores start at 4 + objectness
+
+    /**
+     * @brief Guesses the layout of a [rows x cols] output: anchors are the longer axis, and
+     * channels minus `num_classes` tells whether there is an objectness channel (if it matches
+     * neither, row-major outputs are taken as YOLOv5 and channel-major ones as YOLOv8).
+     */
+    static YoloLayout detect(int rows, int cols, int num_classes);
+
+    const char* name() const;
+};
+
+/**
+ * @brief Decodes a YOLO output tensor (see YoloLayout) into pixel-space candidate boxes ready for NMS.
+ *
+ * Each layout has its own loop, instantiated from one template on (channel_major, objectness), so
+ * the layout tests are resolved at compile time. Row-major outputs gate on objectness and take the
+ * per-row class argmax; channel-major outputs are read in place (no transpose): every class row is
+ * contiguous across anchors, so the argmax runs a SIMD block of anchors at a time, one class row
+ * after another. Both use OpenCV universal intrinsics (SSE/AVX2/NEON depending on the build).
+ * All output and scratch buffers are members and are reused across frames, so steady-state
+ * decoding does not allocate.
+ */
+class YoloDecoder {
+public:
+    /**
+     * @param output          CV_32F matrix laid out as `layout` says.
+     * @param letterbox       Frame -> network mapping from the Preprocessor; boxes are mapped
+     *                        back to (and clamped to) the original frame.
+     * @param conf_threshold  Gate for objectness and for objectness * class score.
+     * @param max_classes     Number of class scores to consider (e.g. size of the label list).
+     * @param debug_threshold Trace-log candidates with objectness (or score) >= this value; negative disables.
+     * @param layout          YOLOv5 rows by default.
+     */
+    void decode(const cv::Mat& output,
+                const LetterboxInfo& letterbox,
+                float conf_threshold,
+                int max_classes,
+                float debug_threshold = -1.0f,
+                const YoloLayout& layout = YoloLayout());
+
+    // Results of the last decode() call (valid until the next call)
+    const std::vector<cv::Rect>& boxes() const { return boxes_; }
+    const std::vector<float>& confidences() const { return confidences_; }
+    const std::vector<int>& classIds() const { return class_ids_; }
+
+private:
+    template <bool ChannelMajor, bool Objectness>
+    void decodeLayout(const cv::Mat& output, const LetterboxInfo& letterbox, float conf_threshold, int max_classes,
+                      float debug_threshold);
+
+    // Maps one network-space box to the frame, clamps it and appends it; false if nothing is left
+    bool push(float cx, float cy, float w, float h, float conf, int class_id, const LetterboxInfo& letterbox,
+              bool debug);
+
+    std::vector<cv::Rect> boxes_;
+    std::vector<float> confidences_;
+    std::vector<int> class_ids_;
+
+    // Objectness column gathered contiguously so it can be scanned a SIMD block at a time
+    std::vector<float> objectness_;
+
+    // Channel-major: best class score and its index (as float, for SIMD selects) per anchor
+    std::vector<float> best_score_;
+    std::vector<float> best_class_;
+};
+
+} // namespace CCM
@@ -0,0 +1,106 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "config.hpp"
+#include "mpmc_ring.hpp"
+#include "tracker.hpp"
+#include "zone_index.hpp"
+
+namespace CCM {
+
+enum class ZoneEventType : uint8_t {
+    Enter,   // Track has been inside the zone for events.debounce_frames frames
+    Exit,    // ... outside again, or the track ended (lost = true)
+    Dwell,   // Inside for events.dwell_s seconds (once per visit)
+    Cross    // Track crossed a counting line
+};
+
+const char* zoneEventName(ZoneEventType type);
+
+struct ZoneEvent {
+    ZoneEventType type = ZoneEventType::Enter;
+    std::string camera;
+    std::string zone;          // Zone or line name
+    int track_id = -1;
+    int class_id = -1;
+    int direction = 0;         // Cross: +1 "in" (left -> right of a->b), -1 "out"
+    bool lost = false;         // Exit because the track disappeared
+    float dwell_s = 0.0f;      // Exit / Dwell: time spent inside
+    cv::Point position;        // Track centre
+    uint64_t frame_id = 0;
+    int64_t timestamp_ms = 0;  // Wall clock, ms since the Unix epoch
+
+    std::string toJSON() const;
+};
+
+/**
+ * @brief Turns tracker output into zone and counting-line events for one camera.
+ *
+ * Membership comes from the stream's ZoneIndex (raster lookup) and is debounced per
+ * TrackedObject::id, so a box jittering on a zone border does not flap enter/exit. Lines use the
+ * precomputed edge table: a crossing needs the track to move from one side (beyond
+ * events.line_margin) to the other through the segment itself.
+ *
+ * Events are pushed to a lock-free MpmcRing shared by all cameras; consumers drain it on
+ * their own thread. A full ring drops the event (counted in dropped()) instead of blocking.
+ * update() must always be called from the same thread (the pipeline's output stage). It takes
+ * the current config snapshot each time; a reloaded zone index closes the open visits.
+ */
+class ZoneEngine {
+public:
+    ZoneEngine(const std::string& camera, MpmcRing<ZoneEvent>& events);
+
+    /**
+     * @brief Evaluates all tracks of one frame. Tracks missing from `tracks` have ended: their
+     * open zone visits are closed with lost exits.
+     */
+    void update(const AppConfig& config, const std::vector<TrackedObject>& tracks, uint64_t frame_id,
+                std::chrono::steady_clock::time_point now);
+
+    struct LineCount {
+        std::string name;
+        uint64_t in = 0;
+        uint64_t out = 0;
+    };
+    // Crossings per line (both directions, regardless of the line's `direction` filter)
+    const std::vector<LineCount>& lineCounts() const { return line_counts_; }
+
+    size_t dropped() const { return dropped_; }
+
+private:
+    struct TrackState {
+        ZoneMask inside;                                         // Debounced membership
+        ZoneMask pending;                                        // Zones with a streak in progress
+        ZoneMask dwell_reported;
+        std::vector<uint8_t> streak;                             // Per zone: frames raw != debounced
+        std::vector<std::chrono::steady_clock::time_point> entered_at;
+        std::vector<int8_t> line_side;                           // Per line: -1 / +1, 0 = not seen yet
+        std::vector<cv::Point2f> line_anchor;                    // Last position on that side
+        uint64_t seen_frame = 0;
+        int class_id = -1;
+        cv::Point position;
+    };
+
+    ZoneEvent makeEvent(ZoneEventType type, const std::string& name, int track_id, const TrackState& state) const;
+    void emit(ZoneEvent&& event);
+    void closeVisits(int track_id, TrackState& state, std::chrono::steady_clock::time_point now);
+
+    std::string camera_;
+    MpmcRing<ZoneEvent>& events_;
+
+    std::shared_ptr<const ZoneIndex> index_;
+    std::unordered_map<int, TrackState> tracks_;
+    std::vector<LineCount> line_counts_;
+
+    // Stamped on every event of the current update()
+    uint64_t frame_id_ = 0;
+    int64_t wall_ms_ = 0;
+    size_t dropped_ = 0;
+};
+
+} // namespace CCM
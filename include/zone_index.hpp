@@ -0,0 +1,103 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "config.hpp"
+
+namespace CCM {
+
+constexpr size_t kMaxZones = 128;
+using ZoneMask = std::bitset<kMaxZones>;   // Bit i = zone i of ZoneIndex
+
+/**
+ * @brief Zones compiled once per config into a lookup structure, so per-detection zone tests
+ * cost one raster read instead of a loop over every zone with string compares.
+ *
+ * - The union of the zones' bounding boxes is divided into `cell_size` x `cell_size` cells.
+ *   Each cell stores a palette index for two masks: zones that cover the whole cell, and zones
+ *   whose border crosses it. Only the latter are tested exactly (rect / point-in-polygon), so
+ *   lookups are exact and O(1) away from zone borders.
+ * - Trigger classes are resolved to class ids: one mask per class of the zones it alerts in.
+ * - active_search_zones becomes a mask of zone bits.
+ * - Counting lines become an edge table (origin, direction, length, class filter) for the
+ *   side-of-line and segment-crossing tests used by ZoneEngine.
+ *
+ * Immutable after construction; shared read-only between threads through AppConfig::zone_index.
+ */
+class ZoneIndex {
+public:
+    struct Line {
+        std::string name;
+        cv::Point2f a;
+        cv::Point2f d;       // b - a
+        float length;
+        int class_id;        // -1 = every class
+        int direction;       // Crossings reported: 0 both, +1 "in" only, -1 "out" only
+    };
+
+    /**
+     * @param zones               Rect or polygon zones (at most kMaxZones; extras are ignored with a warning).
+     * @param lines               Counting lines.
+     * @param active_search_zones Names of zones detections are restricted to; empty = whole frame.
+     * @param class_names         Class list of the model, to resolve trigger_class.
+     * @param cell_size           Raster cell edge in pixels.
+     */
+    ZoneIndex(const std::vector<ZoneConfig>& zones, const std::vector<LineConfig>& lines,
+              const std::vector<std::string>& active_search_zones, const std::vector<std::string>& class_names,
+              int cell_size = 8);
+
+    size_t size() const { return zones_.size(); }
+    const ZoneConfig& zone(size_t i) const { return zones_[i]; }
+
+    // Zones containing `p`
+    ZoneMask zonesAt(const cv::Point& p) const;
+
+    // false when active_search_zones restricts detection and `p` is outside all of those zones
+    bool allowed(const cv::Point& p) const { return !restricted_ || (zonesAt(p) & active_).any(); }
+    bool restricted() const { return restricted_; }
+
+    // Bounding boxes of the active search zones, overlapping ones merged (ROI inference)
+    const std::vector<cv::Rect>& activeRegions() const { return active_regions_; }
+
+    // Zones in which an object of `class_id` at `p` raises an alert
+    ZoneMask alerts(const cv::Point& p, int class_id) const;
+
+    // Zones that report events for `class_id`: its trigger zones plus zones without a trigger_class
+    ZoneMask eventZones(int class_id) const;
+
+    size_t lineCount() const { return lines_.size(); }
+    const Line& line(size_t i) const { return lines_[i]; }
+
+    // Signed distance of `p` from line i in pixels: > 0 on the right ("in") side of a->b
+    float side(size_t i, const cv::Point2f& p) const;
+
+    // True if the segment p0 -> p1 intersects line i
+    bool crosses(size_t i, const cv::Point2f& p0, const cv::Point2f& p1) const;
+
+private:
+    struct Cell {
+        ZoneMask full;   // Zone covers the entire cell
+        ZoneMask edge;   // Zone border crosses the cell: test exactly
+    };
+
+    bool containsExact(size_t zone, const cv::Point& p) const;
+
+    std::vector<ZoneConfig> zones_;
+    cv::Rect bounds_;                  // Area covered by the raster
+    int cell_size_;
+    int cols_ = 0;
+    std::vector<uint32_t> cells_;      // Row-major palette index per cell
+    std::vector<Cell> palette_;        // Distinct cell contents; palette_[0] is empty
+    std::vector<std::vector<uint8_t>> edge_zones_;   // Per palette entry: zones to test exactly
+
+    std::vector<ZoneMask> triggers_;   // By class id
+    ZoneMask any_class_;               // Zones without a trigger_class
+    std::vector<Line> lines_;
+    ZoneMask active_;
+    std::vector<cv::Rect> active_regions_;
+    bool restricted_ = false;
+};
+
+} // namespace CCM
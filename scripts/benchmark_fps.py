@@ -1 +1,60 @@
-# Script to benchmark FPS and latency
+#!/usr/bin/env python3
+"""Benchmark FPS and per-stage latency by running the C++ ccm_bench harness.
+
+Thin wrapper around build/ccm_bench: forwards the options, prints a short
+summary table and propagates the exit code (2 = regression vs. baseline).
+
+Examples:
+    python3 scripts/benchmark_fps.py --input assets/street.mp4
+    python3 scripts/benchmark_fps.py --input assets/street.mp4 --output bench.json
+    python3 scripts/benchmark_fps.py --input assets/street.mp4 --baseline bench.json --tolerance 0.05
+"""
+import argparse
+import json
+import subprocess
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bench", default="build/ccm_bench", help="Path to the ccm_bench binary")
+    parser.add_argument("--input", required=True, help="Video file, image directory or img_%%04d.png pattern")
+    parser.add_argument("--config", default="configs/zones.yaml")
+    parser.add_argument("--iterations", type=int, default=3)
+    parser.add_argument("--warmup", type=int, default=10)
+    parser.add_argument("--max-frames", type=int, default=300)
+    parser.add_argument("--output", help="Save the JSON report (usable later as --baseline)")
+    parser.add_argument("--baseline", help="Previous report to compare against")
+    parser.add_argument("--tolerance", type=float, default=0.10)
+    parser.add_argument("--test", action="store_true", help="Simulated detections, no model required")
+    args = parser.parse_args()
+
+    cmd = [args.bench, "--input", args.input, "--config", args.config,
+           "--iterations", str(args.iterations), "--warmup", str(args.warmup),
+           "--max-frames", str(args.max_frames), "--tolerance", str(args.tolerance)]
+    if args.output:
+        cmd += ["--output", args.output]
+    if args.baseline:
+        cmd += ["--baseline", args.baseline]
+    if args.test:
+        cmd.append("--test")
+
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, universal_newlines=True)
+    try:
+        report = json.loads(proc.stdout)
+    except ValueError:
+        sys.stdout.write(proc.stdout)
+        return proc.returncode or 1
+
+    print("Throughput: %.1f FPS over %d frames x %d iterations (peak RSS %.1f MB)" % (
+        report["throughput_fps"], report["frames"], report["iterations"], report["peak_rss_kb"] / 1024.0))
+    print("%-12s %8s %8s %8s %8s" % ("stage", "p50 ms", "p95 ms", "p99 ms", "max ms"))
+    for name, s in report["stages"].items():
+        if s["count"] > 0:
+            print("%-12s %8.2f %8.2f %8.2f %8.2f" % (name, s["p50_ms"], s["p95_ms"], s["p99_ms"], s["max_ms"]))
+
+    return proc.returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Create an INT8 (QDQ) or FP16 copy of the ONNX model and report accuracy vs. speed.
+
+INT8 uses ONNX Runtime static quantization, calibrated on a folder of local images
+preprocessed exactly like the C++ Preprocessor (letterbox, grey 114 padding, RGB, 1/255).
+FP16 converts the weights with onnxconverter-common and keeps float32 inputs/outputs.
+
+The output is written next to the model as <name>.int8.onnx / <name>.fp16.onnx, which is
+what Detector loads when model.precision is set to "int8" / "fp16". Afterwards the C++
+ccm_quant_report tool (if built) compares both models on the same images: mAP-proxy agreement
+with the FP32 boxes, box counts and inference latency.
+
+Requires: pip install onnx onnxruntime opencv-python numpy   (fp16: onnxconverter-common)
+
+Examples:
+    python3 scripts/quantize_model.py --model models/yolov5s.onnx --images calib/
+    python3 scripts/quantize_model.py --model models/yolov5s.onnx --images calib/ --per-channel --method entropy
+    python3 scripts/quantize_model.py --model models/yolov5s.onnx --images calib/ --precision fp16
+"""
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+
+import cv2
+import numpy as np
+
+
+def letterbox(image, width, height, scale, swap_rb):
+    """Mirror of CCM::Preprocessor::run() with letterbox enabled -> 1x3xHxW float32."""
+    h, w = image.shape[:2]
+    r = min(width / float(w), height / float(h))
+    new_w, new_h = min(width, int(round(w * r))), min(height, int(round(h * r)))
+    pad_x, pad_y = (width - new_w) // 2, (height - new_h) // 2
+
+    canvas = np.full((height, width, 3), 114, dtype=np.uint8)
+    canvas[pad_y:pad_y + new_h, pad_x:pad_x + new_w] = cv2.resize(image, (new_w, new_h),
+                                                                  interpolation=cv2.INTER_LINEAR)
+    if swap_rb:
+        canvas = cv2.cvtColor(canvas, cv2.COLOR_BGR2RGB)
+    blob = canvas.astype(np.float32) * scale
+    return blob.transpose(2, 0, 1)[np.newaxis]
+
+
+def list_images(folder, limit):
+    files = sorted(f for f in glob.glob(os.path.join(folder, "*"))
+                   if f.lower().endswith((".jpg", ".jpeg", ".png", ".bmp")))
+    return files[:limit]
+
+
+def quantize_int8(args, output):
+    from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod, QuantFormat, QuantType,
+                                          quantize_static)
+    from onnxruntime.quantization.shape_inference import quant_pre_process
+    import onnxruntime as ort
+
+    input_name = ort.InferenceSession(args.model, providers=["CPUExecutionProvider"]).get_inputs()[0].name
+    files = list_images(args.images, args.num_images)
+    if not files:
+        sys.exit("No calibration images found in %s" % args.images)
+
+    class Reader(CalibrationDataReader):
+        def __init__(self):
+            self.files = iter(files)
+
+        def get_next(self):
+            for f in self.files:
+                img = cv2.imread(f, cv2.IMREAD_COLOR)
+                if img is not None:
+                    return {input_name: letterbox(img, args.input_width, args.input_height,
+                                                  args.pixel_scale, not args.no_swap_rb)}
+            return None
+
+    # Shape inference + graph cleanup first, as recommended by onnxruntime
+    prepared = output + ".prep.onnx"
+    quant_pre_process(args.model, prepared)
+
+    methods = {"minmax": CalibrationMethod.MinMax, "entropy": CalibrationMethod.Entropy,
+               "percentile": CalibrationMethod.Percentile}
+    print("Calibrating on %d images (%s)..." % (len(files), args.method))
+    quantize_static(prepared, output, Reader(),
+                    quant_format=QuantFormat.QDQ,
+                    activation_type=QuantType.QUInt8,
+                    weight_type=QuantType.QInt8,
+                    per_channel=args.per_channel,
+                    calibrate_method=methods[args.method],
+                    nodes_to_exclude=args.exclude_nodes)
+    os.remove(prepared)
+
+
+def convert_fp16(args, output):
+    import onnx
+    from onnxconverter_common import float16
+
+    model = onnx.load(args.model)
+    # keep_io_types: inputs/outputs stay float32, so every backend can feed the usual tensor
+    onnx.save(float16.convert_float_to_float16(model, keep_io_types=True), output)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--model", default="models/yolov5s.onnx", help="FP32 ONNX model")
+    parser.add_argument("--images", required=True, help="Folder of calibration / evaluation images")
+    parser.add_argument("--precision", choices=["int8", "fp16"], default="int8")
+    parser.add_argument("--output", help="Default: <model>.<precision>.onnx")
+    parser.add_argument("--num-images", type=int, default=100, help="Calibration images (int8)")
+    parser.add_argument("--method", choices=["minmax", "entropy", "percentile"], default="minmax")
+    parser.add_argument("--per-channel", action="store_true", help="Per-channel weight scales (better accuracy)")
+    parser.add_argument("--exclude-nodes", nargs="*", default=[],
+                        help="Node names kept in float (e.g. the final Detect head convolutions)")
+    parser.add_argument("--input-width", type=int, default=640)
+    parser.add_argument("--input-height", type=int, default=640)
+    parser.add_argument("--pixel-scale", type=float, default=1.0 / 255.0)
+    parser.add_argument("--no-swap-rb", action="store_true", help="Model expects BGR input")
+    parser.add_argument("--report-tool", default="build/ccm_quant_report", help="Path to ccm_quant_report")
+    parser.add_argument("--config", default="configs/zones.yaml")
+    parser.add_argument("--report", help="Save the JSON accuracy/latency report")
+    args = parser.parse_args()
+
+    output = args.output or "%s.%s.onnx" % (os.path.splitext(args.model)[0], args.precision)
+    if args.precision == "int8":
+        quantize_int8(args, output)
+    else:
+        convert_fp16(args, output)
+    print("Wrote %s (%.1f MB -> %.1f MB)" % (output, os.path.getsize(args.model) / 1e6, os.path.getsize(output) / 1e6))
+
+    if not os.path.exists(args.report_tool):
+        print("%s not built; skipping the accuracy/latency report." % args.report_tool)
+        return 0
+
+    cmd = [args.report_tool, "--images", args.images, "--reference", args.model, "--candidate", output,
+           "--precision", args.precision, "--config", args.config]
+    if args.report:
+        cmd += ["--output", args.report]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, universal_newlines=True)
+    try:
+        report = json.loads(proc.stdout)
+    except ValueError:
+        sys.stdout.write(proc.stdout)
+        return proc.returncode or 1
+
+    a = report["agreement"]
+    print("%-10s %-14s %7s %12s %12s" % ("model", "backend", "boxes", "infer p50", "infer p95"))
+    for key in ("fp32", "quantized"):
+        r = report[key]
+        print("%-10s %-14s %7d %9.2f ms %9.2f ms" % (key, r["backend"], r["boxes"],
+                                                      r["inference_p50_ms"], r["inference_p95_ms"]))
+    print("Agreement with FP32: mAP50-proxy %.3f | precision %.3f | recall %.3f | mean IoU %.3f" % (
+        a["map50_proxy"], a["precision"], a["recall"], a["mean_iou"]))
+    print("Inference speedup: %.2fx" % report["inference_speedup"])
+    return proc.returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""Read frames and detections from the ccm_edgevision shared-memory bus (shm: in configs/zones.yaml).
+
+The layout and seqlock protocol are defined in include/shm_layout.hpp; this module mirrors them
+with `struct`. Frames are read straight out of /dev/shm through mmap: `latest(copy=False)` returns
+a numpy view without copying (check `still_valid()` after using it), `latest()` returns a
+consistent copy. Readers never slow the publisher down; any number of them can attach.
+
+Requires: numpy (opencv-python only for --show)
+
+Examples:
+    python3 scripts/shm_reader.py                       # /ccm_cam0, print rate / latency / boxes
+    python3 scripts/shm_reader.py --name /ccm_door --show --names models/coco.names
+
+As a library:
+    from shm_reader import ShmReader
+    reader = ShmReader("/ccm_cam0")
+    reader.open()
+    frame = reader.latest()
+    if frame:
+        print(frame.frame_id, frame.image.shape, frame.detections)
+"""
+import argparse
+import collections
+import mmap
+import os
+import struct
+import sys
+import time
+
+import numpy as np
+
+MAGIC = b"CCMSHM\0\0"
+VERSION = 1
+
+# struct ShmHeader (128 bytes)
+HEADER = struct.Struct("<8s8IiIQII64s")
+WRITE_INDEX_OFFSET = 48
+# struct ShmSlotHeader (64 bytes, 48 used)
+SLOT = struct.Struct("<QQqIIIiII")
+# struct ShmDetection (32 bytes)
+DETECTION = struct.Struct("<iiiifiiI")
+SEQUENCE = struct.Struct("<Q")
+
+FLAG_DETECTED = 1
+FLAG_NO_PIXELS = 2
+
+Detection = collections.namedtuple("Detection", "x y width height confidence class_id track_id")
+Frame = collections.namedtuple("Frame", "index frame_id timestamp_ns detected image detections sequence slot")
+
+
+class ShmReader(object):
+    def __init__(self, name="/ccm_cam0"):
+        self.name = name if name.startswith("/") else "/" + name
+        self.mm = None
+        self.info = None
+
+    def open(self):
+        """Map the segment. Raises OSError/ValueError until the publisher has produced a frame."""
+        self.close()
+        fd = os.open("/dev/shm" + self.name, os.O_RDONLY)
+        try:
+            mm = mmap.mmap(fd, 0, mmap.MAP_SHARED, mmap.PROT_READ)
+        finally:
+            os.close(fd)
+        fields = HEADER.unpack_from(mm, 0)
+        if fields[0] != MAGIC:
+            mm.close()
+            raise ValueError("%s is not a CCM frame bus (or not initialised yet)" % self.name)
+        if fields[1] != VERSION:
+            mm.close()
+            raise ValueError("%s: layout version %d, expected %d" % (self.name, fields[1], VERSION))
+        keys = ("version", "header_size", "slot_count", "slot_size", "max_detections", "max_frame_bytes",
+                "detections_offset", "pixels_offset", "writer_pid")
+        self.info = dict(zip(keys, fields[1:10]))
+        self.info["stream_name"] = fields[14].split(b"\0", 1)[0].decode("utf-8", "replace")
+        self.mm = mm
+
+    def close(self):
+        if self.mm is not None:
+            self.mm.close()
+        self.mm = None
+
+    def published(self):
+        return SEQUENCE.unpack_from(self.mm, WRITE_INDEX_OFFSET)[0] if self.mm else 0
+
+    def writer_alive(self):
+        if self.mm is None or HEADER.unpack_from(self.mm, 0)[12] == 0:
+            return False
+        try:
+            os.kill(self.info["writer_pid"], 0)
+        except PermissionError:
+            return True
+        except OSError:
+            return False
+        return True
+
+    def _slot_offset(self, slot):
+        return self.info["header_size"] + slot * self.info["slot_size"]
+
+    def still_valid(self, frame):
+        """True if the slot behind a zero-copy frame has not been overwritten since it was read."""
+        return SEQUENCE.unpack_from(self.mm, self._slot_offset(frame.slot))[0] == frame.sequence
+
+    def latest(self, after_index=0, copy=True):
+        """Newest frame with index > after_index, or None. copy=False returns views into the segment."""
+        if self.mm is None:
+            return None
+        for _ in range(4):
+            index = self.published()
+            if index == 0 or index <= after_index:
+                return None
+            slot = (index - 1) % self.info["slot_count"]
+            base = self._slot_offset(slot)
+            seq, frame_id, ts, width, height, step, cv_type, count, flags = SLOT.unpack_from(self.mm, base)
+            if seq & 1:
+                continue
+            count = min(count, self.info["max_detections"])
+            det_base = base + self.info["detections_offset"]
+            detections = [Detection(*DETECTION.unpack_from(self.mm, det_base + i * DETECTION.size)[:7])
+                          for i in range(count)]
+
+            image = None
+            if not flags & FLAG_NO_PIXELS and height * step <= self.info["max_frame_bytes"]:
+                channels = (cv_type >> 3) + 1   # CV_8UC(n); the pipeline publishes CV_8UC3 (BGR)
+                image = np.frombuffer(self.mm, dtype=np.uint8, count=height * step,
+                                      offset=base + self.info["pixels_offset"])
+                image = image.reshape(height, step)[:, :width * channels].reshape(height, width, channels)
+                if copy:
+                    image = image.copy()
+
+            frame = Frame(index, frame_id, ts, bool(flags & FLAG_DETECTED), image, detections, seq, slot)
+            if self.still_valid(frame):
+                return frame
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--name", default="/ccm_cam0", help="Segment name (shm.name with {name} replaced)")
+    parser.add_argument("--show", action="store_true", help="Display the frames with their boxes (needs cv2)")
+    parser.add_argument("--names", help="Class names file for --show (e.g. models/coco.names)")
+    parser.add_argument("--seconds", type=float, default=0, help="Stop after N seconds (0 = until the publisher exits)")
+    args = parser.parse_args()
+
+    reader = ShmReader(args.name)
+    while True:
+        try:
+            reader.open()
+            break
+        except (OSError, ValueError) as e:
+            print("Waiting for %s (%s)" % (args.name, e), file=sys.stderr)
+            time.sleep(1)
+    print("%s: stream '%s', %d slots x %d bytes" % (args.name, reader.info["stream_name"],
+                                                    reader.info["slot_count"], reader.info["slot_size"]))
+
+    labels = []
+    if args.names:
+        with open(args.names) as f:
+            labels = [line.strip() for line in f]
+    if args.show:
+        import cv2
+
+    started = window = time.monotonic()
+    last_index = reader.published()
+    frames = skipped = 0
+    latency_ms = 0.0
+    while not args.seconds or time.monotonic() - started < args.seconds:
+        frame = reader.latest(last_index, copy=args.show)
+        if frame is None:
+            if not reader.writer_alive():
+                print("Publisher exited.")
+                break
+            time.sleep(0.001)
+            continue
+
+        skipped += frame.index - last_index - 1
+        last_index = frame.index
+        frames += 1
+        latency_ms += (time.monotonic_ns() - frame.timestamp_ns) / 1e6
+
+        if args.show and frame.image is not None:
+            for d in frame.detections:
+                label = labels[d.class_id] if 0 <= d.class_id < len(labels) else str(d.class_id)
+                cv2.rectangle(frame.image, (d.x, d.y), (d.x + d.width, d.y + d.height), (0, 255, 0), 2)
+                cv2.putText(frame.image, "#%d %s %.2f" % (d.track_id, label, d.confidence), (d.x, d.y - 4),
+                            cv2.FONT_HERSHEY_SIMPLEX, 0.5, (0, 255, 0), 1)
+            cv2.imshow("shm " + reader.info["stream_name"], frame.image)
+            if cv2.waitKey(1) == 27:
+                break
+
+        now = time.monotonic()
+        if now - window >= 1.0:
+            print("%.1f fps | skipped %d | capture->read %.2f ms | frame %d | %d objects" % (
+                frames / (now - window), skipped, latency_ms / frames, frame.frame_id, len(frame.detections)))
+            window, frames, skipped, latency_ms = now, 0, 0, 0.0
+    frame = None   # Drop any view into the mapping before unmapping it
+    reader.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#include "assignment.hpp"
+#include <cstddef>
+#include <limits>
+
+namespace CCM {
+
+int HungarianSolver::solve(const std::vector<float>& cost, int rows, int cols, std::vector<int>& row_to_col) {
+    row_to_col.assign(static_cast<size_t>(rows), -1);
+    if (rows == 0 || cols == 0) return 0;
+
+    // The algorithm needs n <= m; solve the transposed problem otherwise.
+    const bool transposed = rows > cols;
+    const float* a = cost.data();
+    int n = rows, m = cols;
+    if (transposed) {
+        work_.resize(static_cast<size_t>(rows) * cols);
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c) work_[static_cast<size_t>(c) * rows + r] = cost[static_cast<size_t>(r) * cols + c];
+        a = work_.data();
+        n = cols;
+        m = rows;
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    u_.assign(n + 1, 0.0);
+    v_.assign(m + 1, 0.0);
+    p_.assign(m + 1, 0);   // p_[j]: row (1-based) assigned to column j, 0 = free
+    way_.assign(m + 1, 0);
+
+    for (int i = 1; i <= n; ++i) {
+        p_[0] = i;
+        int j0 = 0;
+        min_v_.assign(m + 1, inf);
+        used_.assign(m + 1, 0);
+
+        // Grow an alternating tree from row i until a free column is reached
+        do {
+            used_[j0] = 1;
+            const int i0 = p_[j0];
+            const float* row = a + static_cast<size_t>(i0 - 1) * m;
+            double delta = inf;
+            int j1 = 0;
+            for (int j = 1; j <= m; ++j) {
+                if (used_[j]) continue;
+                const double cur = row[j - 1] - u_[i0] - v_[j];
+                if (cur < min_v_[j]) {
+                    min_v_[j] = cur;
+                    way_[j] = j0;
+                }
+                if (min_v_[j] < delta) {
+                    delta = min_v_[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= m; ++j) {
+                if (used_[j]) {
+                    u_[p_[j]] += delta;
+                    v_[j] -= delta;
+                } else {
+                    min_v_[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p_[j0] != 0);
+
+        // Augment along the path
+        do {
+            const int j1 = way_[j0];
+            p_[j0] = p_[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    int matches = 0;
+    for (int j = 1; j <= m; ++j) {
+        if (p_[j] == 0) continue;
+        const int r = transposed ? j - 1 : p_[j] - 1;
+        const int c = transposed ? p_[j] - 1 : j - 1;
+        if (cost[static_cast<size_t>(r) * cols + c] >= kInfeasible) continue;
+        row_to_col[r] = c;
+        ++matches;
+    }
+    return matches;
+}
+
+} // namespace CCM
@@ -0,0 +1,185 @@
+#include "batch_scheduler.hpp"
+#include <algorithm>
+#include "logger.hpp"
+
+namespace CCM {
+
+// A request waiting this many max_wait_ms periods is served ahead of higher-priority streams
+static const int kStarvationFactor = 4;
+
+BatchScheduler::BatchScheduler(Detector& detector, const AppConfig& config)
+    : detector_(detector), config_(config), priority_policy_(config.batching.policy == "priority") {
+    if (config.batching.policy != "priority" && config.batching.policy != "round_robin") {
+        CCM_LOG_WARN("BatchScheduler", "Unknown batching.policy '%s', using round_robin.",
+                     config.batching.policy.c_str());
+    }
+}
+
+BatchScheduler::~BatchScheduler() {
+    stop();
+}
+
+void BatchScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    worker_ = std::thread(&BatchScheduler::workerLoop, this);
+}
+
+void BatchScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+
+    // Unblock anyone still waiting on a result
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& req : pending_) {
+        req.output->clear();
+        complete(req.stream_id);
+    }
+    pending_.clear();
+}
+
+int BatchScheduler::addStream(const ConfigStore& stream_config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.push_back(&stream_config);
+    snapshots_.push_back(stream_config.snapshot());
+    snapshot_versions_.push_back(stream_config.version());
+    slots_.emplace_back(new Slot());
+    return static_cast<int>(streams_.size()) - 1;
+}
+
+bool BatchScheduler::submit(int stream_id, const cv::Mat& frame, std::vector<Detection>& detections) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_ || stream_id < 0 || stream_id >= static_cast<int>(slots_.size())) {
+        detections.clear();
+        return false;
+    }
+
+    Slot& slot = *slots_[stream_id];
+    slot.done = false;
+    pending_.push_back(Request{stream_id, frame, std::chrono::steady_clock::now(), &detections});
+    cv_.notify_one();
+    slot.done_cv.wait(lock, [&slot] { return slot.done; });
+    return true;
+}
+
+void BatchScheduler::complete(int stream_id) {
+    Slot& slot = *slots_[stream_id];
+    slot.done = true;
+    slot.done_cv.notify_one();
+}
+
+void BatchScheduler::takeBatch(std::vector<Request>& batch, size_t max_batch) {
+    const size_t stream_count = streams_.size();
+    taken_.assign(pending_.size(), 0);
+    picks_.clear();
+
+    auto pick = [this](size_t i) {
+        taken_[i] = 1;
+        picks_.push_back(i);
+    };
+
+    // Service order: round-robin from the cursor; priority mode sorts that order by priority
+    order_.resize(stream_count);
+    for (size_t i = 0; i < stream_count; ++i) order_[i] = (next_stream_ + i) % stream_count;
+    if (priority_policy_) {
+        std::stable_sort(order_.begin(), order_.end(), [this](size_t a, size_t b) {
+            return snapshots_[a]->camera.priority > snapshots_[b]->camera.priority;
+        });
+
+        // Starvation guard: long-waiting frames first, oldest first
+        const auto now = std::chrono::steady_clock::now();
+        const auto limit = std::chrono::milliseconds(kStarvationFactor * std::max(1, config_.batching.max_wait_ms));
+        for (size_t i = 0; i < pending_.size() && picks_.size() < max_batch; ++i) {
+            if (now - pending_[i].enqueued_at > limit) pick(i);
+        }
+    }
+
+    // One frame per stream per pass, so a fast camera cannot crowd out the others
+    bool progress = true;
+    while (picks_.size() < max_batch && progress) {
+        progress = false;
+        for (size_t stream : order_) {
+            if (picks_.size() >= max_batch) break;
+            for (size_t i = 0; i < pending_.size(); ++i) {
+                if (!taken_[i] && pending_[i].stream_id == static_cast<int>(stream)) {
+                    pick(i);
+                    progress = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t i : picks_) batch.push_back(std::move(pending_[i]));
+    if (!batch.empty() && stream_count > 0) {
+        next_stream_ = (static_cast<size_t>(batch.back().stream_id) + 1) % stream_count;
+    }
+
+    // Erase the taken requests in place; the rest keep their arrival order
+    size_t kept = 0;
+    for (size_t i = 0; i < pending_.size(); ++i) {
+        if (taken_[i]) continue;
+        if (kept != i) pending_[kept] = std::move(pending_[i]);
+        ++kept;
+    }
+    pending_.erase(pending_.begin() + static_cast<std::ptrdiff_t>(kept), pending_.end());
+}
+
+void BatchScheduler::workerLoop() {
+    const size_t max_batch = static_cast<size_t>(std::max(1, config_.batching.max_batch));
+    const auto max_wait = std::chrono::milliseconds(std::max(0, config_.batching.max_wait_ms));
+
+    std::vector<Request> batch;
+    std::vector<cv::Mat> frames;
+    std::vector<const AppConfig*> configs;
+    batch.reserve(max_batch);
+    frames.reserve(max_batch);
+    configs.reserve(max_batch);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !running_ || !pending_.empty(); });
+            if (!running_) return;
+
+            // Hold the batch open until it is full, every stream has a frame, or the
+            // oldest request hits its deadline.
+            const auto deadline = pending_.front().enqueued_at + max_wait;
+            const size_t ready_at = std::min(max_batch, std::max<size_t>(1, streams_.size()));
+            cv_.wait_until(lock, deadline, [this, ready_at] {
+                return !running_ || pending_.size() >= ready_at;
+            });
+            if (!running_) return;
+
+            for (size_t i = 0; i < streams_.size(); ++i) streams_[i]->refresh(snapshots_[i], snapshot_versions_[i]);
+            takeBatch(batch, max_batch);
+
+            for (const auto& req : batch) configs.push_back(snapshots_[req.stream_id].get());
+        }
+
+        for (const auto& req : batch) frames.push_back(req.frame);
+
+        detector_.detectBatch(frames, configs, results_);
+
+        // Copied element-wise, so both the caller's list and results_ keep their storage
+        for (size_t i = 0; i < batch.size(); ++i) *batch[i].output = results_[i];
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& req : batch) complete(req.stream_id);
+        }
+
+        CCM_LOG_DEBUG("BatchScheduler", "dispatched batch of %zu", batch.size());
+
+        batch.clear();
+        frames.clear();
+        configs.clear();
+    }
+}
+
+} // namespace CCM
@@ -0,0 +1,203 @@
+// Micro-benchmark: YoloDecoder vs. the original scalar decode loop from Detector::detect, and
+// YOLOv8 channel-major decoding in place vs. transposing to rows first.
+//
+// Usage: bench_decoder [iterations] [positive_ratio]
+//   positive_ratio: fraction of rows whose objectness (v8: best class score) passes the threshold (default 0.01)
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "yolo_decoder.hpp"
+
+// Reference: the pre-YoloDecoder loop (per-frame vectors, per-row factors, scalar argmax)
+static void referenceDecode(const cv::Mat& output, const CCM::LetterboxInfo& letterbox,
+                            float conf_threshold, int max_classes,
+                            std::vector<cv::Rect>& out_boxes, std::vector<float>& out_conf,
+                            std::vector<int>& out_ids) {
+    const int rows = output.rows;
+    const int num_classes = output.cols - 5;
+
+    std::vector<int> class_ids;
+    std::vector<float> confidences;
+    std::vector<cv::Rect> boxes;
+
+    for (int i = 0; i < rows; ++i) {
+        const float* data = output.ptr<float>(i);
+        float obj_conf = data[4];
+        if (obj_conf < conf_threshold) continue;
+
+        int best_class_id = -1;
+        float best_class_score = 0.0f;
+        for (int c = 0; c < num_classes && c < max_classes; ++c) {
+            float score = data[5 + c];
+            if (score > best_class_score) {
+                best_class_score = score;
+                best_class_id = c;
+            }
+        }
+        if (best_class_id < 0) continue;
+
+        float combined_conf = obj_conf * best_class_score;
+        if (combined_conf < conf_threshold) continue;
+
+        const cv::Size& frame_size = letterbox.frame_size;
+        const float x_factor = 1.0f / letterbox.scale_x;
+        const float y_factor = 1.0f / letterbox.scale_y;
+
+        float cx = (data[0] - letterbox.pad_x) * x_factor;
+        float cy = (data[1] - letterbox.pad_y) * y_factor;
+        float boxW = data[2] * x_factor;
+        float boxH = data[3] * y_factor;
+
+        int left = static_cast<int>(cx - 0.5f * boxW);
+        int top = static_cast<int>(cy - 0.5f * boxH);
+        int widthPx = std::max(1, static_cast<int>(boxW));
+        int heightPx = std::max(1, static_cast<int>(boxH));
+
+        if (left < 0) { widthPx += left; left = 0; }
+        if (top < 0) { heightPx += top; top = 0; }
+        if (left + widthPx > frame_size.width) widthPx = frame_size.width - left;
+        if (top + heightPx > frame_size.height) heightPx = frame_size.height - top;
+        if (widthPx <= 0 || heightPx <= 0) continue;
+
+        confidences.emplace_back(combined_conf);
+        boxes.emplace_back(left, top, widthPx, heightPx);
+        class_ids.emplace_back(best_class_id);
+    }
+
+    out_boxes.swap(boxes);
+    out_conf.swap(confidences);
+    out_ids.swap(class_ids);
+}
+
+static cv::Mat makeSyntheticOutput(int rows, int num_classes, float positive_ratio, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    std::uniform_real_distribution<float> coord(0.0f, 640.0f);
+    std::uniform_real_distribution<float> size(8.0f, 200.0f);
+
+    cv::Mat output(rows, 5 + num_classes, CV_32F);
+    for (int i = 0; i < rows; ++i) {
+        float* r = output.ptr<float>(i);
+        r[0] = coord(rng);
+        r[1] = coord(rng);
+        r[2] = size(rng);
+        r[3] = size(rng);
+        r[4] = uni(rng) < positive_ratio ? 0.5f + 0.5f * uni(rng) : 0.05f * uni(rng);
+        for (int c = 0; c < num_classes; ++c) r[5 + c] = uni(rng);
+    }
+    return output;
+}
+
+// YOLOv8 head: [4 + classes] x anchors, no objectness
+static cv::Mat makeSyntheticV8Output(int anchors, int num_classes, float positive_ratio, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    std::uniform_real_distribution<float> coord(0.0f, 640.0f);
+    std::uniform_real_distribution<float> size(8.0f, 200.0f);
+
+    cv::Mat output(4 + num_classes, anchors, CV_32F);
+    for (int a = 0; a < anchors; ++a) {
+        output.at<float>(0, a) = coord(rng);
+        output.at<float>(1, a) = coord(rng);
+        output.at<float>(2, a) = size(rng);
+        output.at<float>(3, a) = size(rng);
+        const bool positive = uni(rng) < positive_ratio;
+        for (int c = 0; c < num_classes; ++c) output.at<float>(4 + c, a) = 0.2f * uni(rng);
+        if (positive) output.at<float>(4 + static_cast<int>(uni(rng) * num_classes) % num_classes, a) = 0.5f + 0.5f * uni(rng);
+    }
+    return output;
+}
+
+static int benchChannelMajor(int iterations, float positive_ratio, const CCM::LetterboxInfo& letterbox,
+                             float threshold) {
+    const int anchors = 8400;               // YOLOv8 @ 640x640
+    std::cout << "\nYOLOv8 [channels x " << anchors << "]\n";
+    std::cout << "classes | transpose + rows ms | channel-major ms | speedup | match\n";
+
+    CCM::YoloLayout rows_layout;
+    rows_layout.objectness = false;
+    CCM::YoloLayout v8_layout;
+    v8_layout.channel_major = true;
+    v8_layout.objectness = false;
+
+    for (int num_classes : {80, 256, 1000}) {
+        cv::Mat output = makeSyntheticV8Output(anchors, num_classes, positive_ratio, 42u);
+        cv::Mat transposed;
+        CCM::YoloDecoder by_rows;
+        CCM::YoloDecoder in_place;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            cv::transpose(output, transposed);
+            by_rows.decode(transposed, letterbox, threshold, num_classes, -1.0f, rows_layout);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            in_place.decode(output, letterbox, threshold, num_classes, -1.0f, v8_layout);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        const double rows_ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+        const double v8_ms = std::chrono::duration<double, std::milli>(t2 - t1).count() / iterations;
+        const bool match = by_rows.boxes() == in_place.boxes() && by_rows.confidences() == in_place.confidences() &&
+                           by_rows.classIds() == in_place.classIds();
+
+        std::cout << num_classes << " | " << rows_ms << " | " << v8_ms << " | "
+                  << (v8_ms > 0 ? rows_ms / v8_ms : 0.0) << "x | " << (match ? "yes" : "NO") << "\n";
+        if (!match) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 200;
+    const float positive_ratio = argc > 2 ? std::stof(argv[2]) : 0.01f;
+
+    const int rows = 25200;                 // YOLOv5 @ 640x640
+    const cv::Size frame_size(640, 480);
+    const cv::Size input_size(640, 640);
+    const float threshold = 0.25f;
+    const CCM::LetterboxInfo letterbox = CCM::LetterboxInfo::fit(frame_size, input_size);
+
+    std::cout << "rows=" << rows << " iterations=" << iterations
+              << " positive_ratio=" << positive_ratio << "\n";
+    std::cout << "classes | reference ms | decoder ms | speedup | match\n";
+
+    for (int num_classes : {80, 256, 1000}) {
+        cv::Mat output = makeSyntheticOutput(rows, num_classes, positive_ratio, 42u);
+
+        std::vector<cv::Rect> ref_boxes;
+        std::vector<float> ref_conf;
+        std::vector<int> ref_ids;
+        CCM::YoloDecoder decoder;
+
+        // Warm up (also sizes the decoder's persistent buffers)
+        referenceDecode(output, letterbox, threshold, num_classes, ref_boxes, ref_conf, ref_ids);
+        decoder.decode(output, letterbox, threshold, num_classes);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            referenceDecode(output, letterbox, threshold, num_classes, ref_boxes, ref_conf, ref_ids);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            decoder.decode(output, letterbox, threshold, num_classes);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        const double ref_ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+        const double dec_ms = std::chrono::duration<double, std::milli>(t2 - t1).count() / iterations;
+
+        const bool match = ref_boxes == decoder.boxes() && ref_conf == decoder.confidences() &&
+                           ref_ids == decoder.classIds();
+
+        std::cout << num_classes << " | " << ref_ms << " | " << dec_ms << " | "
+                  << (dec_ms > 0 ? ref_ms / dec_ms : 0.0) << "x | " << (match ? "yes" : "NO") << "\n";
+        if (!match) return 1;
+    }
+
+    return benchChannelMajor(iterations, positive_ratio, letterbox, threshold);
+}
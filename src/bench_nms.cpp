@@ -0,0 +1,112 @@
+// Micro-benchmark: NmsEngine vs. cv::dnn::NMSBoxes over a sweep of candidate counts.
+//
+// Usage: bench_nms [iterations] [classes]
+//   Candidates are clustered around a few hundred synthetic objects (as a detector's are), with
+//   scores spread from 0.25 to 1. The class-agnostic greedy result must match NMSBoxes exactly.
+#include <opencv2/dnn.hpp>
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "nms.hpp"
+
+static void makeCandidates(int count, int num_classes, unsigned seed, std::vector<cv::Rect>& boxes,
+                           std::vector<float>& scores, std::vector<int>& class_ids) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    std::normal_distribution<float> jitter(0.0f, 6.0f);
+
+    // Objects in a 1920x1080 frame; each candidate is a jittered copy of one of them
+    const int objects = std::max(1, count / 20);
+    std::vector<cv::Rect> truth;
+    std::vector<int> truth_class;
+    for (int i = 0; i < objects; ++i) {
+        const int w = 16 + static_cast<int>(uni(rng) * 200);
+        const int h = 16 + static_cast<int>(uni(rng) * 200);
+        truth.emplace_back(static_cast<int>(uni(rng) * (1920 - w)), static_cast<int>(uni(rng) * (1080 - h)), w, h);
+        truth_class.push_back(static_cast<int>(uni(rng) * num_classes) % num_classes);
+    }
+
+    boxes.clear();
+    scores.clear();
+    class_ids.clear();
+    for (int i = 0; i < count; ++i) {
+        const size_t o = static_cast<size_t>(uni(rng) * objects) % truth.size();
+        const cv::Rect& t = truth[o];
+        boxes.emplace_back(t.x + static_cast<int>(jitter(rng)), t.y + static_cast<int>(jitter(rng)),
+                           std::max(1, t.width + static_cast<int>(jitter(rng))),
+                           std::max(1, t.height + static_cast<int>(jitter(rng))));
+        scores.push_back(0.25f + 0.75f * uni(rng));
+        class_ids.push_back(uni(rng) < 0.9f ? truth_class[o] : static_cast<int>(uni(rng) * num_classes) % num_classes);
+    }
+}
+
+static double timeMs(int iterations, const std::function<void()>& fn) {
+    fn();   // Warm up (sizes the engine's buffers)
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::stoi(argv[1]) : 50;
+    const int num_classes = argc > 2 ? std::stoi(argv[2]) : 80;
+    const float score_threshold = 0.25f;
+    const float iou_threshold = 0.4f;
+
+    std::cout << "iterations=" << iterations << " classes=" << num_classes << "\n";
+    std::cout << "candidates | NMSBoxes ms | greedy ms | per-class ms | top-1000 ms | soft ms | matrix ms | kept | match\n";
+
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<int> class_ids;
+    std::vector<int> reference, keep;
+    std::vector<float> keep_scores;
+    CCM::NmsEngine engine;
+
+    for (int count : {100, 1000, 5000, 20000}) {
+        makeCandidates(count, num_classes, 42u, boxes, scores, class_ids);
+
+        CCM::NmsParams agnostic;
+        agnostic.iou_threshold = iou_threshold;
+        agnostic.score_threshold = score_threshold;
+        agnostic.per_class = false;
+
+        CCM::NmsParams per_class = agnostic;
+        per_class.per_class = true;
+
+        CCM::NmsParams top_k = per_class;
+        top_k.top_k = 1000;
+
+        // Soft / Matrix are O(n^2) over what enters suppression: always measured with top_k
+        CCM::NmsParams soft = top_k;
+        soft.method = CCM::NmsMethod::Soft;
+        CCM::NmsParams matrix = top_k;
+        matrix.method = CCM::NmsMethod::Matrix;
+
+        const double ref_ms = timeMs(iterations, [&] {
+            cv::dnn::NMSBoxes(boxes, scores, score_threshold, iou_threshold, reference);
+        });
+        const double greedy_ms = timeMs(iterations, [&] { engine.run(boxes, scores, class_ids, agnostic, keep, keep_scores); });
+        const bool match = keep == reference;
+        const double per_class_ms = timeMs(iterations, [&] {
+            engine.run(boxes, scores, class_ids, per_class, keep, keep_scores);
+        });
+        const size_t kept = keep.size();
+        const double top_k_ms = timeMs(iterations, [&] { engine.run(boxes, scores, class_ids, top_k, keep, keep_scores); });
+        const double soft_ms = timeMs(iterations, [&] { engine.run(boxes, scores, class_ids, soft, keep, keep_scores); });
+        const double matrix_ms = timeMs(iterations, [&] {
+            engine.run(boxes, scores, class_ids, matrix, keep, keep_scores);
+        });
+
+        std::cout << count << " | " << ref_ms << " | " << greedy_ms << " | " << per_class_ms << " | " << top_k_ms
+                  << " | " << soft_ms << " | " << matrix_ms << " | " << kept << " | " << (match ? "yes" : "NO") << "\n";
+        if (!match) return 1;
+    }
+
+    return 0;
+}
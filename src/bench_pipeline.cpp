@@ -0,0 +1,394 @@
+// Offline pipeline benchmark: replays recorded video or image sequences through
+// BatchScheduler / Detector -> Tracker -> OverlayRenderer, headless, and reports throughput, per-stage
+// latency percentiles, heap allocations per frame and peak RSS as JSON. Optionally gates
+// against a stored baseline and an allocation budget.
+//
+// Usage: ccm_bench --input <video | dir | img_%04d.png> [options]
+//   --config <path>       Config to load (default configs/zones.yaml)
+//   --iterations <n>      Passes over the loaded frames (default 3)
+//   --warmup <n>          Untimed frames before measuring (default 10)
+//   --max-frames <n>      Frames to preload from the input (default 300)
+//   --output <path>       Write the JSON report to a file (always printed to stdout)
+//   --baseline <path>     Compare against a previous report; exit code 2 on regression
+//   --tolerance <ratio>   Allowed regression vs the baseline (default 0.10 = 10%)
+//   --max-allocs-per-frame <x>  Exit code 3 if the measured frames average more heap allocations
+//   --test                Skip the network and simulate detections (no model needed)
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "batch_scheduler.hpp"
+#include "config.hpp"
+#include "config_store.hpp"
+#include "detector.hpp"
+#include "motion_gate.hpp"
+#include "logger.hpp"
+#include "mat_pool.hpp"
+#include "metrics.hpp"
+#include "overlay_renderer.hpp"
+#include "tracker.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace CCM;
+
+// Every operator new in the process (containers, strings, OpenCV's C++ objects) is counted.
+// cv::Mat buffers bypass it (cv::fastMalloc) and are counted by the MatPool instead.
+static std::atomic<uint64_t> g_heap_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static uint64_t heapAllocations() {
+    return g_heap_allocations.load(std::memory_order_relaxed) + MatPool::instance().allocations();
+}
+
+struct BenchOptions {
+    std::string input;
+    std::string config_path = "configs/zones.yaml";
+    std::string output_path;
+    std::string baseline_path;
+    int iterations = 3;
+    int warmup = 10;
+    int max_frames = 300;
+    double tolerance = 0.10;
+    double max_allocs_per_frame = -1.0;   // < 0: not gated
+    bool test_mode = false;
+};
+
+// Stages compared against the baseline (p95). Stages with no samples on either side are skipped.
+static const Stage kGatedStages[] = {Stage::Preprocess, Stage::Inference, Stage::Decode,
+                                     Stage::NMS, Stage::Track, Stage::Render, Stage::EndToEnd};
+
+static long peakRssKb() {
+#ifndef _WIN32
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss; // KB on Linux
+#endif
+    return 0;
+}
+
+static bool parseArgs(int argc, char** argv, BenchOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--input" && has_value) opt.input = argv[++i];
+        else if (arg == "--config" && has_value) opt.config_path = argv[++i];
+        else if (arg == "--output" && has_value) opt.output_path = argv[++i];
+        else if (arg == "--baseline" && has_value) opt.baseline_path = argv[++i];
+        else if (arg == "--iterations" && has_value) opt.iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--warmup" && has_value) opt.warmup = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--max-frames" && has_value) opt.max_frames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--tolerance" && has_value) opt.tolerance = std::atof(argv[++i]);
+        else if (arg == "--max-allocs-per-frame" && has_value) opt.max_allocs_per_frame = std::atof(argv[++i]);
+        else if (arg == "--test") opt.test_mode = true;
+        else {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+    return !opt.input.empty();
+}
+
+// Decodes everything up front so file I/O and video decoding stay out of the measurements.
+static std::vector<cv::Mat> loadFrames(const std::string& input, int max_frames) {
+    std::vector<cv::Mat> frames;
+
+    // Video files and printf-style image sequences (e.g. frames/img_%04d.png)
+    cv::VideoCapture cap(input);
+    cv::Mat frame;
+    while (static_cast<int>(frames.size()) < max_frames && cap.read(frame)) {
+        frames.push_back(frame.clone());
+    }
+    if (!frames.empty()) return frames;
+
+    // Otherwise treat the input as a directory of images (sorted by name)
+    std::vector<std::string> files;
+    try {
+        cv::glob(input + "/*", files, false);
+    } catch (const cv::Exception&) {
+        return frames;
+    }
+    for (const auto& f : files) {
+        if (static_cast<int>(frames.size()) >= max_frames) break;
+        cv::Mat img = cv::imread(f, cv::IMREAD_COLOR);
+        if (!img.empty()) frames.push_back(img);
+    }
+    return frames;
+}
+
+static void writeStages(cv::FileStorage& fs) {
+    fs << "stages" << "{";
+    for (int i = 0; i < static_cast<int>(Stage::Count); ++i) {
+        const auto s = Metrics::instance().histogram(static_cast<Stage>(i)).summary();
+        fs << stageName(static_cast<Stage>(i)) << "{"
+           << "count" << static_cast<double>(s.count)
+           << "mean_ms" << s.mean_us / 1000.0
+           << "p50_ms" << s.p50_us / 1000.0
+           << "p95_ms" << s.p95_us / 1000.0
+           << "p99_ms" << s.p99_us / 1000.0
+           << "max_ms" << s.max_us / 1000.0
+           << "}";
+    }
+    fs << "}";
+}
+
+/**
+ * @brief Compares the current run with a stored report.
+ * Throughput may drop and latency/RSS may grow by at most `tolerance` (relative).
+ * @return true if no metric regressed.
+ */
+static bool compareWithBaseline(const std::string& path, double throughput, long rss_kb, double tolerance) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) {
+        std::cerr << "Cannot open baseline " << path << "\n";
+        return false;
+    }
+
+    bool ok = true;
+    auto check = [&](const std::string& name, double base, double current, bool higher_is_better) {
+        if (base <= 0.0) return;
+        const double delta = (current - base) / base;
+        const bool regressed = higher_is_better ? delta < -tolerance : delta > tolerance;
+        std::fprintf(stderr, "  %-28s base=%10.3f  now=%10.3f  %+6.1f%%  %s\n", name.c_str(), base, current,
+                     delta * 100.0, regressed ? "REGRESSED" : "ok");
+        ok = ok && !regressed;
+    };
+
+    std::fprintf(stderr, "Baseline comparison (tolerance %.0f%%):\n", tolerance * 100.0);
+    check("throughput_fps", static_cast<double>(fs["throughput_fps"]), throughput, true);
+    check("peak_rss_kb", static_cast<double>(fs["peak_rss_kb"]), static_cast<double>(rss_kb), false);
+
+    cv::FileNode stages = fs["stages"];
+    for (Stage stage : kGatedStages) {
+        const char* name = stageName(stage);
+        cv::FileNode node = stages[name];
+        const auto now = Metrics::instance().histogram(stage).summary();
+        if (node.empty() || now.count == 0) continue;
+        check(std::string(name) + ".p95_ms", static_cast<double>(node["p95_ms"]), now.p95_us / 1000.0, false);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: ccm_bench --input <video | dir | img_%04d.png> [--config path] [--iterations n]\n"
+                     "                 [--warmup n] [--max-frames n] [--output report.json]\n"
+                     "                 [--baseline report.json] [--tolerance 0.10]\n"
+                     "                 [--max-allocs-per-frame x] [--test]\n";
+        return 1;
+    }
+
+    // Keep the console for the report; per-frame logs would distort the timings
+    Logger& logger = Logger::instance();
+    logger.setLevel(LogLevel::Warn);
+    logger.start();
+
+    AppConfig config = AppConfig::load(opt.config_path);
+    if (!config.validate()) {
+        logger.stop();
+        return 1;
+    }
+    if (config.pipeline.mat_pool_mb > 0) MatPool::install(static_cast<size_t>(config.pipeline.mat_pool_mb) << 20);
+
+    std::vector<cv::Mat> frames = loadFrames(opt.input, opt.max_frames);
+    if (frames.empty()) {
+        CCM_LOG_ERROR("Bench", "No frames could be read from %s", opt.input.c_str());
+        logger.stop();
+        return 1;
+    }
+
+    std::unique_ptr<Detector> detector;
+    if (!opt.test_mode) {
+        const std::string model = config.model_path.empty() ? "models/yolov5s.onnx" : config.model_path;
+        const std::string classes = config.class_names.empty() ? "models/coco.names" : config.class_names;
+        if (!std::ifstream(model).good()) {
+            CCM_LOG_ERROR("Bench", "Model file not found: %s (use --test to benchmark without a model)",
+                          model.c_str());
+            logger.stop();
+            return 1;
+        }
+        detector.reset(new Detector(model, classes, config));
+        if (!detector->isReady()) {
+            logger.stop();
+            return 1;
+        }
+    }
+
+    // Frames take the live pipeline's path: one stream on the batch scheduler's worker thread
+    ConfigStore stream_config(config);
+    std::unique_ptr<BatchScheduler> scheduler;
+    int stream_id = 0;
+    if (detector) {
+        scheduler.reset(new BatchScheduler(*detector, config));
+        stream_id = scheduler->addStream(stream_config);
+        scheduler->start();
+    }
+
+    Tracker tracker(config.tracker);
+    OverlayRenderer renderer;
+    Metrics& metrics = Metrics::instance();
+    cv::Mat canvas;
+    int sim_x = 0;
+    uint64_t frame_index = 0;
+    uint64_t since_detection = 0;
+    uint64_t detected_frames = 0;
+    MotionGate motion_gate;
+    // Per-packet detection lists, cycled like the live pipeline's spares (queue_depth + 2 in flight)
+    std::vector<std::vector<Detection>> packet_lists(static_cast<size_t>(std::max(1, config.pipeline.queue_depth)) + 2);
+    std::vector<TrackedObject> tracks;
+    const uint64_t detect_interval = static_cast<uint64_t>(std::max(1, config.detection.every_n_frames));
+
+    auto processFrame = [&](const cv::Mat& source) {
+        const auto start = std::chrono::steady_clock::now();
+        {
+            // Stands in for capture: the renderer draws in place, so each pass needs a fresh copy
+            CCM_TIMED_SCOPE(Stage::Capture);
+            source.copyTo(canvas);
+        }
+
+        std::vector<Detection>& detections = packet_lists[frame_index % packet_lists.size()];
+
+        // Same schedule as the live pipeline (detection.every_n_frames, motion gate), so the payoff can be measured
+        bool detect = frame_index++ % detect_interval == 0;
+        if (detect && config.motion.enabled) {
+            CCM_TIMED_SCOPE(Stage::Motion);
+            if (motion_gate.changed(source, config.motion) ||
+                since_detection + 1 >= static_cast<uint64_t>(config.motion.max_skip_frames)) {
+                motion_gate.markDetected();
+            } else {
+                detect = false;
+            }
+        }
+        since_detection = detect ? 0 : since_detection + 1;
+        detected_frames += detect ? 1 : 0;
+        if (detect) {
+            if (scheduler) {
+                scheduler->submit(stream_id, canvas, detections);
+            } else {
+                sim_x = (sim_x + 5) % std::max(1, canvas.cols);
+                detections.resize(1);
+                detections[0].class_id = 0;
+                detections[0].className = "person (sim)";
+                detections[0].confidence = 0.99f;
+                detections[0].box = cv::Rect(sim_x, 100, 100, 200);
+            }
+        }
+
+        {
+            CCM_TIMED_SCOPE(Stage::Track);
+            if (detect) {
+                tracker.update(detections, tracks);
+            } else {
+                tracker.predict(tracks);
+                // Tracks confirmed this frame stand in for detections (written over the previous list)
+                size_t count = 0;
+                for (const auto& t : tracks) {
+                    if (t.lost_frames != 0) continue;
+                    if (count == detections.size()) detections.emplace_back();
+                    Detection& d = detections[count++];
+                    d.class_id = t.class_id;
+                    d.className = t.className;
+                    d.confidence = t.confidence;
+                    d.box = t.rect;
+                }
+                detections.resize(count);
+            }
+        }
+
+        {
+            CCM_TIMED_SCOPE(Stage::Render);
+            renderer.draw(canvas, detections, config);
+        }
+
+        metrics.record(Stage::EndToEnd, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+        metrics.frameCompleted();
+    };
+
+    // Warm-up: first forward passes include backend initialisation and allocations
+    for (int i = 0; i < opt.warmup; ++i) processFrame(frames[static_cast<size_t>(i) % frames.size()]);
+    metrics.reset();
+    detected_frames = 0;
+
+    uint64_t allocs_total = 0;
+    uint64_t allocs_max = 0;
+    const auto bench_start = std::chrono::steady_clock::now();
+    for (int it = 0; it < opt.iterations; ++it) {
+        for (const auto& frame : frames) {
+            const uint64_t before = heapAllocations();
+            processFrame(frame);
+            const uint64_t allocs = heapAllocations() - before;
+            allocs_total += allocs;
+            allocs_max = std::max(allocs_max, allocs);
+        }
+    }
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - bench_start).count();
+    if (scheduler) scheduler->stop();
+
+    const double total_frames = static_cast<double>(frames.size()) * opt.iterations;
+    const double throughput = wall_s > 0.0 ? total_frames / wall_s : 0.0;
+    const long rss_kb = peakRssKb();
+    const double allocs_per_frame = total_frames > 0.0 ? static_cast<double>(allocs_total) / total_frames : 0.0;
+
+    // -------------------------------------------------------------------------
+    // Report (same layout is read back by --baseline)
+    // -------------------------------------------------------------------------
+    cv::FileStorage fs(".json", cv::FileStorage::WRITE | cv::FileStorage::MEMORY | cv::FileStorage::FORMAT_JSON);
+    fs << "input" << opt.input
+       << "mode" << (opt.test_mode ? "test" : "model")
+       << "model_path" << config.model_path
+       << "backend" << (detector ? detector->backendName() : std::string("none"))
+       << "input_size" << cv::format("%dx%d", config.input_width, config.input_height)
+       << "frames" << static_cast<int>(frames.size())
+       << "iterations" << opt.iterations
+       << "detect_every_n_frames" << static_cast<int>(detect_interval)
+       << "motion_gate" << (config.motion.enabled ? 1 : 0)
+       << "detected_frames" << static_cast<double>(detected_frames)
+       << "wall_s" << wall_s
+       << "throughput_fps" << throughput
+       << "peak_rss_kb" << static_cast<double>(rss_kb)
+       << "mat_pool_mb" << std::max(0, config.pipeline.mat_pool_mb)
+       << "allocations_per_frame" << allocs_per_frame
+       << "max_allocations_per_frame" << static_cast<double>(allocs_max);
+    writeStages(fs);
+    const std::string report = fs.releaseAndGetString();
+
+    std::cout << report << std::endl;
+    if (!opt.output_path.empty()) {
+        std::ofstream ofs(opt.output_path, std::ios::trunc);
+        ofs << report;
+        if (!ofs) CCM_LOG_ERROR("Bench", "Cannot write report to %s", opt.output_path.c_str());
+    }
+
+    int exit_code = 0;
+    if (!opt.baseline_path.empty() && !compareWithBaseline(opt.baseline_path, throughput, rss_kb, opt.tolerance)) {
+        exit_code = 2;
+    }
+    if (opt.max_allocs_per_frame >= 0.0 && allocs_per_frame > opt.max_allocs_per_frame) {
+        std::fprintf(stderr, "Allocations per frame: %.2f (max %.2f per frame), budget %.2f: EXCEEDED\n",
+                     allocs_per_frame, static_cast<double>(allocs_max), opt.max_allocs_per_frame);
+        exit_code = 3;
+    }
+
+    logger.stop();
+    return exit_code;
+}
@@ -1,3 +1,349 @@
 #include "camera_input.hpp"
-// This can be expanded later for GStreamer/V4L2 specific pipelines
-// Current implementation handles everything in main.cpp via cv::VideoCapture
\ No newline at end of file
+#include <cerrno>
+#include <cstring>
+#include "logger.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace CCM {
+
+#ifdef __linux__
+// ioctl wrapper that retries when interrupted by a signal (e.g. SIGINT handler)
+static int xioctl(int fd, unsigned long request, void* arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r == -1 && errno == EINTR);
+    return r;
+}
+#endif
+
+CameraInput::CameraInput(const CameraConfig& config) : config_(config) {}
+
+CameraInput::~CameraInput() {
+    close();
+}
+
+std::string CameraInput::devicePath() const {
+    if (!config_.device.empty()) return config_.device;
+    return "/dev/video" + std::to_string(config_.index);
+}
+
+bool CameraInput::open() {
+    close();
+
+    const bool want_v4l2 = config_.backend == "auto" || config_.backend == "v4l2";
+
+    if (want_v4l2 && openV4L2()) {
+        CCM_LOG_INFO("Camera", "V4L2 mmap streaming on %s (%dx%d, %zu buffers)", devicePath().c_str(),
+                     frame_size_.width, frame_size_.height, buffers_.size());
+        return true;
+    }
+
+    if (config_.backend == "v4l2") {
+        CCM_LOG_ERROR("Camera", "V4L2 backend requested but %s could not be opened for streaming.",
+                      devicePath().c_str());
+        return false;
+    }
+
+    if (openFallback()) {
+        CCM_LOG_INFO("Camera", "Using OpenCV VideoCapture backend");
+        return true;
+    }
+    return false;
+}
+
+bool CameraInput::isOpened() const {
+    return use_fallback_ ? cap_.isOpened() : streaming_;
+}
+
+void CameraInput::close() {
+    closeV4L2();
+    if (cap_.isOpened()) cap_.release();
+    use_fallback_ = false;
+}
+
+const char* CameraInput::backendName() const {
+    if (use_fallback_) return "opencv";
+    if (streaming_) return "v4l2";
+    return "none";
+}
+
+CameraInput& CameraInput::operator>>(cv::Mat& bgr) {
+    if (!read(bgr)) bgr.release();
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+// OpenCV fallback
+// -----------------------------------------------------------------------------
+bool CameraInput::openFallback() {
+    // A non-/dev path is treated as a recorded file (fake device for offline testing)
+    if (!config_.device.empty()) {
+        cap_.open(config_.device);
+    } else {
+        cap_.open(config_.index);
+    }
+
+    if (!cap_.isOpened()) return false;
+
+    // Apply Camera Settings
+    if (config_.force_mjpg) {
+        CCM_LOG_INFO("Camera", "Forcing MJPEG compression (WSL/Linux Mode)");
+        cap_.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    }
+    cap_.set(cv::CAP_PROP_FRAME_WIDTH, config_.width);
+    cap_.set(cv::CAP_PROP_FRAME_HEIGHT, config_.height);
+    cap_.set(cv::CAP_PROP_FPS, config_.fps);
+
+    frame_size_ = cv::Size(static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_WIDTH)),
+                           static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    use_fallback_ = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// V4L2 streaming I/O
+// -----------------------------------------------------------------------------
+#ifdef __linux__
+
+bool CameraInput::openV4L2() {
+    const std::string path = devicePath();
+    if (path.compare(0, 5, "/dev/") != 0) return false; // Files go through the fallback
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd_ < 0) return false;
+
+    v4l2_capability cap;
+    std::memset(&cap, 0, sizeof(cap));
+    if (xioctl(fd_, VIDIOC_QUERYCAP, &cap) < 0) {
+        closeV4L2();
+        return false;
+    }
+    const uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        CCM_LOG_WARN("Camera", "%s does not support capture streaming.", path.c_str());
+        closeV4L2();
+        return false;
+    }
+
+    // Negotiate format (driver may adjust width/height)
+    v4l2_format fmt;
+    std::memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = static_cast<uint32_t>(config_.width);
+    fmt.fmt.pix.height = static_cast<uint32_t>(config_.height);
+    fmt.fmt.pix.pixelformat = config_.force_mjpg ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    if (xioctl(fd_, VIDIOC_S_FMT, &fmt) < 0) {
+        closeV4L2();
+        return false;
+    }
+
+    pixel_format_ = fmt.fmt.pix.pixelformat;
+    if (pixel_format_ != V4L2_PIX_FMT_YUYV && pixel_format_ != V4L2_PIX_FMT_MJPEG &&
+        pixel_format_ != V4L2_PIX_FMT_GREY) {
+        CCM_LOG_WARN("Camera", "Unsupported V4L2 pixel format 0x%08x", pixel_format_);
+        closeV4L2();
+        return false;
+    }
+    frame_size_ = cv::Size(static_cast<int>(fmt.fmt.pix.width), static_cast<int>(fmt.fmt.pix.height));
+    bytes_per_line_ = fmt.fmt.pix.bytesperline;
+
+    // Frame rate is best-effort; not every driver supports S_PARM
+    v4l2_streamparm parm;
+    std::memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1;
+    parm.parm.capture.timeperframe.denominator = static_cast<uint32_t>(config_.fps > 0 ? config_.fps : 30);
+    xioctl(fd_, VIDIOC_S_PARM, &parm);
+
+    // Request the mmap ring
+    v4l2_requestbuffers req;
+    std::memset(&req, 0, sizeof(req));
+    req.count = static_cast<uint32_t>(config_.buffer_count > 1 ? config_.buffer_count : 2);
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+        closeV4L2();
+        return false;
+    }
+
+    buffers_.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer buf;
+        std::memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0) {
+            closeV4L2();
+            return false;
+        }
+
+        void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+        if (start == MAP_FAILED) {
+            closeV4L2();
+            return false;
+        }
+        buffers_[i].start = start;
+        buffers_[i].length = buf.length;
+
+        if (xioctl(fd_, VIDIOC_QBUF, &buf) < 0) {
+            closeV4L2();
+            return false;
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+        closeV4L2();
+        return false;
+    }
+
+    streaming_ = true;
+    return true;
+}
+
+void CameraInput::closeV4L2() {
+    if (fd_ < 0) return;
+
+    if (streaming_) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd_, VIDIOC_STREAMOFF, &type);
+        streaming_ = false;
+    }
+    for (auto& b : buffers_) {
+        if (b.start) munmap(b.start, b.length);
+    }
+    buffers_.clear();
+
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool CameraInput::grab(CameraFrame& frame) {
+    if (use_fallback_) {
+        // Fallback path: VideoCapture owns the decode, frame.image is already BGR
+        if (!cap_.read(frame.image) || frame.image.empty()) return false;
+        frame.fourcc = 0;
+        frame.buffer_index = -1;
+        frame.sequence++;
+        return true;
+    }
+    if (!streaming_) return false;
+
+    pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    int r;
+    do {
+        r = poll(&pfd, 1, 1000);
+    } while (r == -1 && errno == EINTR);
+    if (r <= 0) return false; // Timeout or error
+
+    v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(fd_, VIDIOC_DQBUF, &buf) < 0) return false;
+
+    // Empty or corrupted buffers (UVC hiccups): hand the buffer back and report a blank frame
+    if (buf.bytesused == 0 || (buf.flags & V4L2_BUF_FLAG_ERROR)) {
+        CCM_LOG_DEBUG("Camera", "Dropped buffer %u (bytesused=%u, flags=0x%x)", buf.index, buf.bytesused, buf.flags);
+        if (xioctl(fd_, VIDIOC_QBUF, &buf) < 0) {
+            CCM_LOG_WARN("Camera", "Failed to requeue buffer %u", buf.index);
+        }
+        return false;
+    }
+
+    uchar* data = static_cast<uchar*>(buffers_[buf.index].start);
+    switch (pixel_format_) {
+        case V4L2_PIX_FMT_YUYV:
+            frame.image = cv::Mat(frame_size_.height, frame_size_.width, CV_8UC2, data, bytes_per_line_);
+            break;
+        case V4L2_PIX_FMT_GREY:
+            frame.image = cv::Mat(frame_size_.height, frame_size_.width, CV_8UC1, data, bytes_per_line_);
+            break;
+        default: // MJPEG: compressed payload, only `bytesused` bytes are valid
+            frame.image = cv::Mat(1, static_cast<int>(buf.bytesused), CV_8UC1, data);
+            break;
+    }
+    frame.fourcc = pixel_format_;
+    frame.buffer_index = static_cast<int>(buf.index);
+    frame.sequence = buf.sequence;
+    return true;
+}
+
+void CameraInput::release(CameraFrame& frame) {
+    if (frame.buffer_index < 0 || fd_ < 0) return;
+
+    v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = static_cast<uint32_t>(frame.buffer_index);
+    if (xioctl(fd_, VIDIOC_QBUF, &buf) < 0) {
+        CCM_LOG_WARN("Camera", "Failed to requeue buffer %d", frame.buffer_index);
+    }
+
+    frame.image.release(); // Header only, the mapping stays owned by CameraInput
+    frame.buffer_index = -1;
+}
+
+bool CameraInput::read(cv::Mat& bgr) {
+    if (use_fallback_) return cap_.read(bgr) && !bgr.empty();
+
+    CameraFrame frame;
+    if (!grab(frame)) return false;
+
+    // Convert straight out of the mapped buffer; this is the only pass over the pixels
+    bool ok = true;
+    switch (frame.fourcc) {
+        case V4L2_PIX_FMT_YUYV:
+            cv::cvtColor(frame.image, bgr, cv::COLOR_YUV2BGR_YUYV);
+            break;
+        case V4L2_PIX_FMT_GREY:
+            cv::cvtColor(frame.image, bgr, cv::COLOR_GRAY2BGR);
+            break;
+        default:
+            cv::imdecode(frame.image, cv::IMREAD_COLOR, &bgr);
+            ok = !bgr.empty();
+            break;
+    }
+
+    release(frame);
+    return ok;
+}
+
+#else // !__linux__
+
+bool CameraInput::openV4L2() { return false; }
+void CameraInput::closeV4L2() {}
+
+bool CameraInput::grab(CameraFrame& frame) {
+    if (!use_fallback_ || !cap_.read(frame.image) || frame.image.empty()) return false;
+    frame.fourcc = 0;
+    frame.buffer_index = -1;
+    frame.sequence++;
+    return true;
+}
+
+void CameraInput::release(CameraFrame& frame) {
+    frame.image.release();
+}
+
+bool CameraInput::read(cv::Mat& bgr) {
+    return use_fallback_ && cap_.read(bgr) && !bgr.empty();
+}
+
+#endif
+
+} // namespace CCM
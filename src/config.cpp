@@ -1,12 +1,17 @@
 #include "config.hpp"
-#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "logger.hpp"
+#include "zone_index.hpp"
 
 namespace CCM {
 std::string ZoneConfig::toString() const {
     std::ostringstream oss;
     oss << "ZoneConfig { name=\"" << name << "\", rect=("
         << rect.x << "," << rect.y << "," << rect.width << "," << rect.height
-        << ") }";
+        << ")";
+    if (!polygon.empty()) oss << ", polygon=" << polygon.size() << " points";
+    oss << " }";
     return oss.str();
 }
 
@@ -19,7 +24,35 @@ std::string ZoneConfig::toJSON() const {
             << "\"y\":" << rect.y << ","
             << "\"width\":" << rect.width << ","
             << "\"height\":" << rect.height
-        << "}"
+        << "}";
+    if (!polygon.empty()) {
+        oss << ",\"polygon\":[";
+        for (size_t i = 0; i < polygon.size(); i++) {
+            oss << "[" << polygon[i].x << "," << polygon[i].y << "]";
+            if (i + 1 < polygon.size()) oss << ",";
+        }
+        oss << "]";
+    }
+    oss << "}";
+    return oss.str();
+}
+
+std::string LineConfig::toString() const {
+    std::ostringstream oss;
+    oss << "LineConfig { name=\"" << name << "\", a=(" << a.x << "," << a.y
+        << "), b=(" << b.x << "," << b.y
+        << "), trigger_class=" << trigger_class
+        << ", direction=" << direction << " }";
+    return oss.str();
+}
+
+std::string LineConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"name\":\"" << name << "\","
+        << "\"points\":[" << a.x << "," << a.y << "," << b.x << "," << b.y << "],"
+        << "\"trigger_class\":\"" << trigger_class << "\","
+        << "\"direction\":\"" << direction << "\""
         << "}";
     return oss.str();
 }
@@ -31,6 +64,13 @@ std::string CameraConfig::toString() const {
         << ", height=" << height
         << ", fps=" << fps
         << ", force_mjpg=" << (force_mjpg ? "true" : "false")
+        << ", device=" << device
+        << ", backend=" << backend
+        << ", buffer_count=" << buffer_count
+        << ", name=" << name
+        << ", priority=" << priority
+        << ", zones=" << zones.size()
+        << ", lines=" << lines.size()
         << " }";
     return oss.str();
 }
@@ -42,7 +82,23 @@ std::string CameraConfig::toJSON() const {
         << "\"width\":" << width << ","
         << "\"height\":" << height << ","
         << "\"fps\":" << fps << ","
-        << "\"force_mjpg\":" << (force_mjpg ? "true" : "false")
+        << "\"force_mjpg\":" << (force_mjpg ? "true" : "false") << ","
+        << "\"device\":\"" << device << "\","
+        << "\"backend\":\"" << backend << "\","
+        << "\"buffer_count\":" << buffer_count << ","
+        << "\"name\":\"" << name << "\","
+        << "\"priority\":" << priority << ","
+        << "\"zones\":[";
+    for (size_t i = 0; i < zones.size(); i++) {
+        oss << zones[i].toJSON();
+        if (i + 1 < zones.size()) oss << ",";
+    }
+    oss << "],\"lines\":[";
+    for (size_t i = 0; i < lines.size(); i++) {
+        oss << lines[i].toJSON();
+        if (i + 1 < lines.size()) oss << ",";
+    }
+    oss << "]"
         << "}";
     return oss.str();
 }
@@ -52,6 +108,12 @@ std::string ModelConfig::toString() const {
     oss << "ModelConfig { "
         << "input_width=" << input_width
         << ", input_height=" << input_height
+        << ", backend=" << backend
+        << ", intra_op_threads=" << intra_op_threads
+        << ", inter_op_threads=" << inter_op_threads
+        << ", benchmark_runs=" << benchmark_runs
+        << ", precision=" << precision
+        << ", output_layout=" << output_layout
         << " }";
     return oss.str();
 }
@@ -61,6 +123,281 @@ std::string ModelConfig::toJSON() const {
     oss << "{"
         << "\"input_width\":" << input_width << ","
         << "\"input_height\":" << input_height << ","
+        << "\"backend\":\"" << backend << "\","
+        << "\"intra_op_threads\":" << intra_op_threads << ","
+        << "\"inter_op_threads\":" << inter_op_threads << ","
+        << "\"benchmark_runs\":" << benchmark_runs << ","
+        << "\"precision\":\"" << precision << "\","
+        << "\"output_layout\":\"" << output_layout << "\""
+        << "}";
+    return oss.str();
+}
+
+std::string TrackerConfig::toString() const {
+    std::ostringstream oss;
+    oss << "TrackerConfig { mode=" << mode
+        << ", max_lost_frames=" << max_lost_frames
+        << ", dist_threshold=" << dist_threshold
+        << ", iou_threshold=" << iou_threshold
+        << ", grid_cell=" << grid_cell << " }";
+    return oss.str();
+}
+
+std::string TrackerConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"mode\":\"" << mode << "\","
+        << "\"max_lost_frames\":" << max_lost_frames << ","
+        << "\"dist_threshold\":" << dist_threshold << ","
+        << "\"iou_threshold\":" << iou_threshold << ","
+        << "\"grid_cell\":" << grid_cell
+        << "}";
+    return oss.str();
+}
+
+std::string DetectionConfig::toString() const {
+    std::ostringstream oss;
+    oss << "DetectionConfig { every_n_frames=" << every_n_frames
+        << ", adaptive=" << (adaptive ? "true" : "false")
+        << ", adaptive_speed=" << adaptive_speed
+        << ", roi_inference=" << (roi_inference ? "true" : "false")
+        << ", roi_max_tiles=" << roi_max_tiles
+        << ", tile_overlap=" << tile_overlap << " }";
+    return oss.str();
+}
+
+std::string DetectionConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"every_n_frames\":" << every_n_frames << ","
+        << "\"adaptive\":" << (adaptive ? "true" : "false") << ","
+        << "\"adaptive_speed\":" << adaptive_speed << ","
+        << "\"roi_inference\":" << (roi_inference ? "true" : "false") << ","
+        << "\"roi_max_tiles\":" << roi_max_tiles << ","
+        << "\"tile_overlap\":" << tile_overlap
+        << "}";
+    return oss.str();
+}
+
+std::string NmsConfig::toString() const {
+    std::ostringstream oss;
+    oss << "NmsConfig { method=" << method
+        << ", per_class=" << (per_class ? "true" : "false")
+        << ", top_k=" << top_k
+        << ", max_detections=" << max_detections
+        << ", sigma=" << sigma << " }";
+    return oss.str();
+}
+
+std::string NmsConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"method\":\"" << method << "\","
+        << "\"per_class\":" << (per_class ? "true" : "false") << ","
+        << "\"top_k\":" << top_k << ","
+        << "\"max_detections\":" << max_detections << ","
+        << "\"sigma\":" << sigma
+        << "}";
+    return oss.str();
+}
+
+std::string MotionConfig::toString() const {
+    std::ostringstream oss;
+    oss << "MotionConfig { enabled=" << (enabled ? "true" : "false")
+        << ", width=" << width
+        << ", pixel_threshold=" << pixel_threshold
+        << ", min_changed=" << min_changed
+        << ", max_skip_frames=" << max_skip_frames << " }";
+    return oss.str();
+}
+
+std::string MotionConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"enabled\":" << (enabled ? "true" : "false") << ","
+        << "\"width\":" << width << ","
+        << "\"pixel_threshold\":" << pixel_threshold << ","
+        << "\"min_changed\":" << min_changed << ","
+        << "\"max_skip_frames\":" << max_skip_frames
+        << "}";
+    return oss.str();
+}
+
+std::string TilingConfig::toString() const {
+    std::ostringstream oss;
+    oss << "TilingConfig { mode=" << mode
+        << ", tile=" << tile_width << "x" << tile_height
+        << ", overlap=" << overlap
+        << ", full_frame=" << (full_frame ? "true" : "false")
+        << ", merge=" << merge
+        << ", merge_iou=" << merge_iou
+        << ", coarse_threshold=" << coarse_threshold
+        << ", max_tiles=" << max_tiles << " }";
+    return oss.str();
+}
+
+std::string TilingConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"mode\":\"" << mode << "\","
+        << "\"tile_width\":" << tile_width << ","
+        << "\"tile_height\":" << tile_height << ","
+        << "\"overlap\":" << overlap << ","
+        << "\"full_frame\":" << (full_frame ? "true" : "false") << ","
+        << "\"merge\":\"" << merge << "\","
+        << "\"merge_iou\":" << merge_iou << ","
+        << "\"coarse_threshold\":" << coarse_threshold << ","
+        << "\"max_tiles\":" << max_tiles
+        << "}";
+    return oss.str();
+}
+
+std::string PipelineConfig::toString() const {
+    std::ostringstream oss;
+    oss << "PipelineConfig { queue_depth=" << queue_depth
+        << ", backpressure=" << backpressure
+        << ", mat_pool_mb=" << mat_pool_mb << " }";
+    return oss.str();
+}
+
+std::string PipelineConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"queue_depth\":" << queue_depth << ","
+        << "\"backpressure\":\"" << backpressure << "\","
+        << "\"mat_pool_mb\":" << mat_pool_mb
+        << "}";
+    return oss.str();
+}
+
+std::string BatchConfig::toString() const {
+    std::ostringstream oss;
+    oss << "BatchConfig { max_batch=" << max_batch
+        << ", max_wait_ms=" << max_wait_ms
+        << ", policy=" << policy << " }";
+    return oss.str();
+}
+
+std::string BatchConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"max_batch\":" << max_batch << ","
+        << "\"max_wait_ms\":" << max_wait_ms << ","
+        << "\"policy\":\"" << policy << "\""
+        << "}";
+    return oss.str();
+}
+
+std::string OutputConfig::toString() const {
+    std::ostringstream oss;
+    oss << "OutputConfig { display=" << (display ? "true" : "false")
+        << ", mjpeg_port=" << mjpeg_port
+        << ", bind=" << bind
+        << ", jpeg_quality=" << jpeg_quality
+        << ", max_fps=" << max_fps
+        << ", rtsp_url=" << rtsp_url
+        << ", rtsp_bitrate_kbps=" << rtsp_bitrate_kbps
+        << ", ffmpeg=" << ffmpeg << " }";
+    return oss.str();
+}
+
+std::string OutputConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"display\":" << (display ? "true" : "false") << ","
+        << "\"mjpeg_port\":" << mjpeg_port << ","
+        << "\"bind\":\"" << bind << "\","
+        << "\"jpeg_quality\":" << jpeg_quality << ","
+        << "\"max_fps\":" << max_fps << ","
+        << "\"rtsp_url\":\"" << rtsp_url << "\","
+        << "\"rtsp_bitrate_kbps\":" << rtsp_bitrate_kbps << ","
+        << "\"ffmpeg\":\"" << ffmpeg << "\""
+        << "}";
+    return oss.str();
+}
+
+std::string ShmConfig::toString() const {
+    std::ostringstream oss;
+    oss << "ShmConfig { enabled=" << (enabled ? "true" : "false")
+        << ", name=" << name
+        << ", slots=" << slots
+        << ", max_width=" << max_width
+        << ", max_height=" << max_height
+        << ", max_detections=" << max_detections << " }";
+    return oss.str();
+}
+
+std::string ShmConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"enabled\":" << (enabled ? "true" : "false") << ","
+        << "\"name\":\"" << name << "\","
+        << "\"slots\":" << slots << ","
+        << "\"max_width\":" << max_width << ","
+        << "\"max_height\":" << max_height << ","
+        << "\"max_detections\":" << max_detections
+        << "}";
+    return oss.str();
+}
+
+std::string EventsConfig::toString() const {
+    std::ostringstream oss;
+    oss << "EventsConfig { enabled=" << (enabled ? "true" : "false")
+        << ", debounce_frames=" << debounce_frames
+        << ", dwell_s=" << dwell_s
+        << ", line_margin=" << line_margin
+        << ", queue_capacity=" << queue_capacity << " }";
+    return oss.str();
+}
+
+std::string EventsConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"enabled\":" << (enabled ? "true" : "false") << ","
+        << "\"debounce_frames\":" << debounce_frames << ","
+        << "\"dwell_s\":" << dwell_s << ","
+        << "\"line_margin\":" << line_margin << ","
+        << "\"queue_capacity\":" << queue_capacity
+        << "}";
+    return oss.str();
+}
+
+std::string LoggingConfig::toString() const {
+    std::ostringstream oss;
+    oss << "LoggingConfig { level=" << level
+        << ", json=" << (json ? "true" : "false") << " }";
+    return oss.str();
+}
+
+std::string LoggingConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"level\":\"" << level << "\","
+        << "\"json\":" << (json ? "true" : "false")
+        << "}";
+    return oss.str();
+}
+
+std::string MetricsConfig::toString() const {
+    std::ostringstream oss;
+    oss << "MetricsConfig { enabled=" << (enabled ? "true" : "false")
+        << ", http_port=" << http_port
+        << ", bind=" << bind
+        << ", json_path=" << json_path
+        << ", json_interval_s=" << json_interval_s
+        << ", overlay=" << (overlay ? "true" : "false") << " }";
+    return oss.str();
+}
+
+std::string MetricsConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"enabled\":" << (enabled ? "true" : "false") << ","
+        << "\"http_port\":" << http_port << ","
+        << "\"bind\":\"" << bind << "\","
+        << "\"json_path\":\"" << json_path << "\","
+        << "\"json_interval_s\":" << json_interval_s << ","
+        << "\"overlay\":" << (overlay ? "true" : "false")
         << "}";
     return oss.str();
 }
@@ -81,14 +418,115 @@ std::string DebugConfig::toJSON() const {
     return oss.str();
 }
 
+std::string ReloadConfig::toString() const {
+    std::ostringstream oss;
+    oss << "ReloadConfig { enabled=" << (enabled ? "true" : "false")
+        << ", debounce_ms=" << debounce_ms << " }";
+    return oss.str();
+}
+
+std::string ReloadConfig::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"enabled\":" << (enabled ? "true" : "false") << ","
+        << "\"debounce_ms\":" << debounce_ms
+        << "}";
+    return oss.str();
+}
+
+// Shared by the single `camera:` section and each `cameras:` entry
+static void parseCamera(const cv::FileNode& node, CameraConfig& camera) {
+    if (!node["index"].empty()) node["index"] >> camera.index;
+    if (!node["width"].empty()) node["width"] >> camera.width;
+    if (!node["height"].empty()) node["height"] >> camera.height;
+    if (!node["fps"].empty()) node["fps"] >> camera.fps;
+    if (!node["force_mjpg"].empty()) node["force_mjpg"] >> camera.force_mjpg;
+    if (!node["device"].empty()) node["device"] >> camera.device;
+    if (!node["backend"].empty()) node["backend"] >> camera.backend;
+    if (!node["buffer_count"].empty()) node["buffer_count"] >> camera.buffer_count;
+    if (!node["name"].empty()) node["name"] >> camera.name;
+    if (!node["priority"].empty()) node["priority"] >> camera.priority;
+}
+
+static void parseZones(const cv::FileNode& zones_node, std::vector<ZoneConfig>& zones) {
+    for (auto it = zones_node.begin(); it != zones_node.end(); ++it) {
+        ZoneConfig z;
+        (*it)["name"] >> z.name;
+        std::vector<int> r;
+        (*it)["rect"] >> r;
+        if (r.size() == 4) z.rect = cv::Rect(r[0], r[1], r[2], r[3]);
+        // polygon: [x1, y1, x2, y2, ...] (at least 3 points); replaces rect
+        std::vector<int> p;
+        if (!(*it)["polygon"].empty()) (*it)["polygon"] >> p;
+        if (p.size() >= 6) {
+            for (size_t k = 0; k + 1 < p.size(); k += 2) z.polygon.emplace_back(p[k], p[k + 1]);
+            z.rect = cv::boundingRect(z.polygon);
+        } else if (!p.empty()) {
+            CCM_LOG_WARN("Config", "Zone '%s': polygon needs at least 3 points, using rect", z.name.c_str());
+        }
+        std::vector<int> c;
+        (*it)["color"] >> c;
+        if (c.size() == 3) z.color = cv::Scalar(c[0], c[1], c[2]);
+        (*it)["trigger_class"] >> z.trigger_class;
+        zones.push_back(z);
+    }
+}
+
+static void parseLines(const cv::FileNode& lines_node, std::vector<LineConfig>& lines) {
+    for (auto it = lines_node.begin(); it != lines_node.end(); ++it) {
+        LineConfig l;
+        (*it)["name"] >> l.name;
+        std::vector<int> p;
+        (*it)["points"] >> p;
+        if (p.size() != 4) {
+            CCM_LOG_WARN("Config", "Line '%s': points must be [x1, y1, x2, y2], skipped", l.name.c_str());
+            continue;
+        }
+        l.a = cv::Point(p[0], p[1]);
+        l.b = cv::Point(p[2], p[3]);
+        std::vector<int> c;
+        (*it)["color"] >> c;
+        l.color = c.size() == 3 ? cv::Scalar(c[0], c[1], c[2]) : cv::Scalar(255, 0, 255);
+        if (!(*it)["trigger_class"].empty()) (*it)["trigger_class"] >> l.trigger_class;
+        if (!(*it)["direction"].empty()) (*it)["direction"] >> l.direction;
+        lines.push_back(l);
+    }
+}
+
+static void parseNameList(const cv::FileNode& search_node, std::vector<std::string>& names) {
+    // Check if it's a sequence (list) or a single item
+    if (search_node.type() == cv::FileNode::SEQ) {
+        search_node >> names;
+    }
+    // Fallback: If user accidentally types a single string without brackets
+    else if (search_node.type() == cv::FileNode::STRING) {
+        std::string z;
+        search_node >> z;
+        names.push_back(z);
+    }
+}
+
 AppConfig AppConfig::load(const std::string& filepath) {
     AppConfig config;
-    cv::FileStorage fs(filepath, cv::FileStorage::READ);
-    
-    if (!fs.isOpened()) {
-        std::cerr << "[Config] Warning: Could not open " << filepath << ". Using defaults." << std::endl;
-        return config; 
+    if (!load(filepath, config)) {
+        CCM_LOG_WARN("Config", "Could not load %s. Using defaults.", filepath.c_str());
+        AppConfig defaults;
+        defaults.normalizeCameras();
+        defaults.buildZoneIndex();
+        return defaults;
     }
+    return config;
+}
+
+bool AppConfig::load(const std::string& filepath, AppConfig& config) {
+    cv::FileStorage fs;
+    try {
+        fs.open(filepath, cv::FileStorage::READ);
+    } catch (const cv::Exception& e) {
+        CCM_LOG_ERROR("Config", "%s: %s", filepath.c_str(), e.what());
+        return false;
+    }
+    if (!fs.isOpened()) return false;
 
     // AI Settings
     if (!fs["model_path"].empty()) fs["model_path"] >> config.model_path;
@@ -100,6 +538,7 @@ AppConfig AppConfig::load(const std::string& filepath) {
         if (!model_node["input_width"].empty()) model_node["input_width"] >> config.input_width;
         if (!model_node["input_height"].empty()) model_node["input_height"] >> config.input_height;
         if (!model_node["swap_rb"].empty()) model_node["swap_rb"] >> config.swap_rb;
+        if (!model_node["letterbox"].empty()) model_node["letterbox"] >> config.letterbox;
     }
 
     cv::FileNode yolo_node = fs["model"];
@@ -108,6 +547,12 @@ AppConfig AppConfig::load(const std::string& filepath) {
             yolo_node["input_width"] >> config.model.input_width;
         if (!yolo_node["input_height"].empty())
             yolo_node["input_height"] >> config.model.input_height;
+        if (!yolo_node["backend"].empty()) yolo_node["backend"] >> config.model.backend;
+        if (!yolo_node["intra_op_threads"].empty()) yolo_node["intra_op_threads"] >> config.model.intra_op_threads;
+        if (!yolo_node["inter_op_threads"].empty()) yolo_node["inter_op_threads"] >> config.model.inter_op_threads;
+        if (!yolo_node["benchmark_runs"].empty()) yolo_node["benchmark_runs"] >> config.model.benchmark_runs;
+        if (!yolo_node["precision"].empty()) yolo_node["precision"] >> config.model.precision;
+        if (!yolo_node["output_layout"].empty()) yolo_node["output_layout"] >> config.model.output_layout;
     }
 
     // AI Settings
@@ -118,44 +563,155 @@ AppConfig AppConfig::load(const std::string& filepath) {
 
     // Camera Settings
     cv::FileNode cam_node = fs["camera"];
-    if (!cam_node.empty()) {
-        if (!cam_node["index"].empty()) cam_node["index"] >> config.camera.index;
-        if (!cam_node["width"].empty()) cam_node["width"] >> config.camera.width;
-        if (!cam_node["height"].empty()) cam_node["height"] >> config.camera.height;
-        if (!cam_node["fps"].empty()) cam_node["fps"] >> config.camera.fps;
-        if (!cam_node["force_mjpg"].empty()) cam_node["force_mjpg"] >> config.camera.force_mjpg;
+    if (!cam_node.empty()) parseCamera(cam_node, config.camera);
+
+    // Multi-camera: each entry starts from the `camera:` settings and overrides what it lists
+    cv::FileNode cameras_node = fs["cameras"];
+    if (cameras_node.type() == cv::FileNode::SEQ) {
+        for (auto it = cameras_node.begin(); it != cameras_node.end(); ++it) {
+            CameraConfig cam = config.camera;
+            cam.name.clear();
+            parseCamera(*it, cam);
+            if (!(*it)["zones"].empty()) parseZones((*it)["zones"], cam.zones);
+            if (!(*it)["active_search_zones"].empty()) parseNameList((*it)["active_search_zones"], cam.active_search_zones);
+            if (!(*it)["lines"].empty()) parseLines((*it)["lines"], cam.lines);
+            config.cameras.push_back(cam);
+        }
+    }
+    config.normalizeCameras();
+
+    // Tracker Settings
+    cv::FileNode tracker_node = fs["tracker"];
+    if (!tracker_node.empty()) {
+        if (!tracker_node["mode"].empty()) tracker_node["mode"] >> config.tracker.mode;
+        if (!tracker_node["max_lost_frames"].empty()) tracker_node["max_lost_frames"] >> config.tracker.max_lost_frames;
+        if (!tracker_node["dist_threshold"].empty()) tracker_node["dist_threshold"] >> config.tracker.dist_threshold;
+        if (!tracker_node["iou_threshold"].empty()) tracker_node["iou_threshold"] >> config.tracker.iou_threshold;
+        if (!tracker_node["grid_cell"].empty()) tracker_node["grid_cell"] >> config.tracker.grid_cell;
+    }
+
+    // Detection Scheduling
+    cv::FileNode detection_node = fs["detection"];
+    if (!detection_node.empty()) {
+        if (!detection_node["every_n_frames"].empty()) detection_node["every_n_frames"] >> config.detection.every_n_frames;
+        if (!detection_node["adaptive"].empty()) detection_node["adaptive"] >> config.detection.adaptive;
+        if (!detection_node["adaptive_speed"].empty()) detection_node["adaptive_speed"] >> config.detection.adaptive_speed;
+        if (!detection_node["roi_inference"].empty()) detection_node["roi_inference"] >> config.detection.roi_inference;
+        if (!detection_node["roi_max_tiles"].empty()) detection_node["roi_max_tiles"] >> config.detection.roi_max_tiles;
+        if (!detection_node["tile_overlap"].empty()) detection_node["tile_overlap"] >> config.detection.tile_overlap;
+    }
+
+    // Non-Maximum Suppression
+    cv::FileNode nms_node = fs["nms"];
+    if (!nms_node.empty()) {
+        if (!nms_node["method"].empty()) nms_node["method"] >> config.nms.method;
+        if (!nms_node["per_class"].empty()) nms_node["per_class"] >> config.nms.per_class;
+        if (!nms_node["top_k"].empty()) nms_node["top_k"] >> config.nms.top_k;
+        if (!nms_node["max_detections"].empty()) nms_node["max_detections"] >> config.nms.max_detections;
+        if (!nms_node["sigma"].empty()) nms_node["sigma"] >> config.nms.sigma;
+    }
+
+    // Motion Gate
+    cv::FileNode motion_node = fs["motion"];
+    if (!motion_node.empty()) {
+        if (!motion_node["enabled"].empty()) motion_node["enabled"] >> config.motion.enabled;
+        if (!motion_node["width"].empty()) motion_node["width"] >> config.motion.width;
+        if (!motion_node["pixel_threshold"].empty()) motion_node["pixel_threshold"] >> config.motion.pixel_threshold;
+        if (!motion_node["min_changed"].empty()) motion_node["min_changed"] >> config.motion.min_changed;
+        if (!motion_node["max_skip_frames"].empty()) motion_node["max_skip_frames"] >> config.motion.max_skip_frames;
+    }
+
+    // Tiled Inference
+    cv::FileNode tiling_node = fs["tiling"];
+    if (!tiling_node.empty()) {
+        if (!tiling_node["mode"].empty()) tiling_node["mode"] >> config.tiling.mode;
+        if (!tiling_node["tile_width"].empty()) tiling_node["tile_width"] >> config.tiling.tile_width;
+        if (!tiling_node["tile_height"].empty()) tiling_node["tile_height"] >> config.tiling.tile_height;
+        if (!tiling_node["overlap"].empty()) tiling_node["overlap"] >> config.tiling.overlap;
+        if (!tiling_node["full_frame"].empty()) tiling_node["full_frame"] >> config.tiling.full_frame;
+        if (!tiling_node["merge"].empty()) tiling_node["merge"] >> config.tiling.merge;
+        if (!tiling_node["merge_iou"].empty()) tiling_node["merge_iou"] >> config.tiling.merge_iou;
+        if (!tiling_node["coarse_threshold"].empty()) tiling_node["coarse_threshold"] >> config.tiling.coarse_threshold;
+        if (!tiling_node["max_tiles"].empty()) tiling_node["max_tiles"] >> config.tiling.max_tiles;
+    }
+
+    // Pipeline Settings
+    cv::FileNode pipe_node = fs["pipeline"];
+    if (!pipe_node.empty()) {
+        if (!pipe_node["queue_depth"].empty()) pipe_node["queue_depth"] >> config.pipeline.queue_depth;
+        if (!pipe_node["backpressure"].empty()) pipe_node["backpressure"] >> config.pipeline.backpressure;
+        if (!pipe_node["mat_pool_mb"].empty()) pipe_node["mat_pool_mb"] >> config.pipeline.mat_pool_mb;
+    }
+
+    // Batching Settings
+    cv::FileNode batch_node = fs["batching"];
+    if (!batch_node.empty()) {
+        if (!batch_node["max_batch"].empty()) batch_node["max_batch"] >> config.batching.max_batch;
+        if (!batch_node["max_wait_ms"].empty()) batch_node["max_wait_ms"] >> config.batching.max_wait_ms;
+        if (!batch_node["policy"].empty()) batch_node["policy"] >> config.batching.policy;
+    }
+
+    // Output Sinks
+    cv::FileNode output_node = fs["output"];
+    if (!output_node.empty()) {
+        if (!output_node["display"].empty()) output_node["display"] >> config.output.display;
+        if (!output_node["mjpeg_port"].empty()) output_node["mjpeg_port"] >> config.output.mjpeg_port;
+        if (!output_node["bind"].empty()) output_node["bind"] >> config.output.bind;
+        if (!output_node["jpeg_quality"].empty()) output_node["jpeg_quality"] >> config.output.jpeg_quality;
+        if (!output_node["max_fps"].empty()) output_node["max_fps"] >> config.output.max_fps;
+        if (!output_node["rtsp_url"].empty()) output_node["rtsp_url"] >> config.output.rtsp_url;
+        if (!output_node["rtsp_bitrate_kbps"].empty()) output_node["rtsp_bitrate_kbps"] >> config.output.rtsp_bitrate_kbps;
+        if (!output_node["ffmpeg"].empty()) output_node["ffmpeg"] >> config.output.ffmpeg;
+    }
+
+    // Shared-Memory Bus
+    cv::FileNode shm_node = fs["shm"];
+    if (!shm_node.empty()) {
+        if (!shm_node["enabled"].empty()) shm_node["enabled"] >> config.shm.enabled;
+        if (!shm_node["name"].empty()) shm_node["name"] >> config.shm.name;
+        if (!shm_node["slots"].empty()) shm_node["slots"] >> config.shm.slots;
+        if (!shm_node["max_width"].empty()) shm_node["max_width"] >> config.shm.max_width;
+        if (!shm_node["max_height"].empty()) shm_node["max_height"] >> config.shm.max_height;
+        if (!shm_node["max_detections"].empty()) shm_node["max_detections"] >> config.shm.max_detections;
     }
 
     // Zones
     cv::FileNode zones_node = fs["zones"];
-    if (!zones_node.empty()) {
-        for (auto it = zones_node.begin(); it != zones_node.end(); ++it) {
-            ZoneConfig z;
-            (*it)["name"] >> z.name;
-            std::vector<int> r;
-            (*it)["rect"] >> r;
-            if (r.size() == 4) z.rect = cv::Rect(r[0], r[1], r[2], r[3]);
-            std::vector<int> c;
-            (*it)["color"] >> c;
-            if (c.size() == 3) z.color = cv::Scalar(c[0], c[1], c[2]);
-            (*it)["trigger_class"] >> z.trigger_class;
-            config.zones.push_back(z);
-        }
-    }
+    if (!zones_node.empty()) parseZones(zones_node, config.zones);
     
     // Load Active Search Zones (List)
-    if (!fs["active_search_zones"].empty()) {
-        cv::FileNode search_node = fs["active_search_zones"];
-        // Check if it's a sequence (list) or a single item
-        if (search_node.type() == cv::FileNode::SEQ) {
-            search_node >> config.active_search_zones;
-        } 
-        // Fallback: If user accidentally types a single string without brackets
-        else if (search_node.type() == cv::FileNode::STRING) {
-            std::string z;
-            search_node >> z;
-            config.active_search_zones.push_back(z);
-        }
+    if (!fs["active_search_zones"].empty()) parseNameList(fs["active_search_zones"], config.active_search_zones);
+
+    // Counting Lines
+    cv::FileNode lines_node = fs["lines"];
+    if (!lines_node.empty()) parseLines(lines_node, config.lines);
+
+    // Zone Events
+    cv::FileNode events_node = fs["events"];
+    if (!events_node.empty()) {
+        if (!events_node["enabled"].empty()) events_node["enabled"] >> config.events.enabled;
+        if (!events_node["debounce_frames"].empty()) events_node["debounce_frames"] >> config.events.debounce_frames;
+        if (!events_node["dwell_s"].empty()) events_node["dwell_s"] >> config.events.dwell_s;
+        if (!events_node["line_margin"].empty()) events_node["line_margin"] >> config.events.line_margin;
+        if (!events_node["queue_capacity"].empty()) events_node["queue_capacity"] >> config.events.queue_capacity;
+    }
+
+    // Logging Settings
+    cv::FileNode log_node = fs["logging"];
+    if (!log_node.empty()) {
+        if (!log_node["level"].empty()) log_node["level"] >> config.logging.level;
+        if (!log_node["json"].empty()) log_node["json"] >> config.logging.json;
+    }
+
+    // Metrics Settings
+    cv::FileNode metrics_node = fs["metrics"];
+    if (!metrics_node.empty()) {
+        if (!metrics_node["enabled"].empty()) metrics_node["enabled"] >> config.metrics.enabled;
+        if (!metrics_node["http_port"].empty()) metrics_node["http_port"] >> config.metrics.http_port;
+        if (!metrics_node["bind"].empty()) metrics_node["bind"] >> config.metrics.bind;
+        if (!metrics_node["json_path"].empty()) metrics_node["json_path"] >> config.metrics.json_path;
+        if (!metrics_node["json_interval_s"].empty()) metrics_node["json_interval_s"] >> config.metrics.json_interval_s;
+        if (!metrics_node["overlay"].empty()) metrics_node["overlay"] >> config.metrics.overlay;
     }
 
     // Parse Debug Settings
@@ -164,14 +720,90 @@ AppConfig AppConfig::load(const std::string& filepath) {
         if (!debug_node["enabled"].empty()) debug_node["enabled"] >> config.debug.enabled;
         if (!debug_node["threshold"].empty()) debug_node["threshold"] >> config.debug.threshold;
     }
+
+    // Hot Reload
+    cv::FileNode reload_node = fs["reload"];
+    if (!reload_node.empty()) {
+        if (!reload_node["enabled"].empty()) reload_node["enabled"] >> config.reload.enabled;
+        if (!reload_node["debounce_ms"].empty()) reload_node["debounce_ms"] >> config.reload.debounce_ms;
+    }
     
     // Log that we loaded it
     if (config.debug.enabled) {
-        std::cout << "[Config] Debugging ENABLED (Threshold: " << config.debug.threshold << ")" << std::endl;
+        CCM_LOG_INFO("Config", "Debugging ENABLED (Threshold: %.2f)", config.debug.threshold);
     }
     
-    std::cout << "[Config] Loaded settings from " << filepath << std::endl;
-    return config;
+    config.buildZoneIndex();
+
+    CCM_LOG_INFO("Config", "Loaded settings from %s", filepath.c_str());
+    return true;
+}
+
+bool AppConfig::validate() const {
+    bool ok = true;
+    auto fail = [&ok](const char* what) {
+        CCM_LOG_ERROR("Config", "Invalid setting: %s", what);
+        ok = false;
+    };
+    if (!(confidence_threshold >= 0.0f && confidence_threshold <= 1.0f)) fail("confidence_threshold must be in [0, 1]");
+    if (!(nms_threshold >= 0.0f && nms_threshold <= 1.0f)) fail("nms_threshold must be in [0, 1]");
+    if (input_width <= 0 || input_height <= 0) fail("model_parameters input size must be positive");
+    if (cameras.empty()) fail("no camera configured");
+    for (const auto& cam : cameras) {
+        if (cam.width <= 0 || cam.height <= 0) fail("camera width / height must be positive");
+    }
+    for (const auto& zone : zones) {
+        if (zone.rect.area() <= 0) fail("zone with an empty rect / polygon");
+    }
+    if (tracker.max_lost_frames < 0 || tracker.dist_threshold <= 0.0f) fail("tracker thresholds out of range");
+    if (detection.every_n_frames < 1) fail("detection.every_n_frames must be >= 1");
+    if (model.output_layout != "auto" && model.output_layout != "yolov5" && model.output_layout != "yolov8" &&
+        model.output_layout != "yolov8_transposed") {
+        fail("model.output_layout must be auto, yolov5, yolov8 or yolov8_transposed");
+    }
+    if (nms.method != "greedy" && nms.method != "soft" && nms.method != "matrix") {
+        fail("nms.method must be greedy, soft or matrix");
+    }
+    if (nms.sigma <= 0.0f) fail("nms.sigma must be positive");
+    if (motion.max_skip_frames < 1) fail("motion.max_skip_frames must be >= 1");
+    if (events.debounce_frames < 1 || events.debounce_frames > 255) fail("events.debounce_frames must be in [1, 255]");
+    if (pipeline.mat_pool_mb < 0) fail("pipeline.mat_pool_mb must be >= 0");
+    if (tiling.mode != "off" && tiling.mode != "grid" && tiling.mode != "adaptive") {
+        fail("tiling.mode must be off, grid or adaptive");
+    }
+    if (tiling.merge != "nms" && tiling.merge != "wbf") fail("tiling.merge must be nms or wbf");
+    if (tiling.max_tiles < 1) fail("tiling.max_tiles must be >= 1");
+    return ok;
+}
+
+AppConfig AppConfig::forStream(size_t index) const {
+    AppConfig stream = *this;
+    if (index >= cameras.size()) return stream;
+    stream.camera = cameras[index];
+    if (!stream.camera.zones.empty()) stream.zones = stream.camera.zones;
+    if (!stream.camera.active_search_zones.empty()) stream.active_search_zones = stream.camera.active_search_zones;
+    if (!stream.camera.lines.empty()) stream.lines = stream.camera.lines;
+    stream.buildZoneIndex();
+    return stream;
+}
+
+void AppConfig::normalizeCameras() {
+    if (cameras.empty()) cameras.push_back(camera);
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        if (cameras[i].name.empty()) cameras[i].name = "cam" + std::to_string(i);
+    }
+    camera = cameras.front();
+}
+
+void AppConfig::buildZoneIndex() {
+    // Same list (and default) the Detector loads, so trigger class ids match Detection::class_id
+    std::vector<std::string> classes;
+    std::ifstream ifs(class_names.empty() ? "models/coco.names" : class_names);
+    for (std::string line; std::getline(ifs, line);) classes.push_back(line);
+    if (classes.empty() && (!zones.empty() || !lines.empty())) {
+        CCM_LOG_WARN("Config", "Class list '%s' not readable: zone alerts are disabled", class_names.c_str());
+    }
+    zone_index = std::make_shared<const ZoneIndex>(zones, lines, active_search_zones, classes);
 }
 
 std::string AppConfig::toString() const {
@@ -185,13 +817,32 @@ std::string AppConfig::toString() const {
         << "  " << "\"input_width\":" << input_width << "," << "\n"
         << "  " << "\"input_height\":" << input_height << "," << "\n"
         << "  " << "\"swap_rb\":" << (swap_rb ? "true" : "false") << "," << "\n"
+        << "  " << "\"letterbox\":" << (letterbox ? "true" : "false") << "," << "\n"
         << "  " << model.toString() << "\n"
-        << "  " << camera.toString() << "\n"
+        << "  Cameras (" << cameras.size() << "):\n";
+    for (const auto& c : cameras)
+        oss << "    - " << c.toString() << "\n";
+    oss << "  " << tracker.toString() << "\n"
+        << "  " << detection.toString() << "\n"
+        << "  " << nms.toString() << "\n"
+        << "  " << motion.toString() << "\n"
+        << "  " << tiling.toString() << "\n"
+        << "  " << pipeline.toString() << "\n"
+        << "  " << batching.toString() << "\n"
+        << "  " << output.toString() << "\n"
+        << "  " << shm.toString() << "\n"
+        << "  " << events.toString() << "\n"
+        << "  " << logging.toString() << "\n"
+        << "  " << metrics.toString() << "\n"
         << "  " << debug.toString() << "\n"
+        << "  " << reload.toString() << "\n"
         << "  Zones (" << zones.size() << "):\n";
 
     for (const auto& z : zones)
         oss << "    - " << z.toString() << "\n";
+    oss << "  Lines (" << lines.size() << "):\n";
+    for (const auto& l : lines)
+        oss << "    - " << l.toString() << "\n";
 
     return oss.str();
 }
@@ -207,14 +858,39 @@ std::string AppConfig::toJSON() const {
         << "\"input_width\":" << input_width << ","
         << "\"input_height\":" << input_height << ","
         << "\"swap_rb\":" << (swap_rb ? "true" : "false") << ","
+        << "\"letterbox\":" << (letterbox ? "true" : "false") << ","
         << "\"model\":" << model.toJSON() << ","
         << "\"camera\":" << camera.toJSON() << ","
+        << "\"cameras\":[";
+    for (size_t i = 0; i < cameras.size(); i++) {
+        oss << cameras[i].toJSON();
+        if (i + 1 < cameras.size()) oss << ",";
+    }
+    oss << "],"
+        << "\"tracker\":" << tracker.toJSON() << ","
+        << "\"detection\":" << detection.toJSON() << ","
+        << "\"nms\":" << nms.toJSON() << ","
+        << "\"motion\":" << motion.toJSON() << ","
+        << "\"tiling\":" << tiling.toJSON() << ","
+        << "\"pipeline\":" << pipeline.toJSON() << ","
+        << "\"batching\":" << batching.toJSON() << ","
+        << "\"output\":" << output.toJSON() << ","
+        << "\"shm\":" << shm.toJSON() << ","
+        << "\"events\":" << events.toJSON() << ","
+        << "\"logging\":" << logging.toJSON() << ","
+        << "\"metrics\":" << metrics.toJSON() << ","
         << "\"debug\":" << debug.toJSON() << ","
+        << "\"reload\":" << reload.toJSON() << ","
         << "\"zones\":[";
     for (size_t i = 0; i < zones.size(); i++) {
         oss << zones[i].toJSON();
         if (i + 1 < zones.size()) oss << ",";
     }
+    oss << "],\"lines\":[";
+    for (size_t i = 0; i < lines.size(); i++) {
+        oss << lines[i].toJSON();
+        if (i + 1 < lines.size()) oss << ",";
+    }
     oss << "]}";
     return oss.str();
 }
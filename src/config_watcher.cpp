@@ -0,0 +1,188 @@
+#include "config_watcher.hpp"
+#include <chrono>
+#include "logger.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace CCM {
+
+// Camera settings a pipeline reads once at startup: everything but its zones and lines
+static CameraConfig startupPart(CameraConfig camera) {
+    camera.zones.clear();
+    camera.active_search_zones.clear();
+    camera.lines.clear();
+    return camera;
+}
+
+ConfigChanges diffConfig(const AppConfig& before, const AppConfig& after) {
+    ConfigChanges changes;
+    changes.any = before.toJSON() != after.toJSON();
+    if (!changes.any) return changes;
+
+    changes.model = before.model_path != after.model_path || before.class_names != after.class_names ||
+                    before.input_width != after.input_width || before.input_height != after.input_height ||
+                    before.model.toJSON() != after.model.toJSON();
+
+    bool cameras_changed = before.cameras.size() != after.cameras.size() ||
+                           startupPart(before.camera).toJSON() != startupPart(after.camera).toJSON();
+    for (size_t i = 0; !cameras_changed && i < before.cameras.size(); ++i) {
+        cameras_changed = startupPart(before.cameras[i]).toJSON() != startupPart(after.cameras[i]).toJSON();
+    }
+    if (cameras_changed) changes.restart.push_back("cameras");
+    if (before.pipeline.toJSON() != after.pipeline.toJSON()) changes.restart.push_back("pipeline");
+    if (before.batching.toJSON() != after.batching.toJSON()) changes.restart.push_back("batching");
+    if (before.output.toJSON() != after.output.toJSON()) changes.restart.push_back("output");
+    if (before.shm.toJSON() != after.shm.toJSON()) changes.restart.push_back("shm");
+    if (before.metrics.toJSON() != after.metrics.toJSON()) changes.restart.push_back("metrics");
+    if (before.events.enabled != after.events.enabled || before.events.queue_capacity != after.events.queue_capacity) {
+        changes.restart.push_back("events.enabled/queue_capacity");
+    }
+    if (before.reload.toJSON() != after.reload.toJSON()) changes.restart.push_back("reload");
+    return changes;
+}
+
+void keepStartupSettings(const AppConfig& running, AppConfig& next) {
+    if (next.cameras.size() == running.cameras.size()) {
+        for (size_t i = 0; i < next.cameras.size(); ++i) {
+            CameraConfig camera = running.cameras[i];
+            camera.zones = next.cameras[i].zones;
+            camera.active_search_zones = next.cameras[i].active_search_zones;
+            camera.lines = next.cameras[i].lines;
+            next.cameras[i] = camera;
+        }
+    } else {
+        next.cameras = running.cameras;
+    }
+    CameraConfig camera = running.camera;
+    camera.zones = next.camera.zones;
+    camera.active_search_zones = next.camera.active_search_zones;
+    camera.lines = next.camera.lines;
+    next.camera = camera;
+
+    next.pipeline = running.pipeline;
+    next.batching = running.batching;
+    next.output = running.output;
+    next.shm = running.shm;
+    next.metrics = running.metrics;
+    next.events.enabled = running.events.enabled;
+    next.events.queue_capacity = running.events.queue_capacity;
+    next.reload = running.reload;
+}
+
+ConfigWatcher::ConfigWatcher(const std::string& path, int debounce_ms, Callback on_change)
+    : path_(path), debounce_ms_(debounce_ms > 0 ? debounce_ms : 0), on_change_(std::move(on_change)) {
+    const size_t slash = path_.find_last_of("/\\");
+    dir_ = slash == std::string::npos ? "." : path_.substr(0, slash + 1);
+    file_ = slash == std::string::npos ? path_ : path_.substr(slash + 1);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+#ifdef __linux__
+
+bool ConfigWatcher::start() {
+    if (running_) return true;
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0 ||
+        inotify_add_watch(inotify_fd_, dir_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        CCM_LOG_WARN("Config", "Cannot watch %s (%s): hot reload disabled", dir_.c_str(), std::strerror(errno));
+        if (inotify_fd_ >= 0) ::close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+    running_ = true;
+    thread_ = std::thread(&ConfigWatcher::watchLoop, this);
+    CCM_LOG_INFO("Config", "Watching %s for changes", path_.c_str());
+    return true;
+}
+
+void ConfigWatcher::watchLoop() {
+    alignas(inotify_event) char buffer[4096];
+    bool pending = false;
+    auto last_write = std::chrono::steady_clock::now();
+
+    while (running_) {
+        // Short timeout so stop() is noticed; while a write is pending, wake when it goes quiet
+        pollfd pfd = {inotify_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, pending ? debounce_ms_ : 250) > 0) {
+            ssize_t len;
+            while ((len = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + len;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                    if (event->len > 0 && file_ == event->name) {
+                        pending = true;
+                        last_write = std::chrono::steady_clock::now();
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+        if (pending && std::chrono::steady_clock::now() - last_write >= std::chrono::milliseconds(debounce_ms_)) {
+            pending = false;
+            reload();
+        }
+    }
+}
+
+void ConfigWatcher::stop() {
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    if (inotify_fd_ >= 0) ::close(inotify_fd_);
+    inotify_fd_ = -1;
+}
+
+#else
+
+// No inotify: poll the modification time
+static long long modificationTime(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<long long>(st.st_mtime) : 0;
+}
+
+bool ConfigWatcher::start() {
+    if (running_) return true;
+    running_ = true;
+    thread_ = std::thread(&ConfigWatcher::watchLoop, this);
+    CCM_LOG_INFO("Config", "Watching %s for changes (polling)", path_.c_str());
+    return true;
+}
+
+void ConfigWatcher::watchLoop() {
+    long long seen = modificationTime(path_);
+    while (running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        const long long mtime = modificationTime(path_);
+        if (mtime == 0 || mtime == seen) continue;
+        seen = mtime;
+        std::this_thread::sleep_for(std::chrono::milliseconds(debounce_ms_));
+        reload();
+    }
+}
+
+void ConfigWatcher::stop() {
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+}
+
+#endif
+
+void ConfigWatcher::reload() {
+    AppConfig config;
+    if (!AppConfig::load(path_, config) || !config.validate()) {
+        CCM_LOG_WARN("Config", "%s not applied: keeping the running configuration", path_.c_str());
+        return;
+    }
+    on_change_(std::move(config));
+}
+
+} // namespace CCM
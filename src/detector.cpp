@@ -1,317 +1,543 @@
 #include "detector.hpp"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
-#include <iostream>
+#include "logger.hpp"
+#include "metrics.hpp"
+#include "tiling.hpp"
+#include "zone_index.hpp"
 
 namespace CCM {
 
-Detector::Detector(const std::string& model_path, const std::string& classes_path) {
+static std::vector<std::string> loadClasses(const std::string& classes_path) {
+    std::vector<std::string> classes;
     std::ifstream ifs(classes_path);
     std::string line;
-    while (std::getline(ifs, line)) classes_.push_back(line);
+    while (std::getline(ifs, line)) classes.push_back(line);
+    return classes;
+}
+
+static std::unique_ptr<InferenceBackend> loadModel(const std::string& model_path, const AppConfig& config) {
+    const std::string path = modelPathForPrecision(model_path, config.model.precision);
+    CCM_LOG_INFO("Detector", "Loading model: %s (backend: %s, precision: %s)", path.c_str(),
+                 config.model.backend.c_str(), config.model.precision.c_str());
+    return selectBackend(path, config.model, cv::Size(config.input_width, config.input_height));
+}
 
-    std::cout << "[Detector] Loading model: " << model_path << std::endl;
-    net_ = cv::dnn::readNet(model_path);
-    
-    net_.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
-    net_.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
+Detector::Detector(const std::string& model_path, const std::string& classes_path, const AppConfig& config)
+    : backend_(loadModel(model_path, config)), classes_(loadClasses(classes_path)) {}
+
+bool Detector::reload(const std::string& model_path, const std::string& classes_path, const AppConfig& config) {
+    std::unique_ptr<InferenceBackend> backend = loadModel(model_path, config);
+    if (!backend) {
+        CCM_LOG_ERROR("Detector", "Reload failed: no inference backend could load %s", model_path.c_str());
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    next_backend_ = std::move(backend);
+    next_classes_ = loadClasses(classes_path);
+    reload_pending_.store(true, std::memory_order_release);
+    return true;
+}
+
+void Detector::applyReload() {
+    std::unique_ptr<InferenceBackend> old;
+    {
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        old = std::move(backend_);
+        backend_ = std::move(next_backend_);
+        classes_.swap(next_classes_);
+        next_classes_.clear();
+        reload_pending_.store(false, std::memory_order_relaxed);
+    }
+    batch_supported_ = true;   // Re-probed on the next batch
+    outputs_.clear();          // May be views into the old backend's tensors
+    CCM_LOG_INFO("Detector", "Switched to the reloaded model (%s)", backend_->name().c_str());
 }
 
 std::vector<Detection> Detector::detect(const cv::Mat& frame, const AppConfig& config) {
     std::vector<Detection> results;
+    detect(frame, config, results);
+    return results;
+}
 
+void Detector::detect(const cv::Mat& frame, const AppConfig& config, std::vector<Detection>& results) {
+    if (reload_pending_.load(std::memory_order_acquire)) applyReload();
     if (frame.empty()) {
-        std::cerr << "[Detector] Warning: empty frame passed to detect()." << std::endl;
-        return results;
+        CCM_LOG_WARN("Detector", "Empty frame passed to detect().");
+        results.clear();
+        return;
+    }
+    if (!backend_) {
+        results.clear();
+        return;
+    }
+
+    // ROI mode: only crops around the active search zones go through the network
+    if (planTiles(frame.size(), config, tiles_)) {
+        detectTiles(frame, tiles_, config, results);
+        return;
+    }
+
+    // Tiled mode: input-sized slices of a high-resolution frame, merged back into frame coordinates
+    if (config.tiling.mode == "grid" || config.tiling.mode == "adaptive") {
+        detectTiled(frame, config, results);
+        return;
     }
 
     // -------------------------------------------------------------------------
     // 1. Preprocess: use config-driven blob params
     // -------------------------------------------------------------------------
-    cv::Mat blob;
-    cv::dnn::blobFromImage(
-        frame,
-        blob,
-        config.pixel_scale,                                  // e.g. 1.0f or 1/255.f
-        cv::Size(config.input_width, config.input_height),   // e.g. 640x640
-        cv::Scalar(),                                        // no mean subtraction
-        config.swap_rb,                                      // swap RB if needed
-        false                                                // crop = false
-    );
-
-    net_.setInput(blob);
+    LetterboxInfo letterbox;
+    const cv::Mat* blob = nullptr;
+    {
+        CCM_TIMED_SCOPE(Stage::Preprocess);
+        // Into the preprocessor's persistent 1x3xHxW tensor (letterboxed, RGB, scaled)
+        blob = &preprocessor_.run(
+            frame,
+            cv::Size(config.input_width, config.input_height),   // e.g. 640x640
+            config.pixel_scale,                                  // e.g. 1.0f or 1/255.f
+            config.swap_rb,                                      // swap RB if needed
+            config.letterbox,                                    // keep aspect ratio
+            letterbox
+        );
+    }
 
     // -------------------------------------------------------------------------
     // 2. Forward pass
     // -------------------------------------------------------------------------
-    std::vector<cv::Mat> outputs;
-    net_.forward(outputs, net_.getUnconnectedOutLayersNames());
+    bool ok = false;
+    {
+        CCM_TIMED_SCOPE(Stage::Inference);
+        ok = backend_->infer(*blob, outputs_);
+    }
 
-    if (outputs.empty()) {
-        std::cerr << "[Detector] Error: network returned no outputs." << std::endl;
-        return results;
+    if (!ok || outputs_.empty()) {
+        CCM_LOG_ERROR("Detector", "Network returned no outputs.");
+        results.clear();
+        return;
     }
 
-    cv::Mat output = outputs[0];
+    postprocess(outputs_[0], letterbox, config, results);
+}
 
-    // -------------------------------------------------------------------------
-    // 3. Flatten YOLOv5 output to [num_rows x dimensions]
-    //    Typical YOLOv5 ONNX: [1, 25200, 85] -> [25200 x 85]
-    // -------------------------------------------------------------------------
-    int rows = 0;
-    int dimensions = 0;
+std::vector<std::vector<Detection>> Detector::detectBatch(const std::vector<cv::Mat>& frames,
+                                                          const AppConfig& config) {
+    batch_configs_.assign(frames.size(), &config);
+    return detectBatch(frames, batch_configs_);
+}
 
-    if (output.dims == 2) {
-        rows = output.rows;
-        dimensions = output.cols;
-    } else {
-        int last_dim = output.size[output.dims - 1];
-        int total = 1;
-        for (int i = 0; i < output.dims - 1; ++i) {
-            total *= output.size[i];
+std::vector<std::vector<Detection>> Detector::detectBatch(const std::vector<cv::Mat>& frames,
+                                                          const std::vector<const AppConfig*>& configs) {
+    std::vector<std::vector<Detection>> batch_results;
+    detectBatch(frames, configs, batch_results);
+    return batch_results;
+}
+
+void Detector::detectBatch(const std::vector<cv::Mat>& frames, const std::vector<const AppConfig*>& configs,
+                           std::vector<std::vector<Detection>>& batch_results) {
+    // Lists are written over in place (see finalize()); every early exit clears them instead
+    batch_results.resize(frames.size());
+    auto clearAll = [&batch_results] {
+        for (auto& results : batch_results) results.clear();
+    };
+    if (frames.empty() || configs.size() != frames.size()) {
+        clearAll();
+        return;
+    }
+    if (reload_pending_.load(std::memory_order_acquire)) applyReload();
+    const AppConfig& config = *configs[0];
+
+    // Models exported with a static batch of 1 cannot take an N x 3 x H x W tensor.
+    // ROI / tiled-mode streams batch their own crops, so mixed batches also go frame by frame.
+    if (!backend_) {
+        clearAll();
+        return;
+    }
+    bool roi = false;
+    for (const AppConfig* c : configs) roi = roi || c->detection.roi_inference || c->tiling.mode != "off";
+    if (frames.size() == 1 || !batch_supported_ || roi) {
+        for (size_t i = 0; i < frames.size(); ++i) detect(frames[i], *configs[i], batch_results[i]);
+        return;
+    }
+
+    for (const auto& f : frames) {
+        if (f.empty()) {
+            CCM_LOG_WARN("Detector", "Empty frame passed to detectBatch().");
+            for (size_t i = 0; i < frames.size(); ++i) detect(frames[i], *configs[i], batch_results[i]);
+            return;
         }
-        rows = total;
-        dimensions = last_dim;
-        output = output.reshape(1, rows);
     }
 
-    if (dimensions < 5) {
-        std::cerr << "[Detector] Invalid output shape: rows=" << rows
-                  << " dims=" << dimensions << " (expected >= 5)" << std::endl;
-        return results;
+    // -------------------------------------------------------------------------
+    // 1. Preprocess all frames into one N x 3 x H x W blob
+    // -------------------------------------------------------------------------
+    const cv::Mat* blob = nullptr;
+    {
+        CCM_TIMED_SCOPE(Stage::Preprocess);
+        blob = &preprocessor_.runBatch(
+            frames,
+            cv::Size(config.input_width, config.input_height),
+            config.pixel_scale,
+            config.swap_rb,
+            config.letterbox,
+            letterboxes_
+        );
     }
 
-    if (config.debug.enabled) {
-        static bool meta_logged = false;
-        if (!meta_logged) {
-            std::cout << "[Detector] Output tensor flattened to "
-                      << rows << " rows x " << dimensions << " dims" << std::endl;
-            meta_logged = true;
-        }
+    // -------------------------------------------------------------------------
+    // 2. Single forward pass over the whole batch
+    // -------------------------------------------------------------------------
+    bool ok = false;
+    {
+        CCM_TIMED_SCOPE(Stage::Inference);
+        ok = backend_->infer(*blob, outputs_);
+    }
+    if (!ok) {
+        CCM_LOG_WARN("Detector", "Batched forward failed (model likely has a static batch of 1). "
+                                 "Falling back to per-frame inference.");
+        batch_supported_ = false;
+        detectBatch(frames, configs, batch_results);
+        return;
+    }
+
+    if (outputs_.empty()) {
+        CCM_LOG_ERROR("Detector", "Network returned no outputs.");
+        clearAll();
+        return;
     }
 
     // -------------------------------------------------------------------------
-    // 4. Decode detections from YOLO output
-    //    Row format: [cx, cy, w, h, obj_conf, class0, class1, ...]
+    // 3. Split [N, rows, dims] into per-image [rows x dims] views and decode each
     // -------------------------------------------------------------------------
-    const int num_classes = dimensions - 5;
+    const cv::Mat& output = outputs_[0];
+    const int n = static_cast<int>(frames.size());
+    if (output.dims != 3 || output.size[0] != n) {
+        CCM_LOG_WARN("Detector", "Unexpected batched output shape (dims=%d). "
+                                 "Falling back to per-frame inference.", output.dims);
+        batch_supported_ = false;
+        detectBatch(frames, configs, batch_results);
+        return;
+    }
 
-    std::vector<int> class_ids;
-    std::vector<float> confidences;
-    std::vector<cv::Rect> boxes;
+    for (int i = 0; i < n; ++i) {
+        cv::Mat image_output(output.size[1], output.size[2], CV_32F,
+                             const_cast<float*>(output.ptr<float>(i)));
+        postprocess(image_output, letterboxes_[i], *configs[i], batch_results[i]);
+    }
+}
 
-    for (int i = 0; i < rows; ++i) {
-        float* data = output.ptr<float>(i);
+bool Detector::planTiles(const cv::Size& frame_size, const AppConfig& config, std::vector<cv::Rect>& tiles) const {
+    tiles.clear();
+    const ZoneIndex* zones = config.zone_index.get();
+    if (!config.detection.roi_inference || !zones || !zones->restricted()) return false;
 
-        float obj_conf = data[4];  // objectness
+    // A frame that fits the input in one piece already runs at native resolution
+    const cv::Size input(config.input_width, config.input_height);
+    if (frame_size.width <= input.width && frame_size.height <= input.height) return false;
 
-        // Quick gate on objectness first
-        if (obj_conf < config.confidence_threshold) {
-            continue;
+    for (const cv::Rect& region : zones->activeRegions()) {
+        for (const cv::Rect& tile : tileRegion(region, input, config.detection.tile_overlap, frame_size)) {
+            if (std::find(tiles.begin(), tiles.end(), tile) == tiles.end()) tiles.push_back(tile);
         }
+    }
+    // Zones spread over the whole frame: one downscaled full-frame pass is cheaper
+    if (tiles.empty() || tiles.size() > static_cast<size_t>(std::max(1, config.detection.roi_max_tiles))) {
+        tiles.clear();
+        return false;
+    }
+    return true;
+}
 
-        // Find best class score
-        int best_class_id = -1;
-        float best_class_score = 0.0f;
+void Detector::appendTile(const cv::Point& offset, float min_confidence) {
+    const std::vector<cv::Rect>& boxes = decoder_.boxes();
+    for (size_t k = 0; k < boxes.size(); ++k) {
+        if (decoder_.confidences()[k] < min_confidence) continue;
+        tile_boxes_.push_back(boxes[k] + offset);
+        tile_confidences_.push_back(decoder_.confidences()[k]);
+        tile_class_ids_.push_back(decoder_.classIds()[k]);
+    }
+}
 
-        for (int c = 0; c < num_classes && c < static_cast<int>(classes_.size()); ++c) {
-            float score = data[5 + c];  // assuming scores are already in [0,1] space
-            if (score > best_class_score) {
-                best_class_score = score;
-                best_class_id = c;
+void Detector::inferCrops(const cv::Mat& frame, const std::vector<cv::Rect>& tiles, const AppConfig& config) {
+    const cv::Size input(config.input_width, config.input_height);
+    tile_crops_.clear();
+    for (const cv::Rect& tile : tiles) tile_crops_.push_back(frame(tile));   // Views, no copies
+
+    // All crops in one N x 3 x H x W pass when the model takes a batch
+    if (tiles.size() > 1 && batch_supported_) {
+        const cv::Mat* blob = nullptr;
+        {
+            CCM_TIMED_SCOPE(Stage::Preprocess);
+            blob = &preprocessor_.runBatch(tile_crops_, input, config.pixel_scale, config.swap_rb, config.letterbox,
+                                           letterboxes_);
+        }
+        bool ok = false;
+        {
+            CCM_TIMED_SCOPE(Stage::Inference);
+            ok = backend_->infer(*blob, outputs_);
+        }
+        const int n = static_cast<int>(tiles.size());
+        if (ok && !outputs_.empty() && outputs_[0].dims == 3 && outputs_[0].size[0] == n) {
+            for (int i = 0; i < n; ++i) {
+                cv::Mat tile_output(outputs_[0].size[1], outputs_[0].size[2], CV_32F,
+                                    const_cast<float*>(outputs_[0].ptr<float>(i)));
+                if (decodeOutput(tile_output, letterboxes_[i], config, config.confidence_threshold)) {
+                    appendTile(tiles[i].tl(), config.confidence_threshold);
+                }
             }
+            return;
         }
+        CCM_LOG_WARN("Detector", "Batched crop forward failed; running the crops one by one.");
+        batch_supported_ = false;
+    }
 
-        if (best_class_id < 0) {
-            continue;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        LetterboxInfo letterbox;
+        const cv::Mat* blob = nullptr;
+        {
+            CCM_TIMED_SCOPE(Stage::Preprocess);
+            blob = &preprocessor_.run(tile_crops_[i], input, config.pixel_scale, config.swap_rb, config.letterbox,
+                                      letterbox);
         }
-
-        // Combined confidence = objectness * class probability
-        float combined_conf = obj_conf * best_class_score;
-
-        // Debug logging for candidates above debug.threshold
-        if (config.debug.enabled && obj_conf >= config.debug.threshold) {
-            std::string name = (best_class_id >= 0 && best_class_id < (int)classes_.size())
-                               ? classes_[best_class_id]
-                               : "unknown";
-
-            std::cout << "[Debug] Obj: " << obj_conf
-                      << " | Class Score: " << best_class_score
-                      << " | Combined: " << combined_conf
-                      << " | Candidate: " << name << std::endl;
+        bool ok = false;
+        {
+            CCM_TIMED_SCOPE(Stage::Inference);
+            ok = backend_->infer(*blob, outputs_);
         }
-
-        // Final gate using combined confidence
-        if (combined_conf < config.confidence_threshold) {
-            continue;
+        if (ok && !outputs_.empty() && decodeOutput(outputs_[0], letterbox, config, config.confidence_threshold)) {
+            appendTile(tiles[i].tl(), config.confidence_threshold);
         }
+    }
+}
 
-        // Raw model outputs
-        float x      = data[0];
-        float y      = data[1];
-        float width  = data[2];
-        float height = data[3];
-
-        // Decode to pixel space
-        float cx, cy, boxW, boxH;
-        
-        // Model gives coords in "model input" units (e.g. 640x640)
-        const float x_factor = static_cast<float>(frame.cols) /
-                                static_cast<float>(config.model.input_width);
-        const float y_factor = static_cast<float>(frame.rows) /
-                                static_cast<float>(config.model.input_height);
-
-        cx   = x      * x_factor;
-        cy   = y      * y_factor;
-        boxW = width  * x_factor;
-        boxH = height * y_factor;
-
-        // Convert to top-left + size, in integer pixels
-        int left     = static_cast<int>(cx - 0.5f * boxW);
-        int top      = static_cast<int>(cy - 0.5f * boxH);
-        int widthPx  = std::max(1, static_cast<int>(boxW));
-        int heightPx = std::max(1, static_cast<int>(boxH));
-
-        // Optional debug of *raw* values
-        if (config.debug.enabled) {
-            std::cout << "[DebugBoxRaw] x=" << x
-                      << " y=" << y
-                      << " w=" << width
-                      << " h=" << height
-                      << std::endl;
-        }
+void Detector::detectTiles(const cv::Mat& frame, const std::vector<cv::Rect>& tiles, const AppConfig& config,
+                           std::vector<Detection>& results) {
+    tile_boxes_.clear();
+    tile_confidences_.clear();
+    tile_class_ids_.clear();
+    inferCrops(frame, tiles, config);
 
-        // Skip clearly invalid boxes
-        if (widthPx <= 0 || heightPx <= 0) {
-            if (config.debug.enabled) {
-                std::cout << "[DebugBoxSkip] invalid box after decode: left=" << left
-                          << " top=" << top
-                          << " width=" << widthPx
-                          << " height=" << heightPx
-                          << " (frame " << frame.cols << "x" << frame.rows << ")"
-                          << std::endl;
-            }
-            continue;
-        }
+    CCM_LOG_DEBUG("Detector", "ROI inference: %zu crops, %zu candidates", tiles.size(), tile_boxes_.size());
+    finalize(tile_boxes_, tile_confidences_, tile_class_ids_, config, results);
+}
 
-        // Clamp to frame boundaries using *widthPx/heightPx*
-        if (left < 0) {
-            widthPx += left;   // shrink width by how far we’re off-screen
-            left = 0;
+void Detector::detectTiled(const cv::Mat& frame, const AppConfig& config, std::vector<Detection>& results) {
+    const TilingConfig& tiling = config.tiling;
+    const bool adaptive = tiling.mode == "adaptive";
+    tile_boxes_.clear();
+    tile_confidences_.clear();
+    tile_class_ids_.clear();
+    tiles_.clear();
+    tile_regions_.clear();
+
+    // Low-res full-frame pass: large objects, and in adaptive mode the seeds for the tiles
+    if (adaptive || tiling.full_frame) {
+        const float threshold = adaptive ? std::min(tiling.coarse_threshold, config.confidence_threshold)
+                                         : config.confidence_threshold;
+        LetterboxInfo letterbox;
+        const cv::Mat* blob = nullptr;
+        {
+            CCM_TIMED_SCOPE(Stage::Preprocess);
+            blob = &preprocessor_.run(frame, cv::Size(config.input_width, config.input_height), config.pixel_scale,
+                                      config.swap_rb, config.letterbox, letterbox);
         }
-        if (top < 0) {
-            heightPx += top;
-            top = 0;
+        bool ok = false;
+        {
+            CCM_TIMED_SCOPE(Stage::Inference);
+            ok = backend_->infer(*blob, outputs_);
         }
-        if (left + widthPx > frame.cols) {
-            widthPx = frame.cols - left;
+        if (ok && !outputs_.empty() && decodeOutput(outputs_[0], letterbox, config, threshold)) {
+            if (adaptive) tile_regions_ = mergeRects(decoder_.boxes());
+            appendTile(cv::Point(0, 0), config.confidence_threshold);
         }
-        if (top + heightPx > frame.rows) {
-            heightPx = frame.rows - top;
-        }
-
-        if (widthPx <= 0 || heightPx <= 0) {
-            if (config.debug.enabled) {
-                std::cout << "[DebugBoxSkip] clamped box has non-positive size: left=" << left
-                          << " top=" << top
-                          << " width=" << widthPx
-                          << " height=" << heightPx
-                          << " (frame " << frame.cols << "x" << frame.rows << ")"
-                          << std::endl;
+    }
+    if (!adaptive) tile_regions_.assign(1, cv::Rect(cv::Point(0, 0), frame.size()));
+
+    // More tiles than max_tiles: larger tiles (downscaled to the input) rather than uncovered regions
+    const cv::Size configured(tiling.tile_width > 0 ? tiling.tile_width : config.input_width,
+                              tiling.tile_height > 0 ? tiling.tile_height : config.input_height);
+    const size_t max_tiles = static_cast<size_t>(std::max(1, tiling.max_tiles));
+    cv::Size tile_size = configured;
+    while (true) {
+        tiles_.clear();
+        for (const cv::Rect& region : tile_regions_) {
+            for (const cv::Rect& tile : tileRegion(region, tile_size, tiling.overlap, frame.size())) {
+                if (std::find(tiles_.begin(), tiles_.end(), tile) == tiles_.end()) tiles_.push_back(tile);
             }
-            continue;
         }
-
-        if (config.debug.enabled) {
-            std::cout << "[DebugBoxDecoded] left=" << left
-                      << " top=" << top
-                      << " width=" << widthPx
-                      << " height=" << heightPx
-                      << " (frame " << frame.cols << "x" << frame.rows << ")"
-                      << " (frame " << frame.cols << "x" << frame.rows << ")"
-                      << std::endl;
+        if (tiles_.size() <= max_tiles || (tile_size.width >= frame.cols && tile_size.height >= frame.rows)) break;
+        tile_size = cv::Size(std::min(frame.cols, std::max(tile_size.width + 1, tile_size.width * 5 / 4)),
+                             std::min(frame.rows, std::max(tile_size.height + 1, tile_size.height * 5 / 4)));
+    }
+    if (tile_size != configured && tile_size != logged_tile_size_) {
+        // Grid: once per frame size; adaptive: depends on the scene, so only at debug level
+        if (adaptive) {
+            CCM_LOG_DEBUG("Detector", "Tiling: %dx%d tiles enlarged to %dx%d to fit max_tiles=%zu", configured.width,
+                          configured.height, tile_size.width, tile_size.height, max_tiles);
+        } else {
+            CCM_LOG_INFO("Detector", "Tiling: %dx%d frame needs more than max_tiles=%zu tiles of %dx%d; "
+                         "using %dx%d tiles (downscaled to the model input)", frame.cols, frame.rows, max_tiles,
+                         configured.width, configured.height, tile_size.width, tile_size.height);
+            logged_tile_size_ = tile_size;
         }
+    }
+    if (!tiles_.empty()) inferCrops(frame, tiles_, config);
+
+    const size_t candidates = tile_boxes_.size();
+    if (tiling.merge == "wbf") {
+        CCM_TIMED_SCOPE(Stage::NMS);
+        fuseBoxes(tile_boxes_, tile_confidences_, tile_class_ids_, tiling.merge_iou);
+    }
+    CCM_LOG_DEBUG("Detector", "Tiled inference: %zu tiles, %zu candidates, %zu after %s", tiles_.size(), candidates,
+                  tile_boxes_.size(), tiling.merge.c_str());
+    finalize(tile_boxes_, tile_confidences_, tile_class_ids_, config, results);
+}
 
-        // Now store the *pixel* rect
-        confidences.emplace_back(combined_conf);
-        boxes.emplace_back(left, top, widthPx, heightPx);
-        class_ids.emplace_back(best_class_id);
+void Detector::postprocess(cv::Mat output, const LetterboxInfo& letterbox, const AppConfig& config,
+                           std::vector<Detection>& results) {
+    if (!decodeOutput(output, letterbox, config, config.confidence_threshold)) {
+        results.clear();
+        return;
     }
+    finalize(decoder_.boxes(), decoder_.confidences(), decoder_.classIds(), config, results);
+}
 
-    std::cout << "[Detector] raw boxes: " << boxes.size();
+YoloLayout Detector::outputLayout(int rows, int cols, const AppConfig& config) const {
+    const std::string& declared = config.model.output_layout;
+    YoloLayout layout;
+    if (declared == "yolov5") return layout;
+    if (declared == "yolov8") {
+        layout.channel_major = true;
+        layout.objectness = false;
+    } else if (declared == "yolov8_transposed") {
+        layout.objectness = false;
+    } else {
+        layout = YoloLayout::detect(rows, cols, static_cast<int>(classes_.size()));
+    }
+    return layout;
+}
 
+bool Detector::decodeOutput(cv::Mat output, const LetterboxInfo& letterbox, const AppConfig& config,
+                            float threshold) {
     // -------------------------------------------------------------------------
-    // 5. Non-Maximum Suppression
+    // 3. Flatten the output to 2-D [num_rows x dimensions]
+    //    YOLOv5 ONNX: [1, 25200, 85] -> [25200 x 85] (one row per anchor)
+    //    YOLOv8 ONNX: [1, 84, 8400]  -> [84 x 8400]  (one row per channel)
     // -------------------------------------------------------------------------
-    std::vector<int> nms_indices;
-    cv::dnn::NMSBoxes(
-        boxes,
-        confidences,
-        config.confidence_threshold,   // score threshold
-        config.nms_threshold,          // NMS IoU threshold
-        nms_indices
-    );
+    int rows = 0;
+    int dimensions = 0;
+
+    if (output.dims == 2) {
+        rows = output.rows;
+        dimensions = output.cols;
+    } else {
+        int last_dim = output.size[output.dims - 1];
+        int total = 1;
+        for (int i = 0; i < output.dims - 1; ++i) {
+            total *= output.size[i];
+        }
+        rows = total;
+        dimensions = last_dim;
+        output = output.reshape(1, rows);
+    }
+
+    const YoloLayout layout = outputLayout(rows, dimensions, config);
+    const int channels = layout.channel_major ? rows : dimensions;
+    if (channels < (layout.objectness ? 6 : 5)) {
+        CCM_LOG_ERROR("Detector", "Invalid output shape: rows=%d dims=%d (%s: expected >= %d channels)", rows,
+                      dimensions, layout.name(), layout.objectness ? 6 : 5);
+        return false;
+    }
 
-    std::cout << " | after NMS: " << nms_indices.size() << std::endl;
+    if (logged_layout_ != layout.name()) {
+        logged_layout_ = layout.name();
+        CCM_LOG_INFO("Detector", "Output tensor flattened to %d rows x %d dims: %s layout", rows, dimensions,
+                     layout.name());
+    }
 
     // -------------------------------------------------------------------------
-    // 6. Build final Detection objects + zone filtering
+    // 4. Decode detections from YOLO output
+    //    Channels: [cx, cy, w, h, (obj_conf,) class0, class1, ...]
     // -------------------------------------------------------------------------
-    const bool restrict_to_zones = !config.active_search_zones.empty();
+    {
+        CCM_TIMED_SCOPE(Stage::Decode);
+        decoder_.decode(
+            output,
+            letterbox,
+            threshold,
+            static_cast<int>(classes_.size()),
+            Logger::instance().enabled(LogLevel::Trace) ? config.debug.threshold : -1.0f,
+            layout
+        );
+    }
+    return true;
+}
 
-    for (int idx : nms_indices) {
-        Detection det;
-        det.class_id = class_ids[idx];
-        det.confidence = confidences[idx];
-        det.box = boxes[idx];
+void Detector::finalize(const std::vector<cv::Rect>& boxes, const std::vector<float>& confidences,
+                        const std::vector<int>& class_ids, const AppConfig& config, std::vector<Detection>& results) {
+    // -------------------------------------------------------------------------
+    // 5. Non-Maximum Suppression (across tiles too: candidates are in frame coordinates)
+    // -------------------------------------------------------------------------
+    {
+        CCM_TIMED_SCOPE(Stage::NMS);
+        NmsParams params;
+        params.method = parseNmsMethod(config.nms.method);
+        params.iou_threshold = config.nms_threshold;
+        params.score_threshold = config.confidence_threshold;
+        params.top_k = config.nms.top_k;
+        params.max_detections = config.nms.max_detections;
+        params.per_class = config.nms.per_class;
+        params.sigma = config.nms.sigma;
+        nms_.run(boxes, confidences, class_ids, params, nms_keep_, nms_scores_);
+    }
 
-        if (det.class_id >= 0 && det.class_id < static_cast<int>(classes_.size())) {
-            det.className = classes_[det.class_id];
-        } else {
-            det.className = "unknown";
-        }
+    CCM_LOG_DEBUG("Detector", "raw boxes: %zu | after NMS: %zu", boxes.size(), nms_keep_.size());
+
+    // -------------------------------------------------------------------------
+    // 6. Build final Detection objects + zone filtering
+    // -------------------------------------------------------------------------
+    CCM_TIMED_SCOPE(Stage::ZoneFilter);
+    // Precompiled at config load: one raster lookup per detection instead of a scan over the zones
+    const ZoneIndex* zones = config.zone_index.get();
+    const bool restrict_to_zones = zones && zones->restricted();
+
+    // Written over the caller's previous results: reused entries keep their name strings' capacity
+    // (entries past the new count are destroyed by the final resize)
+    size_t count = 0;
+    for (size_t k = 0; k < nms_keep_.size(); ++k) {
+        const int idx = nms_keep_[k];
+        const cv::Rect& box = boxes[idx];
 
         if (restrict_to_zones) {
             cv::Point center(
-                det.box.x + det.box.width / 2,
-                det.box.y + det.box.height / 2
+                box.x + box.width / 2,
+                box.y + box.height / 2
             );
 
-            bool inside_allowed_zone = false;
-
-            // Only consider zones listed in active_search_zones
-            for (const auto& zone : config.zones) {
-                // Zone must be in active_search_zones
-                if (std::find(
-                        config.active_search_zones.begin(),
-                        config.active_search_zones.end(),
-                        zone.name
-                    ) == config.active_search_zones.end()) {
-                    continue;
-                }
-
-                if (zone.rect.contains(center)) {
-                    inside_allowed_zone = true;
-                    break;
-                }
-            }
-
-            if (!inside_allowed_zone) {
-                if (config.debug.enabled) {
-                    std::cout << "[Detector] Ignored detection outside active zones: "
-                              << det.className << " @ ("
-                              << center.x << "," << center.y << ")" << std::endl;
-                }
+            // Only zones listed in active_search_zones count
+            if (!zones->allowed(center)) {
+                CCM_LOG_TRACE("Detector", "Ignored detection outside active zones: class=%d @ (%d,%d)",
+                              class_ids[idx], center.x, center.y);
                 continue;
             }
         }
 
-        results.push_back(det);
-    }
+        if (count == results.size()) results.emplace_back();
+        Detection& det = results[count++];
+        det.class_id = class_ids[idx];
+        det.confidence = nms_scores_[k];   // Decayed by Soft / Matrix NMS
+        det.box = box;
 
-    std::cout << "[Detector] final detections after zone filter: "
-              << results.size() << std::endl;
+        if (det.class_id >= 0 && det.class_id < static_cast<int>(classes_.size())) {
+            det.className = classes_[det.class_id];
+        } else {
+            det.className = "unknown";
+        }
+    }
+    results.resize(count);
 
-    return results;
+    CCM_LOG_DEBUG("Detector", "final detections after zone filter: %zu", results.size());
 }
 
 
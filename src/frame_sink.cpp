@@ -0,0 +1,78 @@
+#include "frame_sink.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+namespace CCM {
+
+EncoderThread::EncoderThread(FrameSink& sink, int max_fps)
+    : sink_(sink),
+      min_interval_(max_fps > 0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                      std::chrono::duration<double>(1.0 / max_fps))
+                                : std::chrono::steady_clock::duration::zero()) {}
+
+EncoderThread::~EncoderThread() {
+    stop();
+}
+
+void EncoderThread::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread(&EncoderThread::loop, this);
+}
+
+void EncoderThread::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void EncoderThread::submit(const cv::Mat& frame) {
+    if (!sink_.wanted()) return;
+
+    // Rate cap: only the submitting (pipeline) thread touches last_submit_
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_submit_ < min_interval_) return;
+    last_submit_ = now;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || failed_) return;
+        if (has_pending_) skipped_.fetch_add(1, std::memory_order_relaxed);
+        frame.copyTo(pending_);
+        has_pending_ = true;
+    }
+    cv_.notify_one();
+}
+
+void EncoderThread::loop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !running_ || has_pending_; });
+            if (!running_) break;
+            cv::swap(pending_, working_);
+            has_pending_ = false;
+        }
+
+        bool ok;
+        {
+            CCM_TIMED_SCOPE(Stage::Encode);
+            ok = sink_.encode(working_);
+        }
+        if (!ok) {
+            CCM_LOG_ERROR("Output", "%s sink failed; disabling it.", sink_.name());
+            std::lock_guard<std::mutex> lock(mutex_);
+            failed_ = true;
+            break;
+        }
+        encoded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    sink_.close();
+}
+
+} // namespace CCM
@@ -0,0 +1,210 @@
+#include "http_server.hpp"
+#include "logger.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace CCM {
+
+// A send blocked this long (client not reading) re-checks whether the server is stopping
+static const int kSendTimeoutSec = 1;
+
+static const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 503: return "Service Unavailable";
+        default: return "Internal Server Error";
+    }
+}
+
+HttpConnection::HttpConnection(int fd, std::string path, const std::atomic<bool>& server_running)
+    : fd_(fd), path_(std::move(path)), server_running_(server_running) {}
+
+bool HttpConnection::sendResponse(int status, const std::string& content_type, const std::string& body) {
+    std::string header = "HTTP/1.1 " + std::to_string(status) + " " + statusText(status) + "\r\n"
+                         "Content-Type: " + content_type + "\r\n"
+                         "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                         "Connection: close\r\n\r\n";
+    return send(header) && send(body);
+}
+
+#ifndef _WIN32
+
+bool HttpConnection::send(const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (open_ && size > 0) {
+        const ssize_t n = ::send(fd_, p, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && server_running_.load(std::memory_order_relaxed)) continue;
+            open_ = false;
+            break;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return open_;
+}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+void HttpServer::addRoute(const std::string& path, Handler handler) {
+    routes_[path] = std::move(handler);
+}
+
+bool HttpServer::start(const std::string& bind_address, int port) {
+    if (running_) return true;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+
+    int yes = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+        CCM_LOG_ERROR("Http", "Invalid bind address '%s'", bind_address.c_str());
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, 8) < 0) {
+        CCM_LOG_ERROR("Http", "Cannot listen on %s:%d", bind_address.c_str(), port);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    accept_thread_ = std::thread(&HttpServer::acceptLoop, this);
+    CCM_LOG_INFO("Http", "Listening on http://%s:%d", bind_address.c_str(), port);
+    return true;
+}
+
+void HttpServer::stop() {
+    if (!running_.exchange(false)) return;
+
+    if (accept_thread_.joinable()) accept_thread_.join();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+
+    // Wake handlers blocked in send() / recv() on clients that stopped reading
+    {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        for (const auto& client : clients_) {
+            if (!client.done->load()) shutdown(client.fd, SHUT_RDWR);
+        }
+    }
+    reapClients(true);
+}
+
+void HttpServer::acceptLoop() {
+    while (running_) {
+        // Poll with a timeout so stop() is noticed without closing the socket under accept()
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) {
+            reapClients(false);
+            continue;
+        }
+
+        const int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        // Bounded blocking writes: a stalled client cannot hold its handler past stop()
+        timeval timeout{};
+        timeout.tv_sec = kSendTimeoutSec;
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        clients_.push_back({std::thread([this, fd, done] {
+                                handleClient(fd);
+                                done->store(true);
+                            }),
+                            done, fd});
+    }
+}
+
+void HttpServer::reapClients(bool all) {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    for (auto it = clients_.begin(); it != clients_.end();) {
+        if (all || it->done->load()) {
+            if (it->thread.joinable()) it->thread.join();
+            ::close(it->fd);
+            it = clients_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void HttpServer::handleClient(int fd) {
+    // Read the request head (we only need the request line)
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 2000) <= 0) break;
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) break;
+        request.append(buf, static_cast<size_t>(n));
+    }
+
+    HttpConnection conn(fd, "", running_);
+    const size_t sp1 = request.find(' ');
+    const size_t sp2 = sp1 == std::string::npos ? sp1 : request.find(' ', sp1 + 1);
+
+    if (sp2 == std::string::npos) {
+        conn.sendResponse(400, "text/plain", "bad request\n");
+    } else if (request.compare(0, sp1, "GET") != 0) {
+        conn.sendResponse(405, "text/plain", "method not allowed\n");
+    } else {
+        std::string path = request.substr(sp1 + 1, sp2 - sp1 - 1);
+        const size_t q = path.find('?');
+        if (q != std::string::npos) path.resize(q);
+
+        auto it = routes_.find(path);
+        if (it == routes_.end()) {
+            conn.sendResponse(404, "text/plain", "not found\n");
+        } else {
+            HttpConnection route_conn(fd, path, running_);
+            it->second(route_conn);
+        }
+    }
+
+    // FIN to the client now; the descriptor itself is closed by reapClients()
+    shutdown(fd, SHUT_RDWR);
+}
+
+#else // _WIN32: embedded endpoints are not supported on Windows builds
+
+bool HttpConnection::send(const void*, size_t) { return false; }
+HttpServer::~HttpServer() {}
+void HttpServer::addRoute(const std::string& path, Handler handler) { routes_[path] = std::move(handler); }
+bool HttpServer::start(const std::string&, int) {
+    CCM_LOG_WARN("Http", "Embedded HTTP server is not available on Windows builds.");
+    return false;
+}
+void HttpServer::stop() {}
+void HttpServer::acceptLoop() {}
+void HttpServer::handleClient(int) {}
+void HttpServer::reapClients(bool) {}
+
+#endif
+
+} // namespace CCM
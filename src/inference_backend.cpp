@@ -0,0 +1,149 @@
+#include "inference_backend.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include "logger.hpp"
+#include "onnxruntime_backend.hpp"
+#include "opencv_dnn_backend.hpp"
+
+namespace CCM {
+
+std::vector<std::string> compiledBackends() {
+    std::vector<std::string> names = {"opencv_cuda", "opencv_openvino"};
+#ifdef CCM_WITH_ONNXRUNTIME
+    names.push_back("onnxruntime");
+#endif
+    names.push_back("opencv_vulkan");
+    names.push_back("opencv_opencl");
+    names.push_back("opencv_cpu");
+    return names;
+}
+
+std::unique_ptr<InferenceBackend> createBackend(const std::string& name, const ModelConfig& config) {
+    if (name == "onnxruntime") {
+        return std::unique_ptr<InferenceBackend>(
+            new OnnxRuntimeBackend(config.intra_op_threads, config.inter_op_threads));
+    }
+    const std::string prefix = "opencv_";
+    if (name.compare(0, prefix.size(), prefix) == 0) {
+        const std::string target = name.substr(prefix.size());
+        if (target == "cpu" || target == "opencl" || target == "openvino" || target == "vulkan" || target == "cuda") {
+            return std::unique_ptr<InferenceBackend>(new OpenCvDnnBackend(target, config.precision == "fp16"));
+        }
+    }
+    return nullptr;
+}
+
+std::string modelPathForPrecision(const std::string& model_path, const std::string& precision) {
+    if (precision != "fp16" && precision != "int8") return model_path;
+
+    const std::string suffix = "." + precision + ".onnx";
+    if (model_path.size() >= suffix.size() &&
+        model_path.compare(model_path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        return model_path;
+    }
+    const size_t dot = model_path.rfind('.');
+    const std::string stem = (dot == std::string::npos || dot < model_path.find_last_of("/\\") + 1)
+                                 ? model_path : model_path.substr(0, dot);
+    const std::string converted = stem + suffix;
+    if (std::ifstream(converted).good()) return converted;
+    return model_path;
+}
+
+// OpenCV DNN only has INT8 (QDQ / QOperator) kernels on its own CPU path
+static bool supportsPrecision(const std::string& name, const std::string& precision) {
+    if (precision != "int8") return true;
+    return name == "opencv_cpu" || name == "onnxruntime";
+}
+
+// Median forward time in milliseconds, or a negative value if a run fails
+static double benchmarkBackend(InferenceBackend& backend, const cv::Size& input_size, int runs) {
+    const int sizes[4] = {1, 3, input_size.height, input_size.width};
+    cv::Mat input(4, sizes, CV_32F, cv::Scalar(0.5));
+    std::vector<cv::Mat> outputs;
+
+    for (int i = 0; i < 2; ++i) {
+        if (!backend.infer(input, outputs)) return -1.0;
+    }
+
+    std::vector<double> times;
+    for (int i = 0; i < runs; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        if (!backend.infer(input, outputs)) return -1.0;
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+std::unique_ptr<InferenceBackend> selectBackend(const std::string& model_path, const ModelConfig& config,
+                                                const cv::Size& input_size) {
+    if (config.precision != "fp32" && config.precision != "fp16" && config.precision != "int8") {
+        CCM_LOG_WARN("Backend", "Unknown model.precision '%s' (expected fp32, fp16 or int8)", config.precision.c_str());
+    }
+
+    // Self-benchmark: keep the fastest backend that runs on this machine
+    if (config.backend == "auto") {
+        std::unique_ptr<InferenceBackend> best;
+        double best_ms = 0.0;
+        const int runs = std::max(1, config.benchmark_runs);
+
+        for (const auto& name : compiledBackends()) {
+            if (!supportsPrecision(name, config.precision)) {
+                CCM_LOG_INFO("Backend", "  %-16s no %s kernels", name.c_str(), config.precision.c_str());
+                continue;
+            }
+            std::unique_ptr<InferenceBackend> candidate = createBackend(name, config);
+            if (!candidate || !candidate->load(model_path, input_size)) {
+                CCM_LOG_INFO("Backend", "  %-16s unavailable", name.c_str());
+                continue;
+            }
+            const double ms = benchmarkBackend(*candidate, input_size, runs);
+            if (ms < 0.0) {
+                CCM_LOG_INFO("Backend", "  %-16s failed during benchmark", name.c_str());
+                continue;
+            }
+            CCM_LOG_INFO("Backend", "  %-16s %8.2f ms (median of %d)", name.c_str(), ms, runs);
+            if (!best || ms < best_ms) {
+                best = std::move(candidate);
+                best_ms = ms;
+            }
+        }
+
+        if (best) CCM_LOG_INFO("Backend", "Selected %s (%.2f ms per frame)", best->name().c_str(), best_ms);
+        else CCM_LOG_ERROR("Backend", "No inference backend could run %s", model_path.c_str());
+        return best;
+    }
+
+    // Explicit choice, then the usual fallback chain (CPU last: always available)
+    std::vector<std::string> order = {config.backend, "opencv_cuda", "opencv_openvino"};
+#ifdef CCM_WITH_ONNXRUNTIME
+    order.push_back("onnxruntime");
+#endif
+    order.push_back("opencv_cpu");
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i > 0 && order[i] == config.backend) continue;
+        if (!supportsPrecision(order[i], config.precision)) {
+            CCM_LOG_WARN("Backend", "%s has no %s kernels, skipping", order[i].c_str(), config.precision.c_str());
+            continue;
+        }
+
+        std::unique_ptr<InferenceBackend> backend = createBackend(order[i], config);
+        if (!backend) {
+            CCM_LOG_WARN("Backend", "Unknown backend '%s'", order[i].c_str());
+            continue;
+        }
+        if (backend->load(model_path, input_size)) {
+            if (i == 0) CCM_LOG_INFO("Backend", "Using %s", backend->name().c_str());
+            else CCM_LOG_WARN("Backend", "'%s' unavailable, falling back to %s", config.backend.c_str(),
+                              backend->name().c_str());
+            return backend;
+        }
+    }
+
+    CCM_LOG_ERROR("Backend", "No inference backend could run %s", model_path.c_str());
+    return nullptr;
+}
+
+} // namespace CCM
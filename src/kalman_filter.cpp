@@ -0,0 +1,82 @@
+#include "kalman_filter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace CCM {
+
+// Position / velocity noise as a fraction of the box size (values from DeepSORT)
+static const float kStdPosition = 1.0f / 20.0f;
+static const float kStdVelocity = 1.0f / 160.0f;
+
+void KalmanBoxFilter::init(const cv::Rect& box) {
+    const float w = static_cast<float>(std::max(1, box.width));
+    const float h = static_cast<float>(std::max(1, box.height));
+
+    x_ = State::zeros();
+    x_(0) = box.x + 0.5f * w;
+    x_(1) = box.y + 0.5f * h;
+    x_(2) = w;
+    x_(3) = h;
+
+    // Position is known from the first detection; velocity is not
+    const float sp[4] = {2 * kStdPosition * w, 2 * kStdPosition * h, 2 * kStdPosition * w, 2 * kStdPosition * h};
+    const float sv[4] = {10 * kStdVelocity * w, 10 * kStdVelocity * h, 10 * kStdVelocity * w, 10 * kStdVelocity * h};
+    P_ = Covariance::zeros();
+    for (int i = 0; i < 4; ++i) {
+        P_(i, i) = sp[i] * sp[i];
+        P_(i + 4, i + 4) = sv[i] * sv[i];
+    }
+}
+
+cv::Rect KalmanBoxFilter::predict() {
+    const float w = std::max(1.0f, x_(2));
+    const float h = std::max(1.0f, x_(3));
+
+    // x = F x, with F = [I I; 0 I] (dt = 1 frame)
+    for (int i = 0; i < 4; ++i) x_(i) += x_(i + 4);
+    x_(2) = std::max(1.0f, x_(2));
+    x_(3) = std::max(1.0f, x_(3));
+
+    // P = F P F^T + Q
+    Covariance F = Covariance::eye();
+    for (int i = 0; i < 4; ++i) F(i, i + 4) = 1.0f;
+    P_ = F * P_ * F.t();
+
+    const float qp[4] = {kStdPosition * w, kStdPosition * h, kStdPosition * w, kStdPosition * h};
+    const float qv[4] = {kStdVelocity * w, kStdVelocity * h, kStdVelocity * w, kStdVelocity * h};
+    for (int i = 0; i < 4; ++i) {
+        P_(i, i) += qp[i] * qp[i];
+        P_(i + 4, i + 4) += qv[i] * qv[i];
+    }
+
+    return rect();
+}
+
+void KalmanBoxFilter::correct(const cv::Rect& box) {
+    const float w = static_cast<float>(std::max(1, box.width));
+    const float h = static_cast<float>(std::max(1, box.height));
+
+    cv::Matx<float, 4, 1> z(box.x + 0.5f * w, box.y + 0.5f * h, w, h);
+
+    cv::Matx<float, 4, 8> H = cv::Matx<float, 4, 8>::zeros();
+    for (int i = 0; i < 4; ++i) H(i, i) = 1.0f;
+
+    // S = H P H^T + R
+    cv::Matx<float, 4, 4> S = H * P_ * H.t();
+    const float r[4] = {kStdPosition * w, kStdPosition * h, kStdPosition * w, kStdPosition * h};
+    for (int i = 0; i < 4; ++i) S(i, i) += r[i] * r[i];
+
+    // K = P H^T S^-1 ; x += K (z - H x) ; P = (I - K H) P
+    const cv::Matx<float, 8, 4> K = P_ * H.t() * S.inv(cv::DECOMP_CHOLESKY);
+    x_ += K * (z - H * x_);
+    P_ = (Covariance::eye() - K * H) * P_;
+}
+
+cv::Rect KalmanBoxFilter::rect() const {
+    const float w = std::max(1.0f, x_(2));
+    const float h = std::max(1.0f, x_(3));
+    return cv::Rect(static_cast<int>(std::lround(x_(0) - 0.5f * w)), static_cast<int>(std::lround(x_(1) - 0.5f * h)),
+                    static_cast<int>(std::lround(w)), static_cast<int>(std::lround(h)));
+}
+
+} // namespace CCM
@@ -0,0 +1,140 @@
+#include "logger.hpp"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace CCM {
+
+static int64_t nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : ring_(1024) {}
+
+Logger::~Logger() {
+    stop();
+}
+
+void Logger::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) return;
+    writer_ = std::thread(&Logger::writerLoop, this);
+}
+
+void Logger::stop() {
+    if (!running_.exchange(false)) return;
+    if (writer_.joinable()) writer_.join();
+
+    // Anything pushed after the writer's last drain
+    Record rec;
+    while (ring_.try_pop(rec)) write(rec);
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+void Logger::log(LogLevel level, const char* tag, const char* fmt, ...) {
+    Record rec;
+    rec.timestamp_us = nowMicros();
+    rec.level = level;
+    std::strncpy(rec.tag, tag, sizeof(rec.tag) - 1);
+
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(rec.msg, sizeof(rec.msg), fmt, args);
+    va_end(args);
+
+    if (!running_.load(std::memory_order_acquire)) {
+        write(rec);
+        return;
+    }
+    if (!ring_.try_push(rec)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::writerLoop() {
+    Record rec;
+    while (running_.load(std::memory_order_acquire)) {
+        bool wrote = false;
+        while (ring_.try_pop(rec)) {
+            write(rec);
+            wrote = true;
+        }
+        if (wrote) {
+            std::fflush(stdout);
+            std::fflush(stderr);
+        } else {
+            // Producers never signal (that would cost them a syscall); poll instead
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+void Logger::write(const Record& rec) {
+    FILE* out = rec.level >= LogLevel::Warn ? stderr : stdout;
+
+    if (json_.load(std::memory_order_relaxed)) {
+        // Escape the message for JSON
+        char escaped[sizeof(rec.msg) * 2];
+        size_t j = 0;
+        for (size_t i = 0; rec.msg[i] != '\0' && j + 2 < sizeof(escaped); ++i) {
+            const char c = rec.msg[i];
+            if (c == '"' || c == '\\') {
+                escaped[j++] = '\\';
+                escaped[j++] = c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                escaped[j++] = ' ';
+            } else {
+                escaped[j++] = c;
+            }
+        }
+        escaped[j] = '\0';
+
+        std::fprintf(out, "{\"ts_us\":%lld,\"level\":\"%s\",\"tag\":\"%s\",\"msg\":\"%s\"}\n",
+                     static_cast<long long>(rec.timestamp_us), levelName(rec.level), rec.tag, escaped);
+        return;
+    }
+
+    const std::time_t secs = static_cast<std::time_t>(rec.timestamp_us / 1000000);
+    std::tm tm_buf;
+#ifdef _WIN32
+    localtime_s(&tm_buf, &secs);
+#else
+    localtime_r(&secs, &tm_buf);
+#endif
+    std::fprintf(out, "%02d:%02d:%02d.%03d [%s] [%s] %s\n",
+                 tm_buf.tm_hour, tm_buf.tm_min, tm_buf.tm_sec,
+                 static_cast<int>((rec.timestamp_us / 1000) % 1000),
+                 levelName(rec.level), rec.tag, rec.msg);
+}
+
+LogLevel Logger::parseLevel(const std::string& name, LogLevel fallback) {
+    if (name == "trace") return LogLevel::Trace;
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "info") return LogLevel::Info;
+    if (name == "warn") return LogLevel::Warn;
+    if (name == "error") return LogLevel::Error;
+    if (name == "off") return LogLevel::Off;
+    return fallback;
+}
+
+const char* Logger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "trace";
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warn: return "warn";
+        case LogLevel::Error: return "error";
+        default: return "off";
+    }
+}
+
+} // namespace CCM
@@ -1,12 +1,25 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <csignal>
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <opencv2/opencv.hpp>
+#include "batch_scheduler.hpp"
+#include "camera_input.hpp"
 #include "config.hpp"
+#include "config_store.hpp"
+#include "config_watcher.hpp"
 #include "detector.hpp"
-#include "overlay_renderer.hpp"
-#include "tracker.hpp" 
+#include "logger.hpp"
+#include "mat_pool.hpp"
+#include "metrics_exporter.hpp"
+#include "pipeline.hpp"
+#include "video_output.hpp"
+#include "zone_engine.hpp"
 
 // Global flag for the main loop
 std::atomic<bool> g_running(true);
@@ -34,7 +47,7 @@ int main(int argc, char** argv) {
     // Register Signal Handler
     std::signal(SIGINT, signal_handler);
 
-    std::cout << "[CCM Code] Initializing EdgeVision System..." << std::endl;
+    CCM_LOG_INFO("CCM Code", "Initializing EdgeVision System...");
 
     // Argument Parsing
     std::string config_path = "configs/zones.yaml"; // Default
@@ -46,7 +59,7 @@ int main(int argc, char** argv) {
         std::string arg = argv[i];
         if (arg == "--test") {
             test_mode = true;
-            std::cout << "[System] TEST MODE ENABLED." << std::endl;
+            CCM_LOG_INFO("System", "TEST MODE ENABLED.");
         } else if (arg == "--config" && i + 1 < argc) {
             config_path = argv[++i]; // Consume next arg
         } else if (arg == "--config_string") {
@@ -58,8 +71,7 @@ int main(int argc, char** argv) {
 
     // Load Configuration
     CCM::AppConfig config = CCM::AppConfig::load(config_path);
-    cv::FileStorage fs(config_path, cv::FileStorage::READ);
-    std::cout << "[System] Loading configuration from:  " << getAbsolutePath(config_path.c_str()) << std::endl;
+    CCM_LOG_INFO("System", "Loading configuration from:  %s", getAbsolutePath(config_path.c_str()).c_str());
 
     if(config_string){
         std::cout << "[Debug] Config Loaded:\n" << config.toString() << std::endl;
@@ -70,6 +82,25 @@ int main(int argc, char** argv) {
         std::cout << config.toJSON() << std::endl;
         return 0;
     }
+
+    // Same checks a live edit must pass (config_watcher): an invalid file does not start either
+    if (!config.validate()) {
+        CCM_LOG_ERROR("System", "Invalid configuration in %s", config_path.c_str());
+        return -1;
+    }
+
+    // Logging: explicit level wins, otherwise debug.enabled turns on per-box tracing
+    CCM::Logger& logger = CCM::Logger::instance();
+    logger.setLevel(CCM::Logger::parseLevel(config.logging.level,
+                                            config.debug.enabled ? CCM::LogLevel::Trace : CCM::LogLevel::Info));
+    logger.setJson(config.logging.json);
+    logger.start();
+
+    // Frame buffers, blobs and network outputs are recycled from here on
+    if (config.pipeline.mat_pool_mb > 0) {
+        CCM::MatPool::install(static_cast<size_t>(config.pipeline.mat_pool_mb) << 20);
+    }
+
     // Initialize Modules
     CCM::Detector* detector = nullptr;
     if (!test_mode) {
@@ -79,89 +110,145 @@ int main(int argc, char** argv) {
         
         std::ifstream f(model.c_str());
         if (!f.good()) {
-            std::cerr << "[Error] Model file not found: " << model << std::endl;
+            CCM_LOG_ERROR("Error", "Model file not found: %s", model.c_str());
+            return -1;
+        }
+        detector = new CCM::Detector(model, classes, config);
+        if (!detector->isReady()) {
+            CCM_LOG_ERROR("Error", "No inference backend could load %s", model.c_str());
+            delete detector;
             return -1;
         }
-        detector = new CCM::Detector(model, classes);
     }
 
-    // Initialize Tracker 
-    CCM::Tracker tracker(5, 50.0f); 
-    CCM::OverlayRenderer renderer;
-    
-    // Initialize Camera
-    std::cout << "[Camera] Opening index " << config.camera.index << "..." << std::endl;
-    cv::VideoCapture cap(config.camera.index); 
-    
-    if (!cap.isOpened()) {
-        std::cerr << "Error: Cannot open camera." << std::endl;
-        return -1;
+    // Initialize Cameras: one capture device and pipeline per `cameras:` entry
+    // Each stream reads its config through a ConfigStore so reloads reach it without a restart
+    std::vector<std::unique_ptr<CCM::ConfigStore>> stream_configs;
+    std::vector<std::unique_ptr<CCM::CameraInput>> cameras;
+    for (size_t i = 0; i < config.cameras.size(); ++i) {
+        stream_configs.emplace_back(new CCM::ConfigStore(config.forStream(i)));
+        const CCM::CameraConfig& cam = config.cameras[i];
+        CCM_LOG_INFO("Camera", "[%s] Opening index %d...", cam.name.c_str(), cam.index);
+        cameras.emplace_back(new CCM::CameraInput(cam));
+        if (!cameras.back()->open()) {
+            CCM_LOG_ERROR("Camera", "[%s] Cannot open camera.", cam.name.c_str());
+            return -1;
+        }
     }
 
-    // Apply Camera Settings
-    if (config.camera.force_mjpg) {
-        std::cout << "[Camera] Forcing MJPEG compression (WSL/Linux Mode)" << std::endl;
-        cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
-    }
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, config.camera.width);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, config.camera.height);
-    cap.set(cv::CAP_PROP_FPS, config.camera.fps);
-
-    cv::Mat frame;
-    
-    // Main Loop 
-    while (g_running) {
-        cap >> frame;
-        if (frame.empty()) {
-             std::cerr << "[Warning] Blank frame captured (Camera disconnected?)" << std::endl;
-             continue; // Don't crash, just retry
+    // Metrics: Prometheus/JSON endpoint and periodic summary
+    CCM::MetricsExporter metrics_exporter(config.metrics);
+    metrics_exporter.start();
+
+    // Main Loop: per camera, Capture -> Inference -> Track/Render run on separate threads.
+    // All cameras share the one Detector through the batch scheduler.
+    {
+        std::unique_ptr<CCM::BatchScheduler> scheduler;
+        if (detector) scheduler.reset(new CCM::BatchScheduler(*detector, config));
+
+        std::vector<std::unique_ptr<CCM::Pipeline>> pipelines;
+        for (size_t i = 0; i < cameras.size(); ++i) {
+            const int stream_id = scheduler ? scheduler->addStream(*stream_configs[i]) : static_cast<int>(i);
+            pipelines.emplace_back(new CCM::Pipeline(*stream_configs[i], *cameras[i], scheduler.get(), stream_id,
+                                                     test_mode));
         }
 
-        std::vector<CCM::Detection> detections;
-        
-        if (!test_mode && detector) {
-            // Pass the full config to the detector so it knows pixel_scale/swap_rb
-            detections = detector->detect(frame, config);
-
-            if (config.debug.enabled) {
-                std::cout << "[Main] detections this frame: " << detections.size() << std::endl;
-                for (const auto& d : detections) {
-                    std::cout << "  - class=" << d.className
-                            << " conf=" << d.confidence
-                            << " box=" << d.box << std::endl;
-                }
-            }
+        // Annotated video for remote viewers (MJPEG over HTTP, H.264 via ffmpeg)
+        CCM::VideoOutput video_output(config.output);
+        for (size_t i = 0; i < pipelines.size(); ++i) {
+            const CCM::CameraConfig& cam = config.cameras[i];
+            const int output_id = video_output.addStream(cam.name, cam.fps);
+            if (video_output.enabled()) pipelines[i]->setVideoOutput(&video_output, output_id);
         }
-        // Test Mode Simulation
-        else if (test_mode) {
-             static int x_pos = 0;
-             x_pos = (x_pos + 5) % config.camera.width;
-             CCM::Detection det;
-             det.class_id = 0;
-             det.className = "person (sim)";
-             det.confidence = 0.99f;
-             det.box = cv::Rect(x_pos, 100, 100, 200);
-             detections.push_back(det);
+        video_output.start();
+
+        // Zone and line-crossing events from every camera, drained here
+        std::unique_ptr<CCM::MpmcRing<CCM::ZoneEvent>> events;
+        if (config.events.enabled) {
+            const size_t capacity = static_cast<size_t>(std::max(2, config.events.queue_capacity));
+            events.reset(new CCM::MpmcRing<CCM::ZoneEvent>(capacity));
+            for (auto& p : pipelines) p->setEventQueue(events.get());
         }
+        auto drainEvents = [&events]() {
+            CCM::ZoneEvent event;
+            while (events && events->try_pop(event)) CCM_LOG_INFO("Event", "%s", event.toJSON().c_str());
+        };
+
+        // Hot reload: re-read the config file when it changes and publish new snapshots.
+        // Runs on the watcher thread; `running` is only touched there once the watcher started.
+        std::shared_ptr<const CCM::AppConfig> running = std::make_shared<const CCM::AppConfig>(config);
+        CCM::ConfigWatcher watcher(config_path, config.reload.debounce_ms, [&](CCM::AppConfig&& next) {
+            const CCM::ConfigChanges changes = CCM::diffConfig(*running, next);
+            if (!changes.any) return;
+            for (const auto& section : changes.restart) {
+                CCM_LOG_WARN("Config", "'%s' changed: takes effect after a restart", section.c_str());
+            }
+            CCM::keepStartupSettings(*running, next);
+
+            // Only a changed model / class list / input size pays for loading the network again
+            if (changes.model && detector) {
+                const std::string model = next.model_path.empty() ? "models/yolov5s.onnx" : next.model_path;
+                const std::string classes = next.class_names.empty() ? "models/coco.names" : next.class_names;
+                if (!detector->reload(model, classes, next)) {
+                    next.model_path = running->model_path;
+                    next.class_names = running->class_names;
+                    next.input_width = running->input_width;
+                    next.input_height = running->input_height;
+                    next.model = running->model;
+                    next.buildZoneIndex();
+                }
+            }
 
-        // Tracker & Renderer
-        std::vector<cv::Rect> boxes;
-        for(const auto& d : detections) boxes.push_back(d.box);
-        auto tracked_objects = tracker.update(boxes); 
-
-        renderer.draw(frame, detections, config);
+            logger.setLevel(CCM::Logger::parseLevel(next.logging.level,
+                                                    next.debug.enabled ? CCM::LogLevel::Trace : CCM::LogLevel::Info));
+            logger.setJson(next.logging.json);
 
-        cv::imshow("CCM EdgeVision | Professional Edition", frame);
-        
-        if (cv::waitKey(1) == 27) {
-            std::cout << "[System] ESC pressed. Exiting..." << std::endl;
-            g_running = false;
+            running = std::make_shared<const CCM::AppConfig>(std::move(next));
+            for (size_t i = 0; i < stream_configs.size(); ++i) {
+                stream_configs[i]->publish(std::make_shared<const CCM::AppConfig>(running->forStream(i)));
+            }
+            CCM_LOG_INFO("Config", "Reloaded %s", config_path.c_str());
+        });
+
+        if (scheduler) scheduler->start();
+        for (auto& p : pipelines) p->start(g_running);
+        if (config.reload.enabled) watcher.start();
+
+        // HighGUI stays on the main thread: show each stream's newest frame
+        while (g_running) {
+            bool any_active = false;
+            for (auto& p : pipelines) any_active = p->display() || any_active;
+            if (!any_active) break;
+            drainEvents();
+
+            if (!config.output.display) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));   // Headless: wait for Ctrl+C
+            } else if (cv::waitKey(1) == 27) {
+                CCM_LOG_INFO("System", "ESC pressed. Exiting...");
+                g_running = false;
+            }
         }
+        g_running = false;
+
+        watcher.stop();
+        for (auto& p : pipelines) p->stop();
+        drainEvents();
+        if (scheduler) scheduler->stop();
+        video_output.stop();
     }
 
+    metrics_exporter.stop();
+
     if (detector) delete detector;
-    cap.release();
-    cv::destroyAllWindows();
-    std::cout << "[System] Cleanup complete. Goodbye." << std::endl;
+    for (auto& camera : cameras) camera->close();
+    if (config.output.display) cv::destroyAllWindows();
+    if (config.pipeline.mat_pool_mb > 0) {
+        const CCM::MatPool& pool = CCM::MatPool::instance();
+        CCM_LOG_INFO("System", "cv::Mat pool: %llu buffers reused, %llu heap allocations",
+                     static_cast<unsigned long long>(pool.reuses()),
+                     static_cast<unsigned long long>(pool.allocations()));
+    }
+    CCM_LOG_INFO("System", "Cleanup complete. Goodbye.");
+    logger.stop();
     return 0;
 }
\ No newline at end of file
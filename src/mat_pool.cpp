@@ -0,0 +1,133 @@
+#include "mat_pool.hpp"
+#include <new>
+#include "logger.hpp"
+
+namespace CCM {
+
+// Empty size classes are dropped once this many accumulate (one-off crop sizes)
+static const size_t kMaxSizeClasses = 64;
+
+MatPool& MatPool::instance() {
+    static MatPool* pool = new MatPool();   // Leaked on purpose: Mats may be freed during static destruction
+    return *pool;
+}
+
+void MatPool::install(size_t max_cached_bytes) {
+    MatPool& pool = instance();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex_);
+        pool.max_cached_bytes_ = max_cached_bytes;
+    }
+    cv::Mat::setDefaultAllocator(&pool);
+    CCM_LOG_INFO("MatPool", "cv::Mat buffers are pooled (up to %zu MB cached)", max_cached_bytes >> 20);
+}
+
+cv::UMatData* MatPool::allocate(int dims, const int* sizes, int type, void* data0, size_t* step, cv::AccessFlag,
+                                cv::UMatUsageFlags) const {
+    // Same size / step computation as OpenCV's standard allocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; --i) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= static_cast<size_t>(sizes[i]);
+    }
+
+    void* data = data0;
+    void* header = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!data0) {
+            auto it = free_.find(total);
+            if (it != free_.end()) {
+                it->second.last_used = ++tick_;
+                if (!it->second.buffers.empty()) {
+                    data = it->second.buffers.back();
+                    it->second.buffers.pop_back();
+                    cached_bytes_ -= total;
+                }
+            }
+        }
+        if (!free_headers_.empty()) {
+            header = free_headers_.back();
+            free_headers_.pop_back();
+        }
+    }
+    if (!data) {
+        data = cv::fastMalloc(total);
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+    } else if (!data0) {
+        reuses_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!header) header = ::operator new(sizeof(cv::UMatData));
+
+    cv::UMatData* u = new (header) cv::UMatData(this);
+    u->data = u->origdata = static_cast<uchar*>(data);
+    u->size = total;
+    if (data0) u->flags |= cv::UMatData::USER_ALLOCATED;
+    return u;
+}
+
+bool MatPool::allocate(cv::UMatData* u, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return u != nullptr;
+}
+
+void MatPool::deallocate(cv::UMatData* u) const {
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+
+    void* data = (u->flags & cv::UMatData::USER_ALLOCATED) ? nullptr : u->origdata;
+    const size_t size = u->size;
+    u->~UMatData();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_headers_.push_back(u);
+    if (!data) return;
+
+    auto it = free_.find(size);
+    if (it == free_.end() && free_.size() >= kMaxSizeClasses) {
+        for (auto e = free_.begin(); e != free_.end();) {
+            if (e->second.buffers.empty()) e = free_.erase(e);
+            else ++e;
+        }
+    }
+    const bool full = it != free_.end() && it->second.buffers.size() >= kMaxPerSize;
+    if (full || !makeRoom(size, size)) {
+        if (it != free_.end()) it->second.last_used = ++tick_;
+        cv::fastFree(data);
+        return;
+    }
+    SizeClass& cls = it != free_.end() ? it->second : free_[size];
+    cls.buffers.push_back(data);
+    cls.last_used = ++tick_;
+    cached_bytes_ += size;
+}
+
+bool MatPool::makeRoom(size_t incoming, size_t keep) const {
+    while (cached_bytes_ + incoming > max_cached_bytes_) {
+        auto lru = free_.end();
+        for (auto e = free_.begin(); e != free_.end(); ++e) {
+            if (e->first == keep || e->second.buffers.empty()) continue;
+            if (lru == free_.end() || e->second.last_used < lru->second.last_used) lru = e;
+        }
+        if (lru == free_.end()) return false;   // Only this size is cached, or it exceeds the cap alone
+
+        for (void* buffer : lru->second.buffers) cv::fastFree(buffer);
+        cached_bytes_ -= lru->first * lru->second.buffers.size();
+        free_.erase(lru);
+    }
+    return true;
+}
+
+size_t MatPool::cachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cached_bytes_;
+}
+
+} // namespace CCM
@@ -0,0 +1,195 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace CCM {
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Capture: return "capture";
+        case Stage::Motion: return "motion";
+        case Stage::Preprocess: return "preprocess";
+        case Stage::Inference: return "inference";
+        case Stage::Decode: return "decode";
+        case Stage::NMS: return "nms";
+        case Stage::ZoneFilter: return "zone_filter";
+        case Stage::Track: return "track";
+        case Stage::Render: return "render";
+        case Stage::Output: return "output";
+        case Stage::Publish: return "publish";
+        case Stage::Encode: return "encode";
+        case Stage::EndToEnd: return "end_to_end";
+        default: return "unknown";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// LatencyHistogram
+// -----------------------------------------------------------------------------
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(uint64_t v) {
+    if (v < static_cast<uint64_t>(kSubBuckets)) return static_cast<int>(v);
+
+    int exponent = 63;
+    while (!(v & (uint64_t(1) << exponent))) --exponent;
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+
+    const int shift = exponent - kSubBucketBits;
+    const int mantissa = static_cast<int>(v >> shift) - kSubBuckets;
+    return kSubBuckets + shift * kSubBuckets + mantissa;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < kSubBuckets) return static_cast<uint64_t>(index);
+    const int shift = (index - kSubBuckets) / kSubBuckets;
+    const int mantissa = (index - kSubBuckets) % kSubBuckets;
+    return ((static_cast<uint64_t>(kSubBuckets + mantissa) + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    buckets_[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (micros > prev && !max_.compare_exchange_weak(prev, micros, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const {
+    Summary s;
+    s.count = count_.load(std::memory_order_relaxed);
+    if (s.count == 0) return s;
+
+    s.mean_us = static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(s.count);
+    s.max_us = static_cast<double>(max_.load(std::memory_order_relaxed));
+
+    const uint64_t t50 = (s.count * 50 + 99) / 100;
+    const uint64_t t95 = (s.count * 95 + 99) / 100;
+    const uint64_t t99 = (s.count * 99 + 99) / 100;
+
+    uint64_t seen = 0;
+    bool got50 = false, got95 = false;
+    for (int i = 0; i < kBucketCount; ++i) {
+        const uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+        if (n == 0) continue;
+        seen += n;
+        const double bound = std::min(static_cast<double>(bucketUpperBound(i)), s.max_us);
+        if (!got50 && seen >= t50) { s.p50_us = bound; got50 = true; }
+        if (!got95 && seen >= t95) { s.p95_us = bound; got95 = true; }
+        if (seen >= t99) { s.p99_us = bound; break; }
+    }
+    return s;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// Metrics
+// -----------------------------------------------------------------------------
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+void FpsMeter::tick(std::chrono::steady_clock::time_point now) {
+    if (started_) {
+        const double dt = std::chrono::duration<double>(now - last_).count();
+        if (dt > 0.0) {
+            // Exponential moving average over roughly the last 30 frames
+            const double instant = 1.0 / dt;
+            fps_ = fps_ == 0.0 ? instant : fps_ + (instant - fps_) / 30.0;
+        }
+    }
+    started_ = true;
+    last_ = now;
+}
+
+void Metrics::frameCompleted() {
+    std::lock_guard<std::mutex> lock(fps_mutex_);
+    frames_total_.fetch_add(1, std::memory_order_relaxed);
+    fps_meter_.tick();
+    fps_.store(fps_meter_.fps(), std::memory_order_relaxed);
+}
+
+std::string Metrics::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"fps\":" << fps() << ","
+        << "\"frames_total\":" << framesTotal() << ","
+        << "\"dropped_frames\":" << droppedFrames() << ","
+        << "\"capture_errors\":" << captureErrors() << ","
+        << "\"stages\":{";
+    for (int i = 0; i < static_cast<int>(Stage::Count); ++i) {
+        const auto s = histograms_[i].summary();
+        oss << "\"" << stageName(static_cast<Stage>(i)) << "\":{"
+            << "\"count\":" << s.count << ","
+            << "\"mean_ms\":" << s.mean_us / 1000.0 << ","
+            << "\"p50_ms\":" << s.p50_us / 1000.0 << ","
+            << "\"p95_ms\":" << s.p95_us / 1000.0 << ","
+            << "\"p99_ms\":" << s.p99_us / 1000.0 << ","
+            << "\"max_ms\":" << s.max_us / 1000.0
+            << "}";
+        if (i + 1 < static_cast<int>(Stage::Count)) oss << ",";
+    }
+    oss << "}}";
+    return oss.str();
+}
+
+std::string Metrics::toPrometheus() const {
+    std::ostringstream oss;
+    oss << "# HELP ccm_fps Rolling output frames per second\n"
+        << "# TYPE ccm_fps gauge\n"
+        << "ccm_fps " << fps() << "\n"
+        << "# HELP ccm_frames_total Frames delivered to the output stage\n"
+        << "# TYPE ccm_frames_total counter\n"
+        << "ccm_frames_total " << framesTotal() << "\n"
+        << "# HELP ccm_dropped_frames_total Frames discarded by pipeline backpressure\n"
+        << "# TYPE ccm_dropped_frames_total counter\n"
+        << "ccm_dropped_frames_total " << droppedFrames() << "\n"
+        << "# HELP ccm_capture_errors_total Failed or blank captures\n"
+        << "# TYPE ccm_capture_errors_total counter\n"
+        << "ccm_capture_errors_total " << captureErrors() << "\n"
+        << "# HELP ccm_stage_latency_seconds Per-stage latency quantiles\n"
+        << "# TYPE ccm_stage_latency_seconds summary\n";
+
+    for (int i = 0; i < static_cast<int>(Stage::Count); ++i) {
+        const auto s = histograms_[i].summary();
+        const char* name = stageName(static_cast<Stage>(i));
+        oss << "ccm_stage_latency_seconds{stage=\"" << name << "\",quantile=\"0.5\"} " << s.p50_us / 1e6 << "\n"
+            << "ccm_stage_latency_seconds{stage=\"" << name << "\",quantile=\"0.95\"} " << s.p95_us / 1e6 << "\n"
+            << "ccm_stage_latency_seconds{stage=\"" << name << "\",quantile=\"0.99\"} " << s.p99_us / 1e6 << "\n"
+            << "ccm_stage_latency_seconds_sum{stage=\"" << name << "\"} " << s.mean_us * s.count / 1e6 << "\n"
+            << "ccm_stage_latency_seconds_count{stage=\"" << name << "\"} " << s.count << "\n";
+    }
+    oss << "# HELP ccm_stage_latency_max_seconds Worst observed per-stage latency\n"
+        << "# TYPE ccm_stage_latency_max_seconds gauge\n";
+    for (int i = 0; i < static_cast<int>(Stage::Count); ++i) {
+        const auto s = histograms_[i].summary();
+        oss << "ccm_stage_latency_max_seconds{stage=\"" << stageName(static_cast<Stage>(i)) << "\"} "
+            << s.max_us / 1e6 << "\n";
+    }
+    return oss.str();
+}
+
+void Metrics::reset() {
+    for (auto& h : histograms_) h.reset();
+    {
+        std::lock_guard<std::mutex> lock(fps_mutex_);
+        fps_meter_.reset();
+    }
+    fps_.store(0.0, std::memory_order_relaxed);
+    frames_total_.store(0, std::memory_order_relaxed);
+    dropped_frames_.store(0, std::memory_order_relaxed);
+    capture_errors_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace CCM
@@ -0,0 +1,76 @@
+#include "metrics_exporter.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "logger.hpp"
+#include "metrics.hpp"
+
+namespace CCM {
+
+MetricsExporter::MetricsExporter(const MetricsConfig& config) : config_(config) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+void MetricsExporter::start() {
+    if (!config_.enabled) return;
+
+    if (config_.http_port > 0) {
+        server_.addRoute("/metrics", [](HttpConnection& conn) {
+            conn.sendResponse(200, "text/plain; version=0.0.4", Metrics::instance().toPrometheus());
+        });
+        server_.addRoute("/metrics.json", [](HttpConnection& conn) {
+            conn.sendResponse(200, "application/json", Metrics::instance().toJSON());
+        });
+        server_.start(config_.bind, config_.http_port);
+    }
+
+    if (config_.json_interval_s > 0) {
+        stopping_ = false;
+        report_thread_ = std::thread(&MetricsExporter::reportLoop, this);
+    }
+}
+
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (report_thread_.joinable()) report_thread_.join();
+    server_.stop();
+}
+
+void MetricsExporter::reportLoop() {
+    const auto interval = std::chrono::seconds(std::max(1, config_.json_interval_s));
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!cv_.wait_for(lock, interval, [this] { return stopping_; })) {
+        const Metrics& m = Metrics::instance();
+        const auto inference = m.histogram(Stage::Inference).summary();
+        const auto e2e = m.histogram(Stage::EndToEnd).summary();
+        CCM_LOG_INFO("Metrics", "fps=%.1f inference p50=%.1fms p95=%.1fms | e2e p95=%.1fms | dropped=%llu",
+                     m.fps(), inference.p50_us / 1000.0, inference.p95_us / 1000.0, e2e.p95_us / 1000.0,
+                     static_cast<unsigned long long>(m.droppedFrames()));
+
+        if (!config_.json_path.empty()) writeJsonFile();
+    }
+}
+
+void MetricsExporter::writeJsonFile() const {
+    const std::string tmp = config_.json_path + ".tmp";
+    {
+        std::ofstream ofs(tmp, std::ios::trunc);
+        if (!ofs) {
+            CCM_LOG_WARN("Metrics", "Cannot write %s", tmp.c_str());
+            return;
+        }
+        ofs << Metrics::instance().toJSON() << "\n";
+    }
+    if (std::rename(tmp.c_str(), config_.json_path.c_str()) != 0) {
+        CCM_LOG_WARN("Metrics", "Cannot rename %s to %s", tmp.c_str(), config_.json_path.c_str());
+    }
+}
+
+} // namespace CCM
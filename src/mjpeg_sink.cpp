@@ -0,0 +1,74 @@
+#include "mjpeg_sink.hpp"
+#include <string>
+
+namespace CCM {
+
+static const char* kBoundary = "frame";
+
+MjpegSink::MjpegSink(int jpeg_quality) : params_{cv::IMWRITE_JPEG_QUALITY, jpeg_quality} {}
+
+bool MjpegSink::encode(const cv::Mat& frame) {
+    if (!cv::imencode(".jpg", frame, buffer_, params_)) return true; // Skip the frame, keep serving
+
+    // Clients may still be sending the previous buffer: publish a new one instead of overwriting
+    Jpeg jpeg = std::make_shared<const std::vector<uchar>>(buffer_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latest_ = std::move(jpeg);
+        ++sequence_;
+    }
+    cv_.notify_all();
+    return true;
+}
+
+MjpegSink::Jpeg MjpegSink::waitForFrame(uint64_t& seen, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this, seen] { return sequence_ != seen; })) {
+        return nullptr;
+    }
+    seen = sequence_;
+    return latest_;
+}
+
+void MjpegSink::serveStream(HttpConnection& conn) {
+    clients_.fetch_add(1);
+    const std::string header = std::string("HTTP/1.1 200 OK\r\n"
+                                           "Content-Type: multipart/x-mixed-replace; boundary=") + kBoundary + "\r\n"
+                               "Cache-Control: no-cache\r\n"
+                               "Connection: close\r\n\r\n";
+
+    uint64_t seen = 0;
+    if (conn.send(header)) {
+        while (conn.isOpen()) {
+            // Short timeout so server shutdown is noticed even when the camera stalls
+            Jpeg jpeg = waitForFrame(seen, 500);
+            if (!jpeg) continue;
+
+            const std::string part = std::string("--") + kBoundary + "\r\n"
+                                     "Content-Type: image/jpeg\r\n"
+                                     "Content-Length: " + std::to_string(jpeg->size()) + "\r\n\r\n";
+            if (!conn.send(part) || !conn.send(jpeg->data(), jpeg->size()) || !conn.send("\r\n", 2)) break;
+        }
+    }
+    clients_.fetch_sub(1);
+}
+
+void MjpegSink::serveSnapshot(HttpConnection& conn) {
+    // Counts as a client so the encoder produces a fresh frame
+    clients_.fetch_add(1);
+    uint64_t seen;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        seen = sequence_;
+    }
+    Jpeg jpeg = waitForFrame(seen, 2000);
+    clients_.fetch_sub(1);
+
+    if (!jpeg) {
+        conn.sendResponse(503, "text/plain", "no frame available\n");
+        return;
+    }
+    conn.sendResponse(200, "image/jpeg", std::string(jpeg->begin(), jpeg->end()));
+}
+
+} // namespace CCM
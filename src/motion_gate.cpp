@@ -0,0 +1,36 @@
+#include "motion_gate.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace CCM {
+
+bool MotionGate::changed(const cv::Mat& frame, const MotionConfig& motion) {
+    if (frame.empty()) return true;
+
+    // Downsample first: the colour conversion and blur then touch a few thousand pixels
+    const int width = std::max(16, std::min(motion.width, frame.cols));
+    const cv::Size size(width, std::max(1, frame.rows * width / frame.cols));
+    cv::resize(frame, diff_, size, 0, 0, cv::INTER_AREA);
+    if (diff_.channels() == 3) {
+        cv::cvtColor(diff_, small_, cv::COLOR_BGR2GRAY);
+    } else {
+        diff_.copyTo(small_);
+    }
+    // Sensor noise and compression artefacts flicker single pixels; a 3x3 blur keeps them under the threshold
+    cv::blur(small_, small_, cv::Size(3, 3));
+
+    if (reference_.size() != small_.size() || reference_.type() != small_.type()) {
+        changed_fraction_ = 1.0;
+        return true;
+    }
+    cv::absdiff(small_, reference_, diff_);
+    cv::threshold(diff_, diff_, motion.pixel_threshold, 255, cv::THRESH_BINARY);
+    changed_fraction_ = static_cast<double>(cv::countNonZero(diff_)) / static_cast<double>(diff_.total());
+    return changed_fraction_ > motion.min_changed;
+}
+
+void MotionGate::markDetected() {
+    if (!small_.empty()) std::swap(small_, reference_);
+}
+
+} // namespace CCM
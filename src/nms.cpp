@@ -0,0 +1,181 @@
+#include "nms.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace CCM {
+
+NmsMethod parseNmsMethod(const std::string& name) {
+    if (name == "soft") return NmsMethod::Soft;
+    if (name == "matrix") return NmsMethod::Matrix;
+    return NmsMethod::Greedy;
+}
+
+void NmsEngine::run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                    const std::vector<int>& class_ids, const NmsParams& params, std::vector<int>& keep,
+                    std::vector<float>& keep_scores) {
+    keep.clear();
+    keep_scores.clear();
+    const int n = load(boxes, scores, class_ids, params);
+    if (n == 0) return;
+
+    switch (params.method) {
+        case NmsMethod::Greedy: greedy(n, params, keep, keep_scores); break;
+        case NmsMethod::Soft: soft(n, params, keep, keep_scores); break;
+        case NmsMethod::Matrix: matrix(n, params, keep, keep_scores); break;
+    }
+}
+
+int NmsEngine::load(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                    const std::vector<int>& class_ids, const NmsParams& params) {
+    // Same gate as cv::dnn::NMSBoxes (strictly above the threshold)
+    order_.clear();
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (scores[i] > params.score_threshold) order_.push_back(static_cast<int>(i));
+    }
+
+    // Best first; ties keep input order so results are deterministic (and match NMSBoxes)
+    auto better = [&scores](int a, int b) { return scores[a] > scores[b] || (scores[a] == scores[b] && a < b); };
+    if (params.top_k > 0 && static_cast<size_t>(params.top_k) < order_.size()) {
+        std::partial_sort(order_.begin(), order_.begin() + params.top_k, order_.end(), better);
+        order_.resize(static_cast<size_t>(params.top_k));
+    } else {
+        std::sort(order_.begin(), order_.end(), better);
+    }
+
+    // Class offset: past the largest coordinate, so shifted classes can never overlap
+    float extent = 0.0f;
+    if (params.per_class) {
+        for (int i : order_) extent = std::max(extent, static_cast<float>(std::max(boxes[i].br().x, boxes[i].br().y)));
+        extent += 1.0f;
+    }
+
+    const size_t n = order_.size();
+    x1_.resize(n);
+    y1_.resize(n);
+    x2_.resize(n);
+    y2_.resize(n);
+    area_.resize(n);
+    score_.resize(n);
+    iou_.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const int i = order_[k];
+        const cv::Rect& b = boxes[i];
+        const float offset = params.per_class ? static_cast<float>(class_ids[i]) * extent : 0.0f;
+        x1_[k] = static_cast<float>(b.x) + offset;
+        y1_[k] = static_cast<float>(b.y) + offset;
+        x2_[k] = static_cast<float>(b.x + b.width) + offset;
+        y2_[k] = static_cast<float>(b.y + b.height) + offset;
+        area_[k] = static_cast<float>(b.area());
+        score_[k] = scores[i];
+    }
+    return static_cast<int>(n);
+}
+
+void NmsEngine::iouRow(int i, int begin, int end) {
+    const float ax1 = x1_[i], ay1 = y1_[i], ax2 = x2_[i], ay2 = y2_[i], aarea = area_[i];
+    const float* x1 = x1_.data();
+    const float* y1 = y1_.data();
+    const float* x2 = x2_.data();
+    const float* y2 = y2_.data();
+    const float* area = area_.data();
+    float* iou = iou_.data();
+    int j = begin;
+
+#if CV_SIMD
+    const int lanes = cv::v_float32::nlanes;
+    const cv::v_float32 vx1 = cv::vx_setall_f32(ax1), vy1 = cv::vx_setall_f32(ay1);
+    const cv::v_float32 vx2 = cv::vx_setall_f32(ax2), vy2 = cv::vx_setall_f32(ay2);
+    const cv::v_float32 varea = cv::vx_setall_f32(aarea), zero = cv::vx_setzero_f32();
+    for (; j + lanes <= end; j += lanes) {
+        const cv::v_float32 w = cv::v_max(cv::v_min(vx2, cv::vx_load(x2 + j)) - cv::v_max(vx1, cv::vx_load(x1 + j)), zero);
+        const cv::v_float32 h = cv::v_max(cv::v_min(vy2, cv::vx_load(y2 + j)) - cv::v_max(vy1, cv::vx_load(y1 + j)), zero);
+        const cv::v_float32 inter = w * h;
+        cv::v_store(iou + j, inter / (varea + cv::vx_load(area + j) - inter));
+    }
+#endif
+    for (; j < end; ++j) {
+        const float w = std::max(std::min(ax2, x2[j]) - std::max(ax1, x1[j]), 0.0f);
+        const float h = std::max(std::min(ay2, y2[j]) - std::max(ay1, y1[j]), 0.0f);
+        const float inter = w * h;
+        iou[j] = inter / (aarea + area[j] - inter);
+    }
+}
+
+void NmsEngine::greedy(int n, const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores) {
+    suppressed_.assign(static_cast<size_t>(n), 0);
+    const size_t max_keep = params.max_detections > 0 ? static_cast<size_t>(params.max_detections) : order_.size();
+
+    for (int i = 0; i < n && keep.size() < max_keep; ++i) {
+        if (suppressed_[i]) continue;
+        keep.push_back(order_[i]);
+        keep_scores.push_back(score_[i]);
+
+        // Everything below i against box i in one vector pass, then a branch-free mark
+        iouRow(i, i + 1, n);
+        for (int j = i + 1; j < n; ++j) suppressed_[j] |= static_cast<uint8_t>(iou_[j] > params.iou_threshold);
+    }
+}
+
+void NmsEngine::soft(int n, const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores) {
+    const size_t max_keep = params.max_detections > 0 ? static_cast<size_t>(params.max_detections) : order_.size();
+    const float inv_sigma = 1.0f / std::max(params.sigma, 1e-6f);
+
+    for (int i = 0; i < n && keep.size() < max_keep; ++i) {
+        // Decayed scores reorder the tail: bring the best remaining box to position i
+        const int best = static_cast<int>(std::max_element(score_.begin() + i, score_.begin() + n) - score_.begin());
+        if (score_[best] <= params.score_threshold) break;
+        if (best != i) {
+            std::swap(order_[i], order_[best]);
+            std::swap(x1_[i], x1_[best]);
+            std::swap(y1_[i], y1_[best]);
+            std::swap(x2_[i], x2_[best]);
+            std::swap(y2_[i], y2_[best]);
+            std::swap(area_[i], area_[best]);
+            std::swap(score_[i], score_[best]);
+        }
+        keep.push_back(order_[i]);
+        keep_scores.push_back(score_[i]);
+
+        iouRow(i, i + 1, n);
+        for (int j = i + 1; j < n; ++j) score_[j] *= std::exp(-iou_[j] * iou_[j] * inv_sigma);
+    }
+}
+
+void NmsEngine::matrix(int n, const NmsParams& params, std::vector<int>& keep, std::vector<float>& keep_scores) {
+    // Two passes over the upper triangle, one row at a time (O(n) memory; bound n with top_k).
+    // 1. compensate_[i]: how much box i was itself overlapped by a better box
+    compensate_.assign(static_cast<size_t>(n), 0.0f);
+    for (int i = 0; i < n; ++i) {
+        iouRow(i, i + 1, n);
+        for (int j = i + 1; j < n; ++j) compensate_[j] = std::max(compensate_[j], iou_[j]);
+    }
+
+    // 2. Each box decays by its worst overlap with a better box, discounted when that box was
+    //    itself likely suppressed
+    const float inv_sigma = 1.0f / std::max(params.sigma, 1e-6f);
+    decay_.assign(static_cast<size_t>(n), 1.0f);
+    for (int i = 0; i < n; ++i) {
+        iouRow(i, i + 1, n);
+        const float comp = compensate_[i] * compensate_[i];
+        for (int j = i + 1; j < n; ++j) {
+            decay_[j] = std::min(decay_[j], std::exp((comp - iou_[j] * iou_[j]) * inv_sigma));
+        }
+    }
+
+    std::vector<int>& survivors = keep;   // Positions first, mapped to input indices below
+    for (int k = 0; k < n; ++k) {
+        score_[k] *= decay_[k];
+        if (score_[k] > params.score_threshold) survivors.push_back(k);
+    }
+    std::stable_sort(survivors.begin(), survivors.end(), [this](int a, int b) { return score_[a] > score_[b]; });
+    if (params.max_detections > 0 && survivors.size() > static_cast<size_t>(params.max_detections)) {
+        survivors.resize(static_cast<size_t>(params.max_detections));
+    }
+    for (int& k : survivors) {
+        keep_scores.push_back(score_[k]);
+        k = order_[k];
+    }
+}
+
+} // namespace CCM
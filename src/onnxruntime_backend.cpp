@@ -0,0 +1,141 @@
+#include "onnxruntime_backend.hpp"
+#include "logger.hpp"
+
+#ifdef CCM_WITH_ONNXRUNTIME
+#include <onnxruntime_cxx_api.h>
+#endif
+
+namespace CCM {
+
+#ifdef CCM_WITH_ONNXRUNTIME
+
+struct OnnxRuntimeBackend::Impl {
+    Ort::Env env{ORT_LOGGING_LEVEL_WARNING, "ccm_edgevision"};
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::unique_ptr<Ort::Session> session;
+
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    std::vector<const char*> input_name_ptrs;
+    std::vector<const char*> output_name_ptrs;
+
+    // Keeps the returned tensors alive so outputs can be cv::Mat views over them
+    std::vector<Ort::Value> last_outputs;
+
+    // FP16 models exported without float32 I/O (keep_io_types=False): converted at the boundary
+    bool half_input = false;
+    cv::Mat input_half;
+    std::vector<cv::Mat> converted_outputs;
+};
+
+OnnxRuntimeBackend::OnnxRuntimeBackend(int intra_op_threads, int inter_op_threads)
+    : intra_op_threads_(intra_op_threads), inter_op_threads_(inter_op_threads) {}
+
+OnnxRuntimeBackend::~OnnxRuntimeBackend() = default;
+
+bool OnnxRuntimeBackend::load(const std::string& model_path, const cv::Size& input_size) {
+    try {
+        impl_.reset(new Impl());
+
+        Ort::SessionOptions options;
+        options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        if (intra_op_threads_ > 0) options.SetIntraOpNumThreads(intra_op_threads_);
+        if (inter_op_threads_ > 0) {
+            options.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            options.SetInterOpNumThreads(inter_op_threads_);
+        }
+
+#ifdef _WIN32
+        const std::wstring path(model_path.begin(), model_path.end());
+        impl_->session.reset(new Ort::Session(impl_->env, path.c_str(), options));
+#else
+        impl_->session.reset(new Ort::Session(impl_->env, model_path.c_str(), options));
+#endif
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        for (size_t i = 0; i < impl_->session->GetInputCount(); ++i) {
+            impl_->input_names.push_back(impl_->session->GetInputNameAllocated(i, allocator).get());
+        }
+        for (size_t i = 0; i < impl_->session->GetOutputCount(); ++i) {
+            impl_->output_names.push_back(impl_->session->GetOutputNameAllocated(i, allocator).get());
+        }
+        impl_->half_input = impl_->session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType() ==
+                            ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+        for (const auto& n : impl_->input_names) impl_->input_name_ptrs.push_back(n.c_str());
+        for (const auto& n : impl_->output_names) impl_->output_name_ptrs.push_back(n.c_str());
+    } catch (const Ort::Exception& e) {
+        CCM_LOG_DEBUG("Backend", "onnxruntime: failed to load (%s)", e.what());
+        impl_.reset();
+        return false;
+    }
+
+    const int sizes[4] = {1, 3, input_size.height, input_size.width};
+    cv::Mat probe(4, sizes, CV_32F, cv::Scalar(0));
+    std::vector<cv::Mat> outputs;
+    return infer(probe, outputs) && !outputs.empty();
+}
+
+bool OnnxRuntimeBackend::infer(const cv::Mat& input, std::vector<cv::Mat>& outputs) {
+    outputs.clear();
+    if (!impl_ || !impl_->session || input.dims != 4 || !input.isContinuous()) return false;
+
+    const int64_t shape[4] = {input.size[0], input.size[1], input.size[2], input.size[3]};
+    try {
+        Ort::Value tensor = Ort::Value(nullptr);
+        if (impl_->half_input) {
+            input.convertTo(impl_->input_half, CV_16F);
+            tensor = Ort::Value::CreateTensor<Ort::Float16_t>(
+                impl_->memory_info, reinterpret_cast<Ort::Float16_t*>(impl_->input_half.data), input.total(), shape, 4);
+        } else {
+            tensor = Ort::Value::CreateTensor<float>(
+                impl_->memory_info, const_cast<float*>(input.ptr<float>()), input.total(), shape, 4);
+        }
+
+        impl_->last_outputs = impl_->session->Run(Ort::RunOptions{nullptr},
+                                                  impl_->input_name_ptrs.data(), &tensor, 1,
+                                                  impl_->output_name_ptrs.data(), impl_->output_name_ptrs.size());
+    } catch (const Ort::Exception& e) {
+        CCM_LOG_DEBUG("Backend", "onnxruntime: run failed (%s)", e.what());
+        return false;
+    }
+
+    impl_->converted_outputs.resize(impl_->last_outputs.size());
+    for (size_t i = 0; i < impl_->last_outputs.size(); ++i) {
+        Ort::Value& value = impl_->last_outputs[i];
+        const auto info = value.GetTensorTypeAndShapeInfo();
+        const std::vector<int64_t> dims = info.GetShape();
+        std::vector<int> sizes(dims.begin(), dims.end());
+        if (info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            cv::Mat half(static_cast<int>(sizes.size()), sizes.data(), CV_16F,
+                         value.GetTensorMutableData<Ort::Float16_t>());
+            half.convertTo(impl_->converted_outputs[i], CV_32F);
+            outputs.push_back(impl_->converted_outputs[i]);
+        } else {
+            outputs.emplace_back(static_cast<int>(sizes.size()), sizes.data(), CV_32F,
+                                 value.GetTensorMutableData<float>());
+        }
+    }
+    return true;
+}
+
+#else // Built without ONNX Runtime
+
+struct OnnxRuntimeBackend::Impl {};
+
+OnnxRuntimeBackend::OnnxRuntimeBackend(int intra_op_threads, int inter_op_threads)
+    : intra_op_threads_(intra_op_threads), inter_op_threads_(inter_op_threads) {}
+
+OnnxRuntimeBackend::~OnnxRuntimeBackend() = default;
+
+bool OnnxRuntimeBackend::load(const std::string&, const cv::Size&) {
+    CCM_LOG_WARN("Backend", "onnxruntime requested but this binary was built without CCM_WITH_ONNXRUNTIME.");
+    return false;
+}
+
+bool OnnxRuntimeBackend::infer(const cv::Mat&, std::vector<cv::Mat>&) {
+    return false;
+}
+
+#endif
+
+} // namespace CCM
@@ -0,0 +1,63 @@
+#include "opencv_dnn_backend.hpp"
+#include <algorithm>
+#include "logger.hpp"
+
+namespace CCM {
+
+OpenCvDnnBackend::OpenCvDnnBackend(const std::string& target, bool half) : target_(target) {
+    if (target == "cuda") {
+        dnn_backend_ = cv::dnn::DNN_BACKEND_CUDA;
+        dnn_target_ = half ? cv::dnn::DNN_TARGET_CUDA_FP16 : cv::dnn::DNN_TARGET_CUDA;
+    } else if (target == "openvino") {
+        dnn_backend_ = cv::dnn::DNN_BACKEND_INFERENCE_ENGINE;
+        dnn_target_ = cv::dnn::DNN_TARGET_CPU;
+    } else if (target == "vulkan") {
+        dnn_backend_ = cv::dnn::DNN_BACKEND_VKCOM;
+        dnn_target_ = cv::dnn::DNN_TARGET_VULKAN;
+    } else if (target == "opencl") {
+        dnn_backend_ = cv::dnn::DNN_BACKEND_OPENCV;
+        dnn_target_ = half ? cv::dnn::DNN_TARGET_OPENCL_FP16 : cv::dnn::DNN_TARGET_OPENCL;
+    } else {
+        target_ = "cpu";
+        dnn_backend_ = cv::dnn::DNN_BACKEND_OPENCV;
+        dnn_target_ = cv::dnn::DNN_TARGET_CPU;
+    }
+}
+
+bool OpenCvDnnBackend::load(const std::string& model_path, const cv::Size& input_size) {
+    const auto targets = cv::dnn::getAvailableTargets(static_cast<cv::dnn::Backend>(dnn_backend_));
+    if (std::find(targets.begin(), targets.end(), static_cast<cv::dnn::Target>(dnn_target_)) == targets.end()) {
+        CCM_LOG_DEBUG("Backend", "%s: not available in this OpenCV build.", name().c_str());
+        return false;
+    }
+
+    try {
+        net_ = cv::dnn::readNet(model_path);
+        if (net_.empty()) return false;
+        net_.setPreferableBackend(dnn_backend_);
+        net_.setPreferableTarget(dnn_target_);
+        output_names_ = net_.getUnconnectedOutLayersNames();
+
+        // Probe: backend initialisation happens on the first forward
+        const int sizes[4] = {1, 3, input_size.height, input_size.width};
+        cv::Mat probe(4, sizes, CV_32F, cv::Scalar(0));
+        std::vector<cv::Mat> outputs;
+        return infer(probe, outputs) && !outputs.empty();
+    } catch (const cv::Exception& e) {
+        CCM_LOG_DEBUG("Backend", "%s: failed to load (%s)", name().c_str(), e.what());
+        return false;
+    }
+}
+
+bool OpenCvDnnBackend::infer(const cv::Mat& input, std::vector<cv::Mat>& outputs) {
+    try {
+        net_.setInput(input);
+        net_.forward(outputs, output_names_);
+        return true;
+    } catch (const cv::Exception& e) {
+        CCM_LOG_DEBUG("Backend", "%s: forward failed (%s)", name().c_str(), e.what());
+        return false;
+    }
+}
+
+} // namespace CCM
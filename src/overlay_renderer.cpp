@@ -1,61 +1,175 @@
 #include "overlay_renderer.hpp"
+#include <algorithm>
+#include <cstring>
+#include "logger.hpp"
+#include "zone_index.hpp"
 
 namespace CCM {
 
-void OverlayRenderer::draw(cv::Mat& frame, const std::vector<Detection>& detections, const AppConfig& config) {
-    
-    // TEMP: raw visualization of everything that Detector spits out.
-    for (const auto& det : detections) {
-        cv::rectangle(frame, det.box, cv::Scalar(0, 255, 255), 2);
-        cv::putText(frame,
-                    det.className + " " + cv::format("%.2f", det.confidence),
-                    det.box.tl() + cv::Point(0, -5),
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    0.5,
-                    cv::Scalar(0, 255, 255),
-                    1);
-    }
-    
+// Drawn into the static layer twice: once in colour, once as its opacity mask (mask = true)
+void OverlayRenderer::drawStatic(cv::Mat& canvas, const AppConfig& config, bool mask) {
+    const cv::Scalar opaque(255);
+    auto color = [&](const cv::Scalar& c) { return mask ? opaque : c; };
+
     // 1. Draw Zones (The "Customization Package" feature)
     for (const auto& zone : config.zones) {
-        cv::rectangle(frame, zone.rect, zone.color, 2);
+        if (zone.polygon.empty()) {
+            cv::rectangle(canvas, zone.rect, color(zone.color), 2);
+        } else {
+            cv::polylines(canvas, zone.polygon, true, color(zone.color), 2);
+        }
         
         // Label background
         int baseline;
         cv::Size labelSize = cv::getTextSize(zone.name, cv::FONT_HERSHEY_SIMPLEX, 0.6, 1, &baseline);
-        cv::rectangle(frame, 
+        cv::rectangle(canvas, 
             cv::Point(zone.rect.x, zone.rect.y - labelSize.height - 5),
             cv::Point(zone.rect.x + labelSize.width, zone.rect.y),
-            zone.color, cv::FILLED);
+            color(zone.color), cv::FILLED);
             
-        cv::putText(frame, zone.name, {zone.rect.x, zone.rect.y - 5}, 
-                    cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0,0,0), 1);
+        cv::putText(canvas, zone.name, {zone.rect.x, zone.rect.y - 5}, 
+                    cv::FONT_HERSHEY_SIMPLEX, 0.6, color(cv::Scalar(0,0,0)), 1);
+    }
+
+    // Counting lines: segment plus name at its start point
+    for (const auto& line : config.lines) {
+        cv::line(canvas, line.a, line.b, color(line.color), 2);
+        cv::putText(canvas, line.name, line.a + cv::Point(4, -6),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.6, color(line.color), 1);
+    }
+}
+
+void OverlayRenderer::buildStaticLayer(const cv::Mat& frame, const AppConfig& config) {
+    layer_index_ = config.zone_index;
+    layer_size_ = frame.size();
+    layer_runs_.clear();
+    layer_pixels_.clear();
+    banner_glyphs_.clear();   // Zone names may have changed
+
+    cv::Mat layer = cv::Mat::zeros(frame.size(), frame.type());
+    cv::Mat mask = cv::Mat::zeros(frame.size(), CV_8UC1);
+    drawStatic(layer, config, false);
+    drawStatic(mask, config, true);
+
+    // Keep only the covered pixels, row run by row run, packed in drawing order
+    const size_t pixel_size = layer.elemSize();
+    for (int y = 0; y < mask.rows; ++y) {
+        const uchar* m = mask.ptr<uchar>(y);
+        for (int x = 0; x < mask.cols;) {
+            if (!m[x]) {
+                ++x;
+                continue;
+            }
+            const int x0 = x;
+            while (x < mask.cols && m[x]) ++x;
+            const uchar* src = layer.ptr<uchar>(y) + x0 * pixel_size;
+            layer_runs_.push_back({y, x0, x - x0, layer_pixels_.size()});
+            layer_pixels_.insert(layer_pixels_.end(), src, src + (x - x0) * pixel_size);
+        }
+    }
+    CCM_LOG_DEBUG("Overlay", "Static layer: %zu runs, %zu bytes", layer_runs_.size(), layer_pixels_.size());
+}
+
+OverlayRenderer::Glyph OverlayRenderer::renderGlyph(const std::string& text, double scale, int thickness) {
+    int baseline = 0;
+    const cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, scale, thickness, &baseline);
+    const int pad = thickness + 1;   // Strokes extend past the measured box by about half their width
+
+    Glyph glyph;
+    glyph.mask = cv::Mat1b(size.height + baseline + 2 * pad, size.width + 2 * pad, static_cast<uchar>(0));
+    glyph.origin = cv::Point(pad, pad + size.height);
+    glyph.advance = size.width;
+    cv::putText(glyph.mask, text, glyph.origin, cv::FONT_HERSHEY_SIMPLEX, scale, cv::Scalar(255), thickness);
+    return glyph;
+}
+
+const OverlayRenderer::Glyph& OverlayRenderer::cachedGlyph(std::unordered_map<std::string, Glyph>& cache,
+                                                           const std::string& text, double scale, int thickness) {
+    auto it = cache.find(text);
+    if (it != cache.end()) return it->second;
+    if (cache.size() >= 1024) cache.clear();   // Bounded; class and zone names are a small fixed set
+    return cache.emplace(text, renderGlyph(text, scale, thickness)).first->second;
+}
+
+void OverlayRenderer::blit(cv::Mat& frame, const Glyph& glyph, const cv::Point& origin, const cv::Scalar& color) {
+    const cv::Rect target(origin - glyph.origin, glyph.mask.size());
+    const cv::Rect clipped = target & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (clipped.area() == 0) return;
+    frame(clipped).setTo(color, glyph.mask(clipped - target.tl()));
+}
+
+void OverlayRenderer::draw(cv::Mat& frame, const std::vector<Detection>& detections, const AppConfig& config) {
+    // 1. Zones, zone labels and lines: prerendered, copied in run by run
+    if (frame.type() != CV_8UC3) {
+        drawStatic(frame, config, false);
+    } else {
+        if (layer_index_ != config.zone_index || layer_size_ != frame.size()) buildStaticLayer(frame, config);
+        const uint8_t* pixels = layer_pixels_.data();
+        for (const Run& run : layer_runs_) {
+            std::memcpy(frame.ptr<uchar>(run.y) + run.x * 3, pixels + run.offset, static_cast<size_t>(run.length) * 3);
+        }
+    }
+
+    if (percent_glyphs_.empty()) {
+        for (int pct = 0; pct <= 100; ++pct) {
+            percent_glyphs_.push_back(renderGlyph(" " + std::to_string(pct) + "%", 0.5, 2));
+        }
     }
 
     // 2. Draw Detections & Trigger Alerts
+    const ZoneIndex* zones = config.zone_index.get();
+    ZoneMask alerted;
     for (const auto& det : detections) {
         cv::Scalar box_color = cv::Scalar(0, 255, 0); // Default Green
         cv::Point center = (det.box.tl() + det.box.br()) / 2;
 
-        // Logic: Check if detection is inside a specialized zone
-        bool alert = false;
-        for (const auto& zone : config.zones) {
-            if (zone.rect.contains(center) && det.className == zone.trigger_class) {
-                box_color = cv::Scalar(0, 0, 255); // Red for alert
-                alert = true;
-                
-                // Alert Banner
-                cv::putText(frame, "ALERT: " + zone.name, {50, 50}, 
-                            cv::FONT_HERSHEY_SIMPLEX, 1.2, cv::Scalar(0,0,255), 3);
-            }
+        // Logic: Check if detection is inside a zone that triggers on its class (one raster lookup)
+        const ZoneMask hits = zones ? zones->alerts(center, det.class_id) : ZoneMask();
+        if (hits.any()) {
+            box_color = cv::Scalar(0, 0, 255); // Red for alert
+            alerted |= hits;
         }
 
         cv::rectangle(frame, det.box, box_color, 2);
-        
-        std::string label = det.className + " " + std::to_string(int(det.confidence * 100)) + "%";
-        cv::putText(frame, label, {det.box.x, det.box.y - 10}, 
-                    cv::FONT_HERSHEY_SIMPLEX, 0.5, box_color, 2);
+
+        // "<class> NN%" from cached glyphs
+        const Glyph& name = cachedGlyph(label_glyphs_, det.className, 0.5, 2);
+        const int pct = std::min(100, std::max(0, static_cast<int>(det.confidence * 100)));
+        const cv::Point origin(det.box.x, det.box.y - 10);
+        blit(frame, name, origin, box_color);
+        blit(frame, percent_glyphs_[pct], origin + cv::Point(name.advance, 0), box_color);
+    }
+
+    // Alert Banner: one line per alerting zone
+    if (alerted.any()) {
+        int y = 50;
+        for (size_t z = 0; z < zones->size(); ++z) {
+            if (!alerted.test(z)) continue;
+            const std::string& zone = zones->zone(z).name;
+            auto it = banner_glyphs_.find(zone);
+            if (it == banner_glyphs_.end()) {
+                it = banner_glyphs_.emplace(zone, renderGlyph("ALERT: " + zone, 1.2, 3)).first;
+            }
+            blit(frame, it->second, {50, y}, cv::Scalar(0, 0, 255));
+            y += 40;
+        }
     }
 }
 
+void OverlayRenderer::drawHeader(cv::Mat& frame, const Metrics& metrics, double fps, uint64_t dropped) {
+    const auto inference = metrics.histogram(Stage::Inference).summary();
+    const std::string text = cv::format("FPS %.1f | inference p50 %.1f ms  p95 %.1f ms | dropped %llu",
+                                        fps,
+                                        inference.p50_us / 1000.0,
+                                        inference.p95_us / 1000.0,
+                                        static_cast<unsigned long long>(dropped));
+
+    // Darkened strip across the top so the text stays readable on any scene
+    const cv::Rect bar(0, 0, frame.cols, std::min(24, frame.rows));
+    cv::Mat roi = frame(bar);
+    roi.convertTo(roi, -1, 0.35);
+
+    cv::putText(frame, text, {8, 17}, cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
+}
+
 } // namespace CCM
\ No newline at end of file
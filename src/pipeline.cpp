@@ -0,0 +1,294 @@
+#include "pipeline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "logger.hpp"
+#include "metrics.hpp"
+
+namespace CCM {
+
+static BackpressurePolicy parsePolicy(const std::string& name) {
+    if (name == "block") return BackpressurePolicy::Block;
+    if (name != "drop_oldest") {
+        CCM_LOG_WARN("Pipeline", "Unknown backpressure '%s', using drop_oldest.", name.c_str());
+    }
+    return BackpressurePolicy::DropOldest;
+}
+
+Pipeline::Pipeline(const ConfigStore& config, CameraInput& camera, BatchScheduler* scheduler, int stream_id,
+                   bool test_mode)
+    : store_(config),
+      startup_(config.snapshot()),
+      config_(*startup_),
+      camera_(camera),
+      scheduler_(scheduler),
+      stream_id_(stream_id),
+      test_mode_(test_mode),
+      window_name_("CCM EdgeVision | " + config_.camera.name),
+      tracker_(config_.tracker),
+      capture_queue_(static_cast<size_t>(std::max(1, config_.pipeline.queue_depth)),
+                     parsePolicy(config_.pipeline.backpressure)),
+      result_queue_(static_cast<size_t>(std::max(1, config_.pipeline.queue_depth)),
+                    parsePolicy(config_.pipeline.backpressure)),
+      display_queue_(1, BackpressurePolicy::DropOldest),
+      spare_detections_(static_cast<size_t>(std::max(1, config_.pipeline.queue_depth)) + 2,
+                        BackpressurePolicy::DropOldest) {
+    if (config_.shm.enabled) shm_ = std::make_unique<ShmPublisher>(config_.shm, config_.camera.name);
+}
+
+Pipeline::~Pipeline() {
+    stop();
+}
+
+void Pipeline::setVideoOutput(VideoOutput* output, int output_id) {
+    output_ = output;
+    output_id_ = output_id;
+}
+
+void Pipeline::setEventQueue(MpmcRing<ZoneEvent>* events) {
+    zone_engine_.reset(events ? new ZoneEngine(config_.camera.name, *events) : nullptr);
+}
+
+void Pipeline::start(std::atomic<bool>& running) {
+    CCM_LOG_INFO("Pipeline", "[%s] Starting (queue_depth=%zu, backpressure=%s)", name().c_str(),
+                 capture_queue_.capacity(), config_.pipeline.backpressure.c_str());
+
+    annotate_ = config_.output.display || output_ != nullptr;
+    capture_thread_ = std::thread(&Pipeline::captureLoop, this, std::ref(running));
+    inference_thread_ = std::thread(&Pipeline::inferenceLoop, this);
+    output_thread_ = std::thread(&Pipeline::outputLoop, this, std::ref(running));
+}
+
+bool Pipeline::display() {
+    FramePacket packet;
+    if (display_queue_.tryPop(packet)) {
+        CCM_TIMED_SCOPE(Stage::Output);
+        cv::imshow(window_name_, packet.frame);
+    }
+    return !finished_.load();
+}
+
+void Pipeline::stop() {
+    // Closing the queues unblocks any stage waiting on a full/empty queue.
+    capture_queue_.close();
+    result_queue_.close();
+    display_queue_.close();
+    spare_detections_.close();
+    const bool was_running = capture_thread_.joinable();
+    if (capture_thread_.joinable()) capture_thread_.join();
+    if (inference_thread_.joinable()) inference_thread_.join();
+    if (output_thread_.joinable()) output_thread_.join();
+    if (shm_) shm_->close();
+
+    if (was_running) {
+        CCM_LOG_INFO("Pipeline", "[%s] Stopped. Dropped frames: capture->inference=%zu, inference->output=%zu",
+                     name().c_str(), capture_queue_.dropped(), result_queue_.dropped());
+        if (motion_skipped_ > 0) {
+            CCM_LOG_INFO("Pipeline", "[%s] Motion gate: detector skipped on %llu of %llu frames", name().c_str(),
+                         static_cast<unsigned long long>(motion_skipped_),
+                         static_cast<unsigned long long>(frames_seen_));
+        }
+        if (zone_engine_) {
+            for (const auto& count : zone_engine_->lineCounts()) {
+                CCM_LOG_INFO("Pipeline", "[%s] Line '%s': in=%llu out=%llu", name().c_str(), count.name.c_str(),
+                             static_cast<unsigned long long>(count.in), static_cast<unsigned long long>(count.out));
+            }
+            if (zone_engine_->dropped() > 0) {
+                CCM_LOG_WARN("Pipeline", "[%s] %zu zone events dropped (event queue full)", name().c_str(),
+                             zone_engine_->dropped());
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Stage 1: Capture
+// -----------------------------------------------------------------------------
+void Pipeline::captureLoop(std::atomic<bool>& running) {
+    uint64_t frame_id = 0;
+
+    while (running) {
+        FramePacket packet;
+        const auto start = std::chrono::steady_clock::now();
+        // Converts straight out of the driver's mmap buffer into the packet's frame
+        if (!camera_.read(packet.frame)) {
+            Metrics::instance().addCaptureError();
+            CCM_LOG_WARN("Capture", "[%s] Blank frame captured (Camera disconnected?)", name().c_str());
+            continue; // Don't crash, just retry
+        }
+
+        packet.frame_id = frame_id++;
+        packet.captured_at = std::chrono::steady_clock::now();
+        Metrics::instance().record(Stage::Capture, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(packet.captured_at - start).count()));
+
+        if (!capture_queue_.push(std::move(packet))) break;
+    }
+
+    capture_queue_.close();
+}
+
+// -----------------------------------------------------------------------------
+// Stage 2: Preprocess + Inference
+// -----------------------------------------------------------------------------
+bool Pipeline::shouldDetect(const AppConfig& config, const cv::Mat& frame) {
+    const int interval = std::max(1, config.detection.every_n_frames);
+    bool detect = ++frames_since_detection_ >= interval;
+    ++frames_seen_;
+
+    // Nothing to predict from, or motion too fast for the constant-velocity model to coast
+    if (config.detection.adaptive &&
+        (active_tracks_.load(std::memory_order_relaxed) == 0 ||
+         max_track_speed_.load(std::memory_order_relaxed) > config.detection.adaptive_speed)) {
+        detect = true;
+    }
+
+    // Static scene: the last detections stand (tracks coast on their motion model), up to max_skip_frames
+    if (detect && config.motion.enabled) {
+        CCM_TIMED_SCOPE(Stage::Motion);
+        if (!motion_gate_.changed(frame, config.motion) &&
+            frames_since_detection_ < config.motion.max_skip_frames) {
+            ++motion_skipped_;
+            return false;
+        }
+        motion_gate_.markDetected();
+    }
+
+    if (detect) frames_since_detection_ = 0;
+    return detect;
+}
+
+void Pipeline::inferenceLoop() {
+    FramePacket packet;
+    int x_pos = 0;
+    std::shared_ptr<const AppConfig> live = startup_;
+    uint64_t live_version = 0;
+    frames_since_detection_ = std::max(1, config_.detection.every_n_frames); // First frame is always detected
+
+    while (capture_queue_.pop(packet)) {
+        store_.refresh(live, live_version);
+
+        // On skipped frames the output stage advances the tracks with their motion model
+        packet.detected = shouldDetect(*live, packet.frame);
+        if (test_mode_) x_pos = (x_pos + 5) % config_.camera.width;
+
+        // A list handed back by the output stage: written over in place, so its storage and
+        // class-name strings are reused instead of reallocated for every packet
+        spare_detections_.tryPop(packet.detections);
+
+        if (packet.detected && !test_mode_ && scheduler_) {
+            // Shared detector: the scheduler batches this frame with the other cameras' frames
+            // and filters it by this stream's zones
+            scheduler_->submit(stream_id_, packet.frame, packet.detections);
+
+            CCM_LOG_DEBUG("Main", "[%s] detections this frame: %zu", name().c_str(), packet.detections.size());
+            if (Logger::instance().enabled(LogLevel::Debug)) {
+                for (const auto& d : packet.detections) {
+                    CCM_LOG_DEBUG("Main", "  - class=%s conf=%.2f box=[%d x %d from (%d, %d)]",
+                                  d.className.c_str(), d.confidence,
+                                  d.box.width, d.box.height, d.box.x, d.box.y);
+                }
+            }
+        }
+        // Test Mode Simulation
+        else if (packet.detected && test_mode_) {
+            packet.detections.resize(1);
+            Detection& det = packet.detections[0];
+            det.class_id = 0;
+            det.className = "person (sim)";
+            det.confidence = 0.99f;
+            det.box = cv::Rect(x_pos, 100, 100, 200);
+        }
+        // Skipped frames keep the recycled contents: the output stage overwrites them with the tracks
+
+        if (!result_queue_.push(std::move(packet))) break;
+    }
+
+    result_queue_.close();
+}
+
+// -----------------------------------------------------------------------------
+// Stage 3: Tracking + Render (frames are shown by display() on the main thread)
+// -----------------------------------------------------------------------------
+void Pipeline::outputLoop(std::atomic<bool>& running) {
+    FramePacket packet;
+    std::vector<TrackedObject> tracked_objects;
+    Metrics& metrics = Metrics::instance();
+    std::shared_ptr<const AppConfig> live = startup_;
+    uint64_t live_version = 0;
+
+    while (running && result_queue_.pop(packet)) {
+        if (store_.refresh(live, live_version)) tracker_.configure(live->tracker);
+
+        // Tracker & Renderer
+        {
+            CCM_TIMED_SCOPE(Stage::Track);
+            // Into the persistent list: track storage and label strings are reused frame to frame
+            if (packet.detected) tracker_.update(packet.detections, tracked_objects);
+            else tracker_.predict(tracked_objects);
+
+            float max_speed = 0.0f;
+            for (const auto& t : tracked_objects) {
+                const cv::Point2f v = t.filter.velocity();
+                max_speed = std::max(max_speed, std::sqrt(v.x * v.x + v.y * v.y));
+            }
+            active_tracks_.store(static_cast<int>(tracked_objects.size()), std::memory_order_relaxed);
+            max_track_speed_.store(max_speed, std::memory_order_relaxed);
+
+            if (zone_engine_) zone_engine_->update(*live, tracked_objects, packet.frame_id, packet.captured_at);
+
+            // Skipped frame: draw the predicted positions of tracks that were confirmed at the last detection
+            if (!packet.detected) {
+                size_t count = 0;
+                for (const auto& t : tracked_objects) {
+                    if (t.lost_frames > 0) continue;
+                    if (count == packet.detections.size()) packet.detections.emplace_back();
+                    Detection& det = packet.detections[count++];
+                    det.class_id = t.class_id;
+                    det.className = t.className;
+                    det.confidence = t.confidence;
+                    det.box = t.rect;
+                }
+                packet.detections.resize(count);
+            }
+        }
+
+        // Raw frame for out-of-process readers, before the overlay is drawn into it
+        if (shm_) {
+            CCM_TIMED_SCOPE(Stage::Publish);
+            shm_->publish(packet.frame_id, packet.captured_at, packet.frame, tracked_objects, packet.detected);
+        }
+
+        // Per-stream rate and drops for this camera's header; Metrics keeps the combined figures
+        stream_fps_.tick();
+        const size_t drops = capture_queue_.dropped() + result_queue_.dropped();
+
+        // Nobody looks at the annotated frame when headless without video sinks
+        if (annotate_) {
+            CCM_TIMED_SCOPE(Stage::Render);
+            renderer_.draw(packet.frame, packet.detections, *live);
+            if (config_.metrics.enabled && config_.metrics.overlay) {
+                renderer_.drawHeader(packet.frame, metrics, stream_fps_.fps(), drops);
+            }
+        }
+
+        metrics.record(Stage::EndToEnd, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - packet.captured_at).count()));
+        metrics.frameCompleted();
+        metrics.addDroppedFrames(drops - reported_drops_);
+        reported_drops_ = drops;
+
+        // Encoded on the sinks' own threads; only the copy happens here
+        if (output_) output_->submit(output_id_, packet.frame);
+
+        // Detection list back to the inference stage for a later packet (the window only needs the frame)
+        spare_detections_.push(std::move(packet.detections));
+
+        // Shown by the main thread (HighGUI); if it falls behind only the newest frame is kept
+        if (config_.output.display && !display_queue_.push(std::move(packet))) break;
+    }
+
+    finished_ = true;
+}
+
+} // namespace CCM
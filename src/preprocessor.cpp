@@ -0,0 +1,168 @@
+#include "preprocessor.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include "logger.hpp"
+
+namespace CCM {
+
+// YOLOv5 letterbox fill (grey 114), before pixel scaling
+static const float kPadValue = 114.0f;
+
+LetterboxInfo LetterboxInfo::fit(const cv::Size& frame_size, const cv::Size& input_size) {
+    LetterboxInfo info;
+    info.frame_size = frame_size;
+    info.input_size = input_size;
+    const float r = std::min(static_cast<float>(input_size.width) / frame_size.width,
+                             static_cast<float>(input_size.height) / frame_size.height);
+    info.scale_x = info.scale_y = r;
+    const int new_w = std::min(input_size.width, static_cast<int>(std::lround(frame_size.width * r)));
+    const int new_h = std::min(input_size.height, static_cast<int>(std::lround(frame_size.height * r)));
+    info.pad_x = (input_size.width - new_w) / 2;
+    info.pad_y = (input_size.height - new_h) / 2;
+    return info;
+}
+
+LetterboxInfo LetterboxInfo::stretch(const cv::Size& frame_size, const cv::Size& input_size) {
+    LetterboxInfo info;
+    info.frame_size = frame_size;
+    info.input_size = input_size;
+    info.scale_x = static_cast<float>(input_size.width) / frame_size.width;
+    info.scale_y = static_cast<float>(input_size.height) / frame_size.height;
+    return info;
+}
+
+#if CV_SIMD
+// 16 (or 32/64) uint8 lanes -> scaled floats at dst[0 .. v_uint8::nlanes)
+static inline void storeScaled(float* dst, const cv::v_uint8& v, const cv::v_float32& scale) {
+    const int n = cv::v_float32::nlanes;
+    cv::v_uint16 lo, hi;
+    cv::v_expand(v, lo, hi);
+    cv::v_uint32 a, b, c, d;
+    cv::v_expand(lo, a, b);
+    cv::v_expand(hi, c, d);
+    cv::v_store(dst, cv::v_cvt_f32(cv::v_reinterpret_as_s32(a)) * scale);
+    cv::v_store(dst + n, cv::v_cvt_f32(cv::v_reinterpret_as_s32(b)) * scale);
+    cv::v_store(dst + 2 * n, cv::v_cvt_f32(cv::v_reinterpret_as_s32(c)) * scale);
+    cv::v_store(dst + 3 * n, cv::v_cvt_f32(cv::v_reinterpret_as_s32(d)) * scale);
+}
+#endif
+
+// One output row: padding + deinterleave + scale into three planes
+static void packRow(const cv::Mat& img, int y, int width, int pad_x, int pad_y, float scale, float pad_value,
+                    float* dst_b, float* dst_g, float* dst_r) {
+    const size_t row_offset = static_cast<size_t>(y) * width;
+    dst_b += row_offset;
+    dst_g += row_offset;
+    dst_r += row_offset;
+
+    const int sy = y - pad_y;
+    if (sy < 0 || sy >= img.rows) {
+        std::fill(dst_b, dst_b + width, pad_value);
+        std::fill(dst_g, dst_g + width, pad_value);
+        std::fill(dst_r, dst_r + width, pad_value);
+        return;
+    }
+
+    const int right = pad_x + img.cols;
+    std::fill(dst_b, dst_b + pad_x, pad_value);
+    std::fill(dst_g, dst_g + pad_x, pad_value);
+    std::fill(dst_r, dst_r + pad_x, pad_value);
+    std::fill(dst_b + right, dst_b + width, pad_value);
+    std::fill(dst_g + right, dst_g + width, pad_value);
+    std::fill(dst_r + right, dst_r + width, pad_value);
+
+    const uchar* src = img.ptr<uchar>(sy);
+    float* b = dst_b + pad_x;
+    float* g = dst_g + pad_x;
+    float* r = dst_r + pad_x;
+    int x = 0;
+
+#if CV_SIMD
+    const int lanes = cv::v_uint8::nlanes;
+    const cv::v_float32 vscale = cv::vx_setall_f32(scale);
+    for (; x + lanes <= img.cols; x += lanes) {
+        cv::v_uint8 vb, vg, vr;
+        cv::v_load_deinterleave(src + 3 * x, vb, vg, vr);
+        storeScaled(b + x, vb, vscale);
+        storeScaled(g + x, vg, vscale);
+        storeScaled(r + x, vr, vscale);
+    }
+#endif
+    for (; x < img.cols; ++x) {
+        b[x] = src[3 * x] * scale;
+        g[x] = src[3 * x + 1] * scale;
+        r[x] = src[3 * x + 2] * scale;
+    }
+}
+
+void Preprocessor::ensureTensor(int batch, const cv::Size& input_size) {
+    const int sizes[4] = {batch, 3, input_size.height, input_size.width};
+    tensor_.create(4, sizes, CV_32F); // No-op when the shape is unchanged
+}
+
+void Preprocessor::packImage(const cv::Mat& frame, int batch_index, float scale, bool swap_rb, bool letterbox,
+                             LetterboxInfo& info) {
+    const cv::Size input_size(tensor_.size[3], tensor_.size[2]);
+    float* base = tensor_.ptr<float>(batch_index);
+    const size_t plane = static_cast<size_t>(input_size.area());
+
+    const cv::Mat* src = &frame;
+    if (frame.type() != CV_8UC3) {
+        if (frame.type() == CV_8UC1) cv::cvtColor(frame, converted_, cv::COLOR_GRAY2BGR);
+        else if (frame.type() == CV_8UC4) cv::cvtColor(frame, converted_, cv::COLOR_BGRA2BGR);
+        else {
+            CCM_LOG_WARN("Preprocess", "Unsupported frame type %d, expected 8-bit BGR.", frame.type());
+            std::fill(base, base + 3 * plane, 0.0f);
+            info = LetterboxInfo::stretch(frame.size(), input_size);
+            return;
+        }
+        src = &converted_;
+    }
+
+    info = letterbox ? LetterboxInfo::fit(frame.size(), input_size) : LetterboxInfo::stretch(frame.size(), input_size);
+    const cv::Size content = letterbox
+        ? cv::Size(std::min(input_size.width, static_cast<int>(std::lround(frame.cols * info.scale_x))),
+                   std::min(input_size.height, static_cast<int>(std::lround(frame.rows * info.scale_y))))
+        : input_size;
+
+    const cv::Mat* img = src;
+    if (src->size() != content) {
+        cv::resize(*src, resized_, content, 0, 0, cv::INTER_LINEAR);
+        img = &resized_;
+    }
+
+    // Plane order is RGB when swap_rb is set, BGR otherwise
+    float* dst_b = base + (swap_rb ? 2 : 0) * plane;
+    float* dst_g = base + plane;
+    float* dst_r = base + (swap_rb ? 0 : 2) * plane;
+    const float pad_value = kPadValue * scale;
+    const int width = input_size.width;
+    const int pad_x = info.pad_x;
+    const int pad_y = info.pad_y;
+
+    cv::parallel_for_(cv::Range(0, input_size.height), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            packRow(*img, y, width, pad_x, pad_y, scale, pad_value, dst_b, dst_g, dst_r);
+        }
+    }, input_size.height / 16.0);
+}
+
+const cv::Mat& Preprocessor::run(const cv::Mat& frame, const cv::Size& input_size, float scale, bool swap_rb,
+                                 bool letterbox, LetterboxInfo& info) {
+    ensureTensor(1, input_size);
+    packImage(frame, 0, scale, swap_rb, letterbox, info);
+    return tensor_;
+}
+
+const cv::Mat& Preprocessor::runBatch(const std::vector<cv::Mat>& frames, const cv::Size& input_size, float scale,
+                                      bool swap_rb, bool letterbox, std::vector<LetterboxInfo>& infos) {
+    ensureTensor(static_cast<int>(frames.size()), input_size);
+    infos.resize(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        packImage(frames[i], static_cast<int>(i), scale, swap_rb, letterbox, infos[i]);
+    }
+    return tensor_;
+}
+
+} // namespace CCM
@@ -0,0 +1,278 @@
+// Accuracy-vs-speed report for a quantized (INT8 / FP16) model against the FP32 baseline.
+// Both models run over the same image folder through Detector; the FP32 detections are
+// treated as ground truth, so no labels are needed.
+//
+// Usage: ccm_quant_report --images <dir> --reference <fp32.onnx> --candidate <int8.onnx> [options]
+//   --config <path>       Config to load (default configs/zones.yaml): thresholds, input size, backend
+//   --precision <p>       Precision of the candidate: "int8" (default) or "fp16"
+//   --max-images <n>      Images to evaluate (default 200)
+//   --iou <t>             IoU for a candidate box to agree with a reference box (default 0.5)
+//   --runs <n>            Timed passes over the images per model (default 1)
+//   --output <path>       Write the JSON report to a file (always printed to stdout)
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "config.hpp"
+#include "detector.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+using namespace CCM;
+
+struct ReportOptions {
+    std::string images;
+    std::string reference;
+    std::string candidate;
+    std::string config_path = "configs/zones.yaml";
+    std::string precision = "int8";
+    std::string output_path;
+    int max_images = 200;
+    float iou = 0.5f;
+    int runs = 1;
+};
+
+// Everything measured for one model
+struct ModelRun {
+    std::string backend;
+    std::vector<std::vector<Detection>> detections;   // per image (from the first pass)
+    LatencyHistogram::Summary inference;
+    double detect_mean_ms = 0.0;                      // preprocess + inference + decode + NMS
+    size_t boxes = 0;
+};
+
+static bool parseArgs(int argc, char** argv, ReportOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--images" && has_value) opt.images = argv[++i];
+        else if (arg == "--reference" && has_value) opt.reference = argv[++i];
+        else if (arg == "--candidate" && has_value) opt.candidate = argv[++i];
+        else if (arg == "--config" && has_value) opt.config_path = argv[++i];
+        else if (arg == "--precision" && has_value) opt.precision = argv[++i];
+        else if (arg == "--output" && has_value) opt.output_path = argv[++i];
+        else if (arg == "--max-images" && has_value) opt.max_images = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--iou" && has_value) opt.iou = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--runs" && has_value) opt.runs = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+    return !opt.images.empty() && !opt.reference.empty() && !opt.candidate.empty();
+}
+
+static std::vector<cv::Mat> loadImages(const std::string& dir, int max_images) {
+    std::vector<cv::Mat> images;
+    std::vector<std::string> files;
+    try {
+        cv::glob(dir + "/*", files, false);
+    } catch (const cv::Exception&) {
+        return images;
+    }
+    for (const auto& f : files) {
+        if (static_cast<int>(images.size()) >= max_images) break;
+        cv::Mat img = cv::imread(f, cv::IMREAD_COLOR);
+        if (!img.empty()) images.push_back(img);
+    }
+    return images;
+}
+
+static float iou(const cv::Rect& a, const cv::Rect& b) {
+    const float inter = static_cast<float>((a & b).area());
+    const float uni = static_cast<float>(a.area() + b.area()) - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+static bool runModel(const std::string& model, const AppConfig& config, const std::vector<cv::Mat>& images,
+                     int runs, ModelRun& out) {
+    Detector detector(model, config.class_names, config);
+    if (!detector.isReady()) return false;
+    out.backend = detector.backendName();
+
+    // Warm-up outside the measurement (first passes allocate and initialise the backend)
+    for (size_t i = 0; i < std::min<size_t>(3, images.size()); ++i) detector.detect(images[i], config);
+    Metrics::instance().reset();
+
+    double total_ms = 0.0;
+    out.detections.assign(images.size(), std::vector<Detection>());
+    for (int r = 0; r < runs; ++r) {
+        for (size_t i = 0; i < images.size(); ++i) {
+            const auto t0 = std::chrono::steady_clock::now();
+            std::vector<Detection> dets = detector.detect(images[i], config);
+            total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            if (r == 0) out.detections[i] = std::move(dets);
+        }
+    }
+
+    out.inference = Metrics::instance().histogram(Stage::Inference).summary();
+    out.detect_mean_ms = total_ms / (static_cast<double>(images.size()) * runs);
+    for (const auto& d : out.detections) out.boxes += d.size();
+    return true;
+}
+
+/**
+ * @brief Agreement of the candidate with the reference, which stands in for ground truth.
+ * map50 is the class-aware average precision of the candidate boxes at `iou_threshold`
+ * (all-point interpolation); 1.0 means the quantized model reproduces every FP32 box.
+ */
+struct Agreement {
+    double map50 = 0.0;
+    double precision = 0.0;
+    double recall = 0.0;
+    double mean_iou = 0.0;
+    double mean_conf_delta = 0.0;
+    size_t matched = 0;
+};
+
+static Agreement compare(const ModelRun& reference, const ModelRun& candidate, float iou_threshold) {
+    Agreement a;
+    struct Scored { float confidence; bool tp; };
+    std::vector<Scored> scored;
+    double iou_sum = 0.0;
+    double conf_delta_sum = 0.0;
+
+    for (size_t img = 0; img < reference.detections.size(); ++img) {
+        const auto& ref = reference.detections[img];
+        std::vector<Detection> cand = candidate.detections[img];
+        std::sort(cand.begin(), cand.end(),
+                  [](const Detection& x, const Detection& y) { return x.confidence > y.confidence; });
+
+        // Greedy by confidence, one reference box per candidate (standard VOC/COCO matching)
+        std::vector<bool> used(ref.size(), false);
+        for (const auto& c : cand) {
+            int best = -1;
+            float best_iou = iou_threshold;
+            for (size_t r = 0; r < ref.size(); ++r) {
+                if (used[r] || ref[r].class_id != c.class_id) continue;
+                const float v = iou(c.box, ref[r].box);
+                if (v >= best_iou) {
+                    best_iou = v;
+                    best = static_cast<int>(r);
+                }
+            }
+            scored.push_back({c.confidence, best >= 0});
+            if (best >= 0) {
+                used[best] = true;
+                ++a.matched;
+                iou_sum += best_iou;
+                conf_delta_sum += std::abs(c.confidence - ref[best].confidence);
+            }
+        }
+    }
+
+    if (candidate.boxes > 0) a.precision = static_cast<double>(a.matched) / candidate.boxes;
+    if (reference.boxes > 0) a.recall = static_cast<double>(a.matched) / reference.boxes;
+    if (a.matched > 0) {
+        a.mean_iou = iou_sum / a.matched;
+        a.mean_conf_delta = conf_delta_sum / a.matched;
+    }
+    if (reference.boxes == 0) {
+        a.map50 = candidate.boxes == 0 ? 1.0 : 0.0;
+        return a;
+    }
+
+    std::sort(scored.begin(), scored.end(),
+              [](const Scored& x, const Scored& y) { return x.confidence > y.confidence; });
+    std::vector<double> prec(scored.size()), rec(scored.size());
+    size_t tp = 0;
+    for (size_t i = 0; i < scored.size(); ++i) {
+        if (scored[i].tp) ++tp;
+        prec[i] = static_cast<double>(tp) / (i + 1);
+        rec[i] = static_cast<double>(tp) / reference.boxes;
+    }
+    // Precision envelope, then area under the stepwise PR curve
+    for (size_t i = scored.size(); i-- > 1;) prec[i - 1] = std::max(prec[i - 1], prec[i]);
+    double prev_recall = 0.0;
+    for (size_t i = 0; i < scored.size(); ++i) {
+        a.map50 += (rec[i] - prev_recall) * prec[i];
+        prev_recall = rec[i];
+    }
+    return a;
+}
+
+static void writeRun(cv::FileStorage& fs, const char* key, const std::string& path, const ModelRun& run) {
+    fs << key << "{"
+       << "model" << path
+       << "backend" << run.backend
+       << "boxes" << static_cast<int>(run.boxes)
+       << "inference_p50_ms" << run.inference.p50_us / 1000.0
+       << "inference_p95_ms" << run.inference.p95_us / 1000.0
+       << "inference_mean_ms" << run.inference.mean_us / 1000.0
+       << "detect_mean_ms" << run.detect_mean_ms
+       << "}";
+}
+
+int main(int argc, char** argv) {
+    ReportOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "Usage: ccm_quant_report --images <dir> --reference fp32.onnx --candidate int8.onnx\n"
+                     "                        [--config path] [--precision int8|fp16] [--max-images n]\n"
+                     "                        [--iou 0.5] [--runs n] [--output report.json]\n";
+        return 1;
+    }
+
+    Logger& logger = Logger::instance();
+    logger.setLevel(LogLevel::Warn);
+    logger.start();
+
+    AppConfig config = AppConfig::load(opt.config_path);
+    if (config.class_names.empty()) config.class_names = "models/coco.names";
+
+    std::vector<cv::Mat> images = loadImages(opt.images, opt.max_images);
+    if (images.empty()) {
+        CCM_LOG_ERROR("QuantReport", "No images could be read from %s", opt.images.c_str());
+        logger.stop();
+        return 1;
+    }
+
+    // Same thresholds and backend choice for both; only the weights' precision differs
+    AppConfig reference_config = config;
+    reference_config.model.precision = "fp32";
+    AppConfig candidate_config = config;
+    candidate_config.model.precision = opt.precision;
+
+    ModelRun reference, candidate;
+    if (!runModel(opt.reference, reference_config, images, opt.runs, reference) ||
+        !runModel(opt.candidate, candidate_config, images, opt.runs, candidate)) {
+        logger.stop();
+        return 1;
+    }
+
+    const Agreement agreement = compare(reference, candidate, opt.iou);
+    const double speedup = candidate.inference.mean_us > 0.0 ? reference.inference.mean_us / candidate.inference.mean_us
+                                                             : 0.0;
+
+    cv::FileStorage fs(".json", cv::FileStorage::WRITE | cv::FileStorage::MEMORY | cv::FileStorage::FORMAT_JSON);
+    fs << "images" << static_cast<int>(images.size())
+       << "precision" << opt.precision
+       << "iou_threshold" << opt.iou
+       << "confidence_threshold" << config.confidence_threshold;
+    writeRun(fs, "fp32", opt.reference, reference);
+    writeRun(fs, "quantized", opt.candidate, candidate);
+    fs << "agreement" << "{"
+       << "map50_proxy" << agreement.map50
+       << "precision" << agreement.precision
+       << "recall" << agreement.recall
+       << "matched_boxes" << static_cast<int>(agreement.matched)
+       << "mean_iou" << agreement.mean_iou
+       << "mean_confidence_delta" << agreement.mean_conf_delta
+       << "}";
+    fs << "inference_speedup" << speedup;
+    const std::string report = fs.releaseAndGetString();
+
+    std::cout << report << std::endl;
+    if (!opt.output_path.empty()) {
+        std::ofstream ofs(opt.output_path, std::ios::trunc);
+        ofs << report;
+        if (!ofs) CCM_LOG_ERROR("QuantReport", "Cannot write report to %s", opt.output_path.c_str());
+    }
+
+    logger.stop();
+    return 0;
+}
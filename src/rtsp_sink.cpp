@@ -0,0 +1,141 @@
+#include "rtsp_sink.hpp"
+#include <algorithm>
+#include <vector>
+#include "logger.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace CCM {
+
+RtspSink::RtspSink(const std::string& url, int fps, int bitrate_kbps, const std::string& ffmpeg)
+    : url_(url), fps_(std::max(1, fps)), bitrate_kbps_(std::max(100, bitrate_kbps)), ffmpeg_(ffmpeg) {}
+
+RtspSink::~RtspSink() {
+    close();
+}
+
+#ifndef _WIN32
+
+bool RtspSink::launch(const cv::Size& size) {
+    std::vector<std::string> args = {
+        ffmpeg_, "-hide_banner", "-loglevel", "error",
+        // Frames arrive at a variable rate (the encoder thread skips when busy): stamp them on arrival
+        "-use_wallclock_as_timestamps", "1",
+        "-f", "rawvideo", "-pix_fmt", "bgr24", "-video_size", std::to_string(size.width) + "x" + std::to_string(size.height),
+        "-i", "pipe:0",
+        "-c:v", "libx264", "-preset", "ultrafast", "-tune", "zerolatency", "-pix_fmt", "yuv420p",
+        "-b:v", std::to_string(bitrate_kbps_) + "k", "-g", std::to_string(fps_ * 2),
+    };
+    if (url_.compare(0, 7, "rtsp://") == 0) {
+        args.insert(args.end(), {"-f", "rtsp", "-rtsp_transport", "tcp"});
+    } else if (url_.compare(0, 6, "udp://") == 0 || url_.compare(0, 6, "srt://") == 0) {
+        args.insert(args.end(), {"-f", "mpegts"});
+    }
+    args.push_back(url_);
+
+    // Built before fork(): the child of a multithreaded process must not allocate
+    std::vector<char*> argv;
+    for (auto& a : args) argv.push_back(&a[0]);
+    argv.push_back(nullptr);
+
+    // Close-on-exec, so other sinks' ffmpeg children do not inherit (and hold open) this pipe;
+    // dup2() onto stdin clears the flag for the child's own copy
+    int fds[2];
+#ifdef __linux__
+    if (pipe2(fds, O_CLOEXEC) != 0) return false;
+#else
+    if (pipe(fds) != 0) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+    // A dying ffmpeg must surface as EPIPE on write, not kill the whole process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        dup2(fds[0], STDIN_FILENO);
+        ::close(fds[0]);
+        ::close(fds[1]);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+
+    ::close(fds[0]);
+    pipe_fd_ = fds[1];
+    pid_ = pid;
+    size_ = size;
+    CCM_LOG_INFO("Output", "H.264 stream %dx%d -> %s (ffmpeg pid %d)", size.width, size.height, url_.c_str(), pid);
+    return true;
+}
+
+bool RtspSink::encode(const cv::Mat& frame) {
+    if (frame.empty() || frame.type() != CV_8UC3) return true;
+    if (pid_ < 0 && !launch(frame.size())) {
+        CCM_LOG_ERROR("Output", "Cannot start %s for %s", ffmpeg_.c_str(), url_.c_str());
+        return false;
+    }
+    if (frame.size() != size_) {
+        CCM_LOG_WARN("Output", "Frame size changed to %dx%d; H.264 stream expects %dx%d, frame dropped",
+                     frame.cols, frame.rows, size_.width, size_.height);
+        return true;
+    }
+
+    // Rows may be padded (ROI); write them one by one in that case
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    const int chunks = frame.isContinuous() ? 1 : frame.rows;
+    const size_t chunk_bytes = frame.isContinuous() ? row_bytes * frame.rows : row_bytes;
+    for (int r = 0; r < chunks; ++r) {
+        const uchar* p = frame.ptr<uchar>(r);
+        size_t left = chunk_bytes;
+        while (left > 0) {
+            const ssize_t n = write(pipe_fd_, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                CCM_LOG_ERROR("Output", "ffmpeg exited (stream %s)", url_.c_str());
+                return false;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+    }
+    return true;
+}
+
+void RtspSink::close() {
+    if (pipe_fd_ >= 0) {
+        ::close(pipe_fd_);   // EOF lets ffmpeg flush and exit
+        pipe_fd_ = -1;
+    }
+    if (pid_ > 0) {
+        int status = 0;
+        waitpid(pid_, &status, 0);
+        pid_ = -1;
+    }
+}
+
+#else // _WIN32
+
+bool RtspSink::launch(const cv::Size&) { return false; }
+
+bool RtspSink::encode(const cv::Mat&) {
+    CCM_LOG_WARN("Output", "H.264/RTSP output is not available on Windows builds.");
+    return false;
+}
+
+void RtspSink::close() {}
+
+#endif
+
+} // namespace CCM
@@ -0,0 +1,100 @@
+// Minimal consumer of the shared-memory frame bus: prints throughput, skipped frames, capture-to-read
+// latency and the newest frame's detections once per second. Links only ccm_shm_reader (no OpenCV),
+// so it doubles as an example for out-of-process readers.
+//
+// Usage: ccm_shm_dump [segment] [--seconds N] [--copy]
+//   segment    Shared-memory name (default /ccm_cam0, i.e. shm.name "/ccm_{name}" for camera "cam0")
+//   --seconds  Stop after N seconds (default: run until the publisher exits)
+//   --copy     Use readLatest() (consistent copy) instead of zero-copy views
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "shm_reader.hpp"
+
+using namespace CCM;
+
+int main(int argc, char** argv) {
+    std::string segment = "/ccm_cam0";
+    int seconds = 0;
+    bool copy = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) seconds = std::atoi(argv[++i]);
+        else if (arg == "--copy") copy = true;
+        else segment = arg;
+    }
+
+    ShmReader reader(segment);
+    while (!reader.open()) {
+        std::fprintf(stderr, "Waiting for %s (%s)\n", segment.c_str(), reader.error().c_str());
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    std::printf("%s: stream '%s', %u slots x %u bytes, up to %u detections\n", segment.c_str(),
+                reader.header()->stream_name, reader.header()->slot_count, reader.header()->slot_size,
+                reader.header()->max_detections);
+
+    using Clock = std::chrono::steady_clock;
+    const auto started = Clock::now();
+    auto window_start = started;
+    uint64_t last_index = reader.published();
+    uint64_t frames = 0, skipped = 0, torn = 0;
+    double latency_sum_ms = 0.0;
+    std::vector<uint8_t> pixels;
+    std::vector<ShmDetection> detections;
+    ShmFrame frame;
+
+    while (seconds <= 0 || Clock::now() - started < std::chrono::seconds(seconds)) {
+        if (!reader.waitFor(last_index, 1000)) {
+            if (!reader.writerAlive()) {
+                std::printf("Publisher exited.\n");
+                break;
+            }
+            continue;
+        }
+
+        bool ok = false;
+        if (copy) {
+            ok = reader.readLatest(frame, pixels, detections, last_index);
+        } else if (reader.latest(frame, last_index)) {
+            // A real consumer would process frame.pixels in place here (e.g. wrap them in a cv::Mat);
+            // the records are small, keep a copy for printing
+            detections.assign(frame.detections, frame.detections + frame.detection_count);
+            ok = reader.validate(frame);
+            frame.detections = detections.data();
+        }
+        if (!ok) {
+            ++torn;
+            last_index = reader.published() > 0 ? reader.published() - 1 : 0;
+            continue;
+        }
+
+        skipped += frame.index - last_index - 1;
+        last_index = frame.index;
+        ++frames;
+        latency_sum_ms += std::chrono::duration<double, std::milli>(Clock::now().time_since_epoch()).count() -
+                          frame.timestamp_ns / 1e6;
+
+        const auto now = Clock::now();
+        if (now - window_start >= std::chrono::seconds(1)) {
+            const double dt = std::chrono::duration<double>(now - window_start).count();
+            std::printf("%.1f fps | skipped %llu | torn %llu | capture->read %.2f ms | frame %llu %dx%d | %u objects",
+                        frames / dt, static_cast<unsigned long long>(skipped), static_cast<unsigned long long>(torn),
+                        latency_sum_ms / frames, static_cast<unsigned long long>(frame.frame_id), frame.width,
+                        frame.height, frame.detection_count);
+            for (uint32_t d = 0; d < frame.detection_count && d < 4; ++d) {
+                const ShmDetection& r = frame.detections[d];
+                std::printf(" [#%d cls %d %.2f %d,%d %dx%d]", r.track_id, r.class_id, r.confidence, r.x, r.y,
+                            r.width, r.height);
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+            window_start = now;
+            frames = skipped = torn = 0;
+            latency_sum_ms = 0.0;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "shm_publisher.hpp"
+#include <algorithm>
+#include <cstring>
+#include "logger.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace CCM {
+
+static size_t alignUp(size_t v, size_t a) {
+    return (v + a - 1) / a * a;
+}
+
+ShmPublisher::ShmPublisher(const ShmConfig& config, const std::string& stream_name)
+    : config_(config), stream_name_(stream_name) {
+    segment_name_ = config.name;
+    const size_t pos = segment_name_.find("{name}");
+    if (pos != std::string::npos) segment_name_.replace(pos, 6, stream_name);
+    // POSIX shm names are "/name" with no further slashes
+    std::replace(segment_name_.begin() + (segment_name_.empty() ? 0 : 1), segment_name_.end(), '/', '_');
+    if (segment_name_.empty() || segment_name_[0] != '/') segment_name_.insert(0, "/");
+}
+
+ShmPublisher::~ShmPublisher() {
+    close();
+}
+
+#ifndef _WIN32
+
+bool ShmPublisher::create(const cv::Mat& frame) {
+    const size_t frame_bytes = std::max<size_t>(static_cast<size_t>(std::max(config_.max_width, frame.cols)) *
+                                                    static_cast<size_t>(std::max(config_.max_height, frame.rows)) *
+                                                    frame.elemSize(),
+                                                1);
+    const size_t max_detections = static_cast<size_t>(std::max(1, config_.max_detections));
+    const size_t slots = static_cast<size_t>(std::max(2, config_.slots));
+
+    const size_t detections_offset = sizeof(ShmSlotHeader);
+    const size_t pixels_offset = alignUp(detections_offset + max_detections * sizeof(ShmDetection), 64);
+    const size_t slot_size = alignUp(pixels_offset + frame_bytes, 64);
+    if (slot_size > UINT32_MAX) {
+        CCM_LOG_ERROR("ShmBus", "[%s] Slot of %zu bytes is too large; lower shm.max_width/max_height",
+                      stream_name_.c_str(), slot_size);
+        return false;
+    }
+    size_ = sizeof(ShmHeader) + slots * slot_size;
+
+    // A segment left behind by a crashed run may have another size; readers still mapping it keep their copy
+    shm_unlink(segment_name_.c_str());
+    const int fd = shm_open(segment_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        CCM_LOG_ERROR("ShmBus", "[%s] shm_open(%s) failed: %s", stream_name_.c_str(), segment_name_.c_str(),
+                      std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+        CCM_LOG_ERROR("ShmBus", "[%s] Cannot size %s to %zu bytes: %s", stream_name_.c_str(),
+                      segment_name_.c_str(), size_, std::strerror(errno));
+        ::close(fd);
+        shm_unlink(segment_name_.c_str());
+        return false;
+    }
+    base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base_ == MAP_FAILED) {
+        CCM_LOG_ERROR("ShmBus", "[%s] mmap of %s failed: %s", stream_name_.c_str(), segment_name_.c_str(),
+                      std::strerror(errno));
+        base_ = nullptr;
+        shm_unlink(segment_name_.c_str());
+        return false;
+    }
+
+    // Fresh segments are zero-filled: every slot sequence starts at 0 (even, empty)
+    header_ = static_cast<ShmHeader*>(base_);
+    header_->version = kShmVersion;
+    header_->header_size = sizeof(ShmHeader);
+    header_->slot_count = static_cast<uint32_t>(slots);
+    header_->slot_size = static_cast<uint32_t>(slot_size);
+    header_->max_detections = static_cast<uint32_t>(max_detections);
+    header_->max_frame_bytes = static_cast<uint32_t>(slot_size - pixels_offset);
+    header_->detections_offset = static_cast<uint32_t>(detections_offset);
+    header_->pixels_offset = static_cast<uint32_t>(pixels_offset);
+    header_->writer_pid = static_cast<int32_t>(getpid());
+    std::strncpy(header_->stream_name, stream_name_.c_str(), sizeof(header_->stream_name) - 1);
+    header_->writer_alive.store(1, std::memory_order_relaxed);
+    // Readers check the magic first: publish it only after everything else is in place
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, kShmMagic, sizeof(kShmMagic));
+
+    CCM_LOG_INFO("ShmBus", "[%s] Publishing to %s (%zu slots x %.1f MB)", stream_name_.c_str(),
+                 segment_name_.c_str(), slots, slot_size / (1024.0 * 1024.0));
+    return true;
+}
+
+bool ShmPublisher::publish(uint64_t frame_id, std::chrono::steady_clock::time_point captured_at, const cv::Mat& frame,
+                           const std::vector<TrackedObject>& tracks, bool detected) {
+    if (failed_ || frame.empty()) return false;
+    if (!header_ && !create(frame)) {
+        failed_ = true;
+        return false;
+    }
+
+    char* slot = static_cast<char*>(base_) + header_->header_size +
+                 (write_index_ % header_->slot_count) * static_cast<size_t>(header_->slot_size);
+    auto* meta = reinterpret_cast<ShmSlotHeader*>(slot);
+
+    // Seqlock write: odd sequence -> payload -> even sequence
+    const uint64_t seq = meta->sequence.load(std::memory_order_relaxed);
+    meta->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t row_bytes = static_cast<size_t>(frame.cols) * frame.elemSize();
+    const bool fits = row_bytes * static_cast<size_t>(frame.rows) <= header_->max_frame_bytes;
+    if (!fits && !warned_oversize_) {
+        CCM_LOG_WARN("ShmBus", "[%s] %dx%d frame exceeds the slot size; publishing detections only",
+                     stream_name_.c_str(), frame.cols, frame.rows);
+        warned_oversize_ = true;
+    }
+
+    meta->frame_id = frame_id;
+    meta->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(captured_at.time_since_epoch()).count();
+    meta->width = static_cast<uint32_t>(frame.cols);
+    meta->height = static_cast<uint32_t>(frame.rows);
+    meta->step = static_cast<uint32_t>(row_bytes);
+    meta->type = frame.type();
+    meta->flags = (detected ? kShmDetected : 0u) | (fits ? 0u : kShmNoPixels);
+
+    auto* records = reinterpret_cast<ShmDetection*>(slot + header_->detections_offset);
+    uint32_t count = 0;
+    for (const auto& t : tracks) {
+        if (t.lost_frames > 0) continue;
+        if (count == header_->max_detections) break;
+        ShmDetection& r = records[count++];
+        r.x = t.rect.x;
+        r.y = t.rect.y;
+        r.width = t.rect.width;
+        r.height = t.rect.height;
+        r.confidence = t.confidence;
+        r.class_id = t.class_id;
+        r.track_id = t.id;
+        r.reserved = 0;
+    }
+    meta->detection_count = count;
+
+    if (fits) {
+        char* pixels = slot + header_->pixels_offset;
+        if (frame.isContinuous()) {
+            std::memcpy(pixels, frame.data, row_bytes * frame.rows);
+        } else {
+            for (int y = 0; y < frame.rows; ++y) std::memcpy(pixels + y * row_bytes, frame.ptr(y), row_bytes);
+        }
+    }
+
+    meta->sequence.store(seq + 2, std::memory_order_release);
+    header_->write_index.store(++write_index_, std::memory_order_release);
+    return true;
+}
+
+void ShmPublisher::close() {
+    if (!base_) return;
+    header_->writer_alive.store(0, std::memory_order_release);
+    munmap(base_, size_);
+    shm_unlink(segment_name_.c_str());
+    base_ = nullptr;
+    header_ = nullptr;
+    CCM_LOG_INFO("ShmBus", "[%s] Closed %s after %llu frames", stream_name_.c_str(), segment_name_.c_str(),
+                 static_cast<unsigned long long>(write_index_));
+}
+
+#else
+
+bool ShmPublisher::create(const cv::Mat&) {
+    CCM_LOG_ERROR("ShmBus", "The shared-memory frame bus is only available on Linux/POSIX.");
+    return false;
+}
+
+bool ShmPublisher::publish(uint64_t, std::chrono::steady_clock::time_point, const cv::Mat& frame,
+                           const std::vector<TrackedObject>&, bool) {
+    if (failed_ || frame.empty()) return false;
+    failed_ = !create(frame);
+    return false;
+}
+
+void ShmPublisher::close() {}
+
+#endif
+
+} // namespace CCM
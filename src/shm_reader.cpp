@@ -0,0 +1,184 @@
+#include "shm_reader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CCM {
+
+ShmReader::ShmReader(const std::string& segment_name) : name_(segment_name) {
+    if (name_.empty() || name_[0] != '/') name_.insert(0, "/");
+}
+
+ShmReader::~ShmReader() {
+    close();
+}
+
+#ifndef _WIN32
+
+bool ShmReader::open() {
+    close();
+    const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error_ = "shm_open(" + name_ + "): " + std::strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmHeader)) {
+        error_ = name_ + " is not initialised yet";
+        ::close(fd);
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    base_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base_ == MAP_FAILED) {
+        error_ = "mmap(" + name_ + "): " + std::strerror(errno);
+        base_ = nullptr;
+        return false;
+    }
+
+    const auto* header = static_cast<const ShmHeader*>(base_);
+    if (std::memcmp(header->magic, kShmMagic, sizeof(kShmMagic)) != 0) {
+        error_ = name_ + " is not a CCM frame bus (or not initialised yet)";
+        close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->version != kShmVersion) {
+        error_ = name_ + ": layout version " + std::to_string(header->version) + ", expected " +
+                 std::to_string(kShmVersion);
+        close();
+        return false;
+    }
+    if (header->slot_count == 0 ||
+        size_ < header->header_size + static_cast<size_t>(header->slot_count) * header->slot_size) {
+        error_ = name_ + ": truncated segment";
+        close();
+        return false;
+    }
+    header_ = header;
+    error_.clear();
+    return true;
+}
+
+void ShmReader::close() {
+    if (base_) munmap(base_, size_);
+    base_ = nullptr;
+    header_ = nullptr;
+    size_ = 0;
+}
+
+bool ShmReader::writerAlive() const {
+    if (!header_ || header_->writer_alive.load(std::memory_order_acquire) == 0) return false;
+    // A crashed publisher never clears writer_alive
+    return kill(header_->writer_pid, 0) == 0 || errno == EPERM;
+}
+
+#else
+
+bool ShmReader::open() {
+    error_ = "The shared-memory frame bus is only available on Linux/POSIX";
+    return false;
+}
+
+void ShmReader::close() {}
+
+bool ShmReader::writerAlive() const {
+    return false;
+}
+
+#endif
+
+uint64_t ShmReader::published() const {
+    return header_ ? header_->write_index.load(std::memory_order_acquire) : 0;
+}
+
+bool ShmReader::latest(ShmFrame& view, uint64_t after_index) const {
+    if (!header_) return false;
+
+    // A few attempts: a torn read means the publisher lapped us, and the next newest slot is free again
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const uint64_t index = header_->write_index.load(std::memory_order_acquire);
+        if (index == 0 || index <= after_index) return false;
+
+        const uint32_t slot_index = static_cast<uint32_t>((index - 1) % header_->slot_count);
+        const char* slot = static_cast<const char*>(base_) + header_->header_size +
+                           static_cast<size_t>(slot_index) * header_->slot_size;
+        const auto* meta = reinterpret_cast<const ShmSlotHeader*>(slot);
+
+        const uint64_t seq = meta->sequence.load(std::memory_order_acquire);
+        if (seq & 1) continue;
+
+        view.index = index;
+        view.frame_id = meta->frame_id;
+        view.timestamp_ns = meta->timestamp_ns;
+        view.width = static_cast<int>(meta->width);
+        view.height = static_cast<int>(meta->height);
+        view.step = static_cast<int>(meta->step);
+        view.type = meta->type;
+        view.flags = meta->flags;
+        view.detection_count = std::min(meta->detection_count, header_->max_detections);
+        view.detections = reinterpret_cast<const ShmDetection*>(slot + header_->detections_offset);
+        view.pixels = (view.flags & kShmNoPixels) ? nullptr
+                                                  : reinterpret_cast<const uint8_t*>(slot + header_->pixels_offset);
+        view.sequence = seq;
+        view.slot = slot_index;
+        if (validate(view)) return true;
+    }
+    return false;
+}
+
+bool ShmReader::validate(const ShmFrame& view) const {
+    if (!header_) return false;
+    const char* slot = static_cast<const char*>(base_) + header_->header_size +
+                       static_cast<size_t>(view.slot) * header_->slot_size;
+    const auto* meta = reinterpret_cast<const ShmSlotHeader*>(slot);
+    // Order the caller's reads of the slot before the re-check of the sequence
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return meta->sequence.load(std::memory_order_relaxed) == view.sequence;
+}
+
+bool ShmReader::readLatest(ShmFrame& frame, std::vector<uint8_t>& pixels, std::vector<ShmDetection>& detections,
+                           uint64_t after_index) const {
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        ShmFrame view;
+        if (!latest(view, after_index)) return false;
+
+        const size_t bytes = view.pixels ? static_cast<size_t>(view.step) * view.height : 0;
+        if (bytes > header_->max_frame_bytes) continue;   // Torn metadata
+        pixels.resize(bytes);
+        detections.resize(view.detection_count);
+        if (bytes) std::memcpy(pixels.data(), view.pixels, bytes);
+        if (view.detection_count) {
+            std::memcpy(detections.data(), view.detections, view.detection_count * sizeof(ShmDetection));
+        }
+        if (!validate(view)) continue;
+
+        frame = view;
+        frame.pixels = bytes ? pixels.data() : nullptr;
+        frame.detections = detections.data();
+        return true;
+    }
+    return false;
+}
+
+bool ShmReader::waitFor(uint64_t after_index, int timeout_ms) const {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (published() <= after_index) {
+        if (!writerAlive() || std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace CCM
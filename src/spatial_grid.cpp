@@ -0,0 +1,83 @@
+#include "spatial_grid.hpp"
+#include <algorithm>
+
+namespace CCM {
+
+void SpatialGrid::build(const std::vector<cv::Rect>& boxes, int cell_size) {
+    cell_size_ = std::max(1, cell_size);
+    cols_ = rows_ = 0;
+    entries_.clear();
+    stamp_.assign(boxes.size(), 0);
+    query_id_ = 0;
+
+    if (boxes.empty()) {
+        cell_start_.assign(1, 0);
+        return;
+    }
+
+    // Grid bounds follow the boxes, so the tracker needs no knowledge of the frame size
+    int x0 = boxes[0].x, y0 = boxes[0].y, x1 = boxes[0].x + boxes[0].width, y1 = boxes[0].y + boxes[0].height;
+    for (const auto& b : boxes) {
+        x0 = std::min(x0, b.x);
+        y0 = std::min(y0, b.y);
+        x1 = std::max(x1, b.x + b.width);
+        y1 = std::max(y1, b.y + b.height);
+    }
+    origin_ = cv::Point(x0, y0);
+    cols_ = (x1 - x0) / cell_size_ + 1;
+    rows_ = (y1 - y0) / cell_size_ + 1;
+
+    // Counting pass, prefix sum, then scatter (CSR)
+    const size_t cells = static_cast<size_t>(cols_) * rows_;
+    cell_start_.assign(cells + 1, 0);
+    int c0, r0, c1, r1;
+    for (const auto& b : boxes) {
+        cellRange(b, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) ++cell_start_[static_cast<size_t>(r) * cols_ + c + 1];
+    }
+    for (size_t i = 1; i <= cells; ++i) cell_start_[i] += cell_start_[i - 1];
+
+    entries_.resize(static_cast<size_t>(cell_start_[cells]));
+    fill_.assign(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        cellRange(boxes[i], c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) entries_[fill_[static_cast<size_t>(r) * cols_ + c]++] = static_cast<int>(i);
+    }
+}
+
+bool SpatialGrid::cellRange(const cv::Rect& r, int& c0, int& r0, int& c1, int& r1) const {
+    // Floor division so areas left/above the origin clamp correctly
+    auto cellOf = [this](int v) { return v >= 0 ? v / cell_size_ : -((-v + cell_size_ - 1) / cell_size_); };
+    c0 = cellOf(r.x - origin_.x);
+    r0 = cellOf(r.y - origin_.y);
+    c1 = cellOf(r.x + std::max(0, r.width - 1) - origin_.x);
+    r1 = cellOf(r.y + std::max(0, r.height - 1) - origin_.y);
+    if (c1 < 0 || r1 < 0 || c0 >= cols_ || r0 >= rows_) return false;
+    c0 = std::max(c0, 0);
+    r0 = std::max(r0, 0);
+    c1 = std::min(c1, cols_ - 1);
+    r1 = std::min(r1, rows_ - 1);
+    return true;
+}
+
+void SpatialGrid::query(const cv::Rect& area, std::vector<int>& out) {
+    int c0, r0, c1, r1;
+    if (cols_ == 0 || !cellRange(area, c0, r0, c1, r1)) return;
+
+    ++query_id_;
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const size_t cell = static_cast<size_t>(r) * cols_ + c;
+            for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+                const int idx = entries_[k];
+                if (stamp_[idx] == query_id_) continue;
+                stamp_[idx] = query_id_;
+                out.push_back(idx);
+            }
+        }
+    }
+}
+
+} // namespace CCM
@@ -1,24 +1,46 @@
 #include <opencv2/opencv.hpp>
 #include <chrono>
 #include <iostream>
+#include <string>
+#include "camera_input.hpp"
+
+// Usage: test_camera [device] [--backend auto|v4l2|opencv] [--frames N] [--headless]
+//   device can be /dev/videoN, a v4l2loopback node, or a video file.
+int main(int argc, char** argv) {
+    CCM::CameraConfig cam_config;
+    int max_frames = -1;
+    bool headless = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--backend" && i + 1 < argc) {
+            cam_config.backend = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            max_frames = std::stoi(argv[++i]);
+        } else if (arg == "--headless") {
+            headless = true;
+        } else {
+            cam_config.device = arg;
+        }
+    }
 
-int main() {
-    cv::VideoCapture cap(0);  // Use 0 for default USB cam, or "nvarguscamerasrc" for Jetson CSI
+    CCM::CameraInput cap(cam_config);
 
-    if (!cap.isOpened()) {
+    if (!cap.open()) {
         std::cerr << "Failed to open camera.\n";
         return -1;
     }
+    std::cout << "Backend: " << cap.backendName() << "\n";
 
     cv::Mat frame;
     int frame_count = 0;
     auto start_time = std::chrono::steady_clock::now();
 
-    while (true) {
-        cap >> frame;
-        if (frame.empty()) break;
+    while (max_frames < 0 || frame_count < max_frames) {
+        if (!cap.read(frame)) break;
 
         frame_count++;
+        if (headless) continue;
 
         // Simple overlay
         cv::putText(frame, "CCM EdgeVision", {20, 40}, cv::FONT_HERSHEY_SIMPLEX, 1, {0,255,0}, 2);
@@ -0,0 +1,116 @@
+#include "tiling.hpp"
+#include <algorithm>
+
+namespace CCM {
+
+// Window starts along one axis: [lo, hi) covered by windows of `size`, stepping `stride`
+static std::vector<int> axisStarts(int lo, int hi, int size, int stride, int limit) {
+    std::vector<int> starts;
+    if (hi - lo <= size) {
+        // Centred on the span, shifted back inside [0, limit)
+        starts.push_back(std::min(std::max(0, (lo + hi - size) / 2), limit - size));
+        return starts;
+    }
+    for (int s = lo;; s += stride) {
+        const int start = std::min(s, hi - size);   // Last window ends exactly at hi
+        starts.push_back(std::min(std::max(0, start), limit - size));
+        if (start + size >= hi) break;
+    }
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    return starts;
+}
+
+std::vector<cv::Rect> tileRegion(const cv::Rect& region, const cv::Size& window, int overlap,
+                                 const cv::Size& frame_size) {
+    std::vector<cv::Rect> tiles;
+    const cv::Rect r = region & cv::Rect(cv::Point(0, 0), frame_size);
+    if (r.area() == 0 || window.area() <= 0) return tiles;
+
+    const int w = std::min(window.width, frame_size.width);
+    const int h = std::min(window.height, frame_size.height);
+    const int stride_x = std::max(1, w - std::max(0, overlap));
+    const int stride_y = std::max(1, h - std::max(0, overlap));
+
+    for (int y : axisStarts(r.y, r.br().y, h, stride_y, frame_size.height)) {
+        for (int x : axisStarts(r.x, r.br().x, w, stride_x, frame_size.width)) {
+            tiles.emplace_back(x, y, w, h);
+        }
+    }
+    return tiles;
+}
+
+std::vector<cv::Rect> mergeRects(std::vector<cv::Rect> rects) {
+    rects.erase(std::remove_if(rects.begin(), rects.end(), [](const cv::Rect& r) { return r.area() <= 0; }),
+                rects.end());
+    for (bool merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < rects.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                // Touching counts: grow by one pixel before testing
+                const cv::Rect grown(rects[i].x - 1, rects[i].y - 1, rects[i].width + 2, rects[i].height + 2);
+                if ((grown & rects[j]).area() == 0) continue;
+                rects[i] |= rects[j];
+                rects.erase(rects.begin() + static_cast<long>(j));
+                merged = true;
+                break;
+            }
+        }
+    }
+    return rects;
+}
+
+static float overlap(const cv::Rect2f& a, const cv::Rect2f& b) {
+    const float inter = (a & b).area();
+    return inter > 0.0f ? inter / (a.area() + b.area() - inter) : 0.0f;
+}
+
+void fuseBoxes(std::vector<cv::Rect>& boxes, std::vector<float>& confidences, std::vector<int>& class_ids,
+               float iou) {
+    std::vector<size_t> order(boxes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return confidences[a] > confidences[b]; });
+
+    // One cluster per fused box: running weighted sums, matched against the current fused box
+    struct Cluster {
+        int class_id;
+        cv::Rect2f fused;
+        float x1 = 0, y1 = 0, x2 = 0, y2 = 0, weight = 0;
+        int count = 0;
+    };
+    std::vector<Cluster> clusters;
+    for (size_t i : order) {
+        const cv::Rect2f box(boxes[i]);
+        const float c = confidences[i];
+        Cluster* match = nullptr;
+        for (Cluster& cluster : clusters) {
+            if (cluster.class_id == class_ids[i] && overlap(cluster.fused, box) >= iou) {
+                match = &cluster;
+                break;
+            }
+        }
+        if (!match) {
+            clusters.push_back(Cluster{class_ids[i], box});
+            match = &clusters.back();
+        }
+        match->x1 += c * box.x;
+        match->y1 += c * box.y;
+        match->x2 += c * (box.x + box.width);
+        match->y2 += c * (box.y + box.height);
+        match->weight += c;
+        ++match->count;
+        match->fused = cv::Rect2f(cv::Point2f(match->x1, match->y1) / match->weight,
+                                  cv::Point2f(match->x2, match->y2) / match->weight);
+    }
+
+    boxes.clear();
+    confidences.clear();
+    class_ids.clear();
+    for (const Cluster& cluster : clusters) {
+        boxes.push_back(cv::Rect(cvRound(cluster.fused.x), cvRound(cluster.fused.y), cvRound(cluster.fused.width),
+                                 cvRound(cluster.fused.height)));
+        confidences.push_back(cluster.weight / cluster.count);
+        class_ids.push_back(cluster.class_id);
+    }
+}
+
+} // namespace CCM
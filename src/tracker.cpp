@@ -1,84 +1,229 @@
 #include "tracker.hpp"
-#include <cmath>
-#include <limits>
 #include <algorithm>
+#include <cmath>
+#include "logger.hpp"
 
 namespace CCM {
 
-// Simple Euclidean distance helper
-// Return explicit float to avoid C4244
-static float calculateDistance(const cv::Point& a, const cv::Point& b) {
-    double dist_sq = std::pow(a.x - b.x, 2) + std::pow(a.y - b.y, 2);
-    return static_cast<float>(std::sqrt(dist_sq));
+static float squaredDistance(const cv::Point& a, const cv::Point& b) {
+    const float dx = static_cast<float>(a.x - b.x);
+    const float dy = static_cast<float>(a.y - b.y);
+    return dx * dx + dy * dy;
+}
+
+static cv::Point centerOf(const cv::Rect& r) {
+    return (r.tl() + r.br()) / 2;
 }
 
 Tracker::Tracker(int max_lost_frames, float dist_threshold) 
     : next_id_(1), max_lost_frames_(max_lost_frames), dist_threshold_(dist_threshold) {}
 
+Tracker::Tracker(const TrackerConfig& config) : next_id_(1) {
+    configure(config);
+}
+
+void Tracker::configure(const TrackerConfig& config) {
+    max_lost_frames_ = config.max_lost_frames;
+    dist_threshold_ = config.dist_threshold;
+    use_hungarian_ = config.mode == "hungarian";
+    iou_threshold_ = config.iou_threshold;
+    grid_cell_ = config.grid_cell;
+    if (!use_hungarian_ && config.mode != "greedy") {
+        CCM_LOG_WARN("Tracker", "Unknown tracker mode '%s', using greedy.", config.mode.c_str());
+    }
+}
+
 std::vector<TrackedObject> Tracker::update(const std::vector<cv::Rect>& detections) {
-    std::vector<TrackedObject> result_tracks;
-    
-    if (tracks_.empty()) {
-        for (const auto& rect : detections) {
-            register_object(rect);
+    updateImpl(detections, nullptr);
+    return tracks_;
+}
+
+std::vector<TrackedObject> Tracker::update(const std::vector<Detection>& detections) {
+    std::vector<TrackedObject> tracks;
+    update(detections, tracks);
+    return tracks;
+}
+
+void Tracker::update(const std::vector<Detection>& detections, std::vector<TrackedObject>& tracks) {
+    rects_.clear();
+    for (const auto& d : detections) rects_.push_back(d.box);
+    updateImpl(rects_, &detections);
+    tracks = tracks_;   // Element-wise copy: existing entries keep their storage
+}
+
+std::vector<TrackedObject> Tracker::predict() {
+    predictTracks();
+    return tracks_;
+}
+
+void Tracker::predict(std::vector<TrackedObject>& tracks) {
+    predictTracks();
+    tracks = tracks_;
+}
+
+void Tracker::predictTracks() {
+    for (auto& track : tracks_) {
+        track.rect = track.filter.predict();
+        track.center = centerOf(track.rect);
+    }
+}
+
+void Tracker::updateImpl(const std::vector<cv::Rect>& detections, const std::vector<Detection>* labels) {
+    matched_track_.assign(detections.size(), -1);
+
+    // Match against where each track is expected to be now, not where it was last seen
+    predictTracks();
+
+    if (!tracks_.empty()) {
+        if (use_hungarian_) matchHungarian(detections);
+        else matchGreedy(detections);
+    }
+
+    for (size_t i = 0; i < detections.size(); ++i) {
+        const Detection* label = labels ? &(*labels)[i] : nullptr;
+        if (matched_track_[i] < 0) {
+            register_object(detections[i], label);
+            continue;
         }
-    } else {
-        std::vector<bool> detection_used(detections.size(), false);
-        
-        for (auto& track : tracks_) {
-            float min_dist = std::numeric_limits<float>::max();
-            int best_idx = -1;
-
-            for (size_t i = 0; i < detections.size(); ++i) {
-                if (detection_used[i]) continue;
-
-                cv::Point center_det = (detections[i].tl() + detections[i].br()) / 2;
-                float dist = calculateDistance(track.center, center_det);
-
-                if (dist < min_dist && dist < dist_threshold_) {
-                    min_dist = dist;
-                    // FIX: Explicit cast from size_t (i) to int
-                    best_idx = static_cast<int>(i);
-                }
-            }
 
-            if (best_idx != -1) {
-                track.rect = detections[best_idx];
-                track.center = (detections[best_idx].tl() + detections[best_idx].br()) / 2;
-                track.lost_frames = 0;
-                detection_used[best_idx] = true;
-            } else {
-                track.lost_frames++;
-            }
+        TrackedObject& track = tracks_[matched_track_[i]];
+        track.filter.correct(detections[i]);
+        track.rect = detections[i];
+        track.center = centerOf(detections[i]);
+        track.lost_frames = 0;
+        if (label) {
+            track.class_id = label->class_id;
+            track.className = label->className;
+            track.confidence = label->confidence;
         }
+    }
+
+    // Swap-and-pop removal: O(1) per expired track instead of shifting the tail
+    for (size_t i = 0; i < tracks_.size();) {
+        if (tracks_[i].lost_frames > max_lost_frames_) {
+            tracks_[i] = tracks_.back();
+            tracks_.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void Tracker::matchGreedy(const std::vector<cv::Rect>& detections) {
+    const float max_dist_sq = dist_threshold_ * dist_threshold_;
+
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        TrackedObject& track = tracks_[t];
+        float min_dist = max_dist_sq;
+        int best_idx = -1;
 
         for (size_t i = 0; i < detections.size(); ++i) {
-            if (!detection_used[i]) {
-                register_object(detections[i]);
+            if (matched_track_[i] >= 0) continue;
+
+            float dist = squaredDistance(track.center, centerOf(detections[i]));
+            if (dist < min_dist) {
+                min_dist = dist;
+                best_idx = static_cast<int>(i);
             }
         }
-    }
 
-    auto it = tracks_.begin();
-    while (it != tracks_.end()) {
-        if (it->lost_frames > max_lost_frames_) {
-            it = tracks_.erase(it);
+        if (best_idx != -1) {
+            matched_track_[best_idx] = static_cast<int>(t);
         } else {
-            result_tracks.push_back(*it);
-            ++it;
+            track.lost_frames++;
+        }
+    }
+}
+
+float Tracker::pairCost(const TrackedObject& track, const cv::Rect& det) const {
+    const int inter = (track.rect & det).area();
+    if (inter > 0) {
+        const float iou = static_cast<float>(inter) / static_cast<float>(track.rect.area() + det.area() - inter);
+        if (iou >= iou_threshold_) return 1.0f - iou; // [0, 1)
+    }
+
+    // Small or fast objects may not overlap between frames: fall back to centroid distance,
+    // ranked behind every IoU match.
+    const float dist_sq = squaredDistance(track.center, centerOf(det));
+    if (dist_sq < dist_threshold_ * dist_threshold_) {
+        return 1.0f + std::sqrt(dist_sq) / dist_threshold_; // [1, 2)
+    }
+    return HungarianSolver::kInfeasible;
+}
+
+void Tracker::matchHungarian(const std::vector<cv::Rect>& detections) {
+    const int cell = grid_cell_ > 0 ? grid_cell_ : std::max(16, static_cast<int>(2.0f * dist_threshold_));
+    const int reach = static_cast<int>(std::ceil(dist_threshold_));
+    grid_.build(detections, cell);
+
+    // 1. Candidate pairs: only detections in grid cells near each track
+    candidates_.clear();
+    row_track_.clear();
+    for (size_t t = 0; t < tracks_.size(); ++t) {
+        const TrackedObject& track = tracks_[t];
+        const cv::Rect area(track.rect.x - reach, track.rect.y - reach,
+                            track.rect.width + 2 * reach, track.rect.height + 2 * reach);
+        nearby_.clear();
+        grid_.query(area, nearby_);
+
+        const int row = static_cast<int>(row_track_.size());
+        const size_t before = candidates_.size();
+        for (int d : nearby_) {
+            const float cost = pairCost(track, detections[d]);
+            if (cost < HungarianSolver::kInfeasible) candidates_.push_back({row, d, cost});
+        }
+
+        if (candidates_.size() > before) row_track_.push_back(static_cast<int>(t));
+        else tracks_[t].lost_frames++; // Nothing nearby: cannot match this frame
+    }
+
+    if (candidates_.empty()) return;
+
+    // 2. Compact cost matrix over tracks/detections that have at least one candidate
+    det_col_.assign(detections.size(), -1);
+    col_det_.clear();
+    for (const auto& c : candidates_) {
+        if (det_col_[c.det] < 0) {
+            det_col_[c.det] = static_cast<int>(col_det_.size());
+            col_det_.push_back(c.det);
         }
     }
 
-    return result_tracks;
+    const int rows = static_cast<int>(row_track_.size());
+    const int cols = static_cast<int>(col_det_.size());
+    cost_.assign(static_cast<size_t>(rows) * cols, HungarianSolver::kInfeasible);
+    for (const auto& c : candidates_) {
+        cost_[static_cast<size_t>(c.row) * cols + det_col_[c.det]] = c.cost;
+    }
+
+    // 3. Global minimum-cost assignment
+    solver_.solve(cost_, rows, cols, assignment_);
+
+    for (int r = 0; r < rows; ++r) {
+        if (assignment_[r] < 0) {
+            tracks_[row_track_[r]].lost_frames++;
+            continue;
+        }
+        matched_track_[col_det_[assignment_[r]]] = row_track_[r];
+    }
+
+    CCM_LOG_TRACE("Tracker", "hungarian: %zu tracks, %zu detections, %zu candidate pairs, %dx%d matrix",
+                  tracks_.size(), detections.size(), candidates_.size(), rows, cols);
 }
 
-void Tracker::register_object(const cv::Rect& rect) {
+void Tracker::register_object(const cv::Rect& rect, const Detection* label) {
     TrackedObject new_obj;
     new_obj.id = next_id_++;
     new_obj.rect = rect;
-    new_obj.center = (rect.tl() + rect.br()) / 2;
+    new_obj.center = centerOf(rect);
     new_obj.lost_frames = 0;
+    new_obj.filter.init(rect);
+    if (label) {
+        new_obj.class_id = label->class_id;
+        new_obj.className = label->className;
+        new_obj.confidence = label->confidence;
+    }
     tracks_.push_back(new_obj);
 }
 
-} // namespace CCM
\ No newline at end of file
+} // namespace CCM
@@ -0,0 +1,105 @@
+#include "video_output.hpp"
+#include <sstream>
+#include "logger.hpp"
+
+namespace CCM {
+
+VideoOutput::VideoOutput(const OutputConfig& config) : config_(config) {}
+
+VideoOutput::~VideoOutput() {
+    stop();
+}
+
+int VideoOutput::addStream(const std::string& name, int fps) {
+    std::unique_ptr<Stream> stream(new Stream());
+    stream->name = name;
+
+    if (config_.mjpeg_port > 0) {
+        stream->mjpeg.reset(new MjpegSink(config_.jpeg_quality));
+        stream->encoders.emplace_back(new EncoderThread(*stream->mjpeg, config_.max_fps));
+    }
+    if (!config_.rtsp_url.empty()) {
+        std::string url = config_.rtsp_url;
+        const size_t pos = url.find("{name}");
+        if (pos != std::string::npos) url.replace(pos, 6, name);
+        stream->rtsp.reset(new RtspSink(url, config_.max_fps > 0 ? config_.max_fps : fps, config_.rtsp_bitrate_kbps,
+                                        config_.ffmpeg));
+        stream->encoders.emplace_back(new EncoderThread(*stream->rtsp, config_.max_fps));
+    }
+
+    streams_.push_back(std::move(stream));
+    return static_cast<int>(streams_.size()) - 1;
+}
+
+std::string VideoOutput::indexPage() const {
+    std::ostringstream oss;
+    oss << "<html><head><title>CCM EdgeVision</title>"
+        << "<style>body{background:#121212;color:#eee;font-family:monospace;text-align:center}"
+        << "img{border:2px solid #333;margin:8px;max-width:48%}</style></head><body>"
+        << "<h1>CCM EdgeVision</h1>";
+    for (const auto& s : streams_) {
+        oss << "<div style=\"display:inline-block\"><div>" << s->name << "</div>"
+            << "<img src=\"/stream/" << s->name << ".mjpg\"></div>";
+    }
+    oss << "</body></html>";
+    return oss.str();
+}
+
+void VideoOutput::start() {
+    if (!enabled()) return;
+
+    if (config_.mjpeg_port > 0) {
+        for (size_t i = 0; i < streams_.size(); ++i) {
+            MjpegSink* sink = streams_[i]->mjpeg.get();
+            auto stream = [sink](HttpConnection& conn) { sink->serveStream(conn); };
+            auto snapshot = [sink](HttpConnection& conn) { sink->serveSnapshot(conn); };
+            server_.addRoute("/stream/" + streams_[i]->name + ".mjpg", stream);
+            server_.addRoute("/snapshot/" + streams_[i]->name + ".jpg", snapshot);
+            if (i == 0) {
+                server_.addRoute("/stream.mjpg", stream);
+                server_.addRoute("/snapshot.jpg", snapshot);
+            }
+        }
+
+        const std::string page = indexPage();
+        server_.addRoute("/", [page](HttpConnection& conn) { conn.sendResponse(200, "text/html", page); });
+
+        std::ostringstream names;
+        names << "[";
+        for (size_t i = 0; i < streams_.size(); ++i) names << (i ? "," : "") << "\"" << streams_[i]->name << "\"";
+        names << "]";
+        const std::string json = names.str();
+        server_.addRoute("/streams.json", [json](HttpConnection& conn) {
+            conn.sendResponse(200, "application/json", json);
+        });
+
+        if (server_.start(config_.bind, config_.mjpeg_port)) {
+            CCM_LOG_INFO("Output", "MJPEG preview at http://%s:%d/", config_.bind.c_str(), config_.mjpeg_port);
+        }
+    }
+
+    for (auto& s : streams_) {
+        for (auto& e : s->encoders) e->start();
+    }
+}
+
+void VideoOutput::stop() {
+    server_.stop();
+    for (auto& s : streams_) {
+        for (auto& e : s->encoders) {
+            e->stop();
+            if (e->encoded() > 0) {
+                CCM_LOG_INFO("Output", "[%s] encoded %llu frames, skipped %llu (encoder busy)", s->name.c_str(),
+                             static_cast<unsigned long long>(e->encoded()),
+                             static_cast<unsigned long long>(e->skipped()));
+            }
+        }
+    }
+}
+
+void VideoOutput::submit(int stream_id, const cv::Mat& frame) {
+    if (stream_id < 0 || stream_id >= static_cast<int>(streams_.size())) return;
+    for (auto& e : streams_[stream_id]->encoders) e->submit(frame);
+}
+
+} // namespace CCM
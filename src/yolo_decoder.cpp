@@ -0,0 +1,248 @@
+#include "yolo_decoder.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include "logger.hpp"
+
+namespace CCM {
+
+// Returns the index of the first maximum class score, or -1 if no score is > 0
+// (same semantics as the original scalar loop with best_class_score starting at 0).
+static inline int argmaxScore(const float* scores, int n, float& best_score) {
+    float m = 0.0f;
+    int c = 0;
+
+#if CV_SIMD
+    const int lanes = cv::v_float32::nlanes;
+    if (n >= lanes) {
+        cv::v_float32 vmax = cv::vx_load(scores);
+        for (c = lanes; c + lanes <= n; c += lanes) {
+            vmax = cv::v_max(vmax, cv::vx_load(scores + c));
+        }
+        m = std::max(m, cv::v_reduce_max(vmax));
+    }
+#endif
+    for (; c < n; ++c) m = std::max(m, scores[c]);
+
+    if (m <= 0.0f) return -1;
+
+    for (int k = 0; k < n; ++k) {
+        if (scores[k] == m) {
+            best_score = m;
+            return k;
+        }
+    }
+    return -1;
+}
+
+YoloLayout YoloLayout::detect(int rows, int cols, int num_classes) {
+    YoloLayout layout;
+    layout.channel_major = rows < cols;
+    const int channels = layout.channel_major ? rows : cols;
+    if (channels == num_classes + 5) {
+        layout.objectness = true;
+    } else if (channels == num_classes + 4) {
+        layout.objectness = false;
+    } else {
+        layout.objectness = !layout.channel_major;
+    }
+    return layout;
+}
+
+const char* YoloLayout::name() const {
+    if (channel_major) return objectness ? "channel-major with objectness" : "YOLOv8 (channel-major)";
+    return objectness ? "YOLOv5 (row-major)" : "row-major without objectness";
+}
+
+void YoloDecoder::decode(const cv::Mat& output,
+                         const LetterboxInfo& letterbox,
+                         float conf_threshold,
+                         int max_classes,
+                         float debug_threshold,
+                         const YoloLayout& layout) {
+    boxes_.clear();
+    confidences_.clear();
+    class_ids_.clear();
+    if (output.empty() || output.dims != 2 || output.type() != CV_32F) return;
+
+    if (layout.channel_major) {
+        if (layout.objectness) {
+            decodeLayout<true, true>(output, letterbox, conf_threshold, max_classes, debug_threshold);
+        } else {
+            decodeLayout<true, false>(output, letterbox, conf_threshold, max_classes, debug_threshold);
+        }
+    } else {
+        if (layout.objectness) {
+            decodeLayout<false, true>(output, letterbox, conf_threshold, max_classes, debug_threshold);
+        } else {
+            decodeLayout<false, false>(output, letterbox, conf_threshold, max_classes, debug_threshold);
+        }
+    }
+}
+
+template <bool ChannelMajor, bool Objectness>
+void YoloDecoder::decodeLayout(const cv::Mat& output,
+                               const LetterboxInfo& letterbox,
+                               float conf_threshold,
+                               int max_classes,
+                               float debug_threshold) {
+    constexpr int first_class = Objectness ? 5 : 4;
+    const int anchors = ChannelMajor ? output.cols : output.rows;
+    const int channels = ChannelMajor ? output.rows : output.cols;
+    const int num_classes = std::min(channels - first_class, max_classes);
+    if (anchors == 0 || num_classes <= 0) return;
+    const bool debug = debug_threshold >= 0.0f;
+
+    int block = 1;
+#if CV_SIMD
+    block = cv::v_float32::nlanes;
+    const int simd_anchors = anchors - anchors % block;
+#endif
+
+    if (ChannelMajor) {
+        // Class argmax for all anchors at once: class rows are contiguous, so walk them one after
+        // another and keep a running best (first maximum wins, as in argmaxScore)
+        best_score_.assign(output.ptr<float>(first_class), output.ptr<float>(first_class) + anchors);
+        best_class_.assign(static_cast<size_t>(anchors), 0.0f);
+        float* best = best_score_.data();
+        float* best_class = best_class_.data();
+        for (int c = 1; c < num_classes; ++c) {
+            const float* scores = output.ptr<float>(first_class + c);
+            int a = 0;
+#if CV_SIMD
+            const cv::v_float32 vc = cv::vx_setall_f32(static_cast<float>(c));
+            for (; a < simd_anchors; a += block) {
+                const cv::v_float32 v = cv::vx_load(scores + a);
+                const cv::v_float32 vbest = cv::vx_load(best + a);
+                const cv::v_float32 higher = v > vbest;
+                cv::v_store(best + a, cv::v_select(higher, v, vbest));
+                cv::v_store(best_class + a, cv::v_select(higher, vc, cv::vx_load(best_class + a)));
+            }
+#endif
+            for (; a < anchors; ++a) {
+                if (scores[a] > best[a]) {
+                    best[a] = scores[a];
+                    best_class[a] = static_cast<float>(c);
+                }
+            }
+        }
+
+        // Channel rows read in place (anchor a of channel k is row k, column a)
+        const float* gate = Objectness ? output.ptr<float>(4) : best;
+        const float* cx = output.ptr<float>(0);
+        const float* cy = output.ptr<float>(1);
+        const float* w = output.ptr<float>(2);
+        const float* h = output.ptr<float>(3);
+        for (int base = 0; base < anchors; base += block) {
+#if CV_SIMD
+            if (base < simd_anchors && cv::v_reduce_max(cv::vx_load(gate + base)) < conf_threshold) continue;
+#endif
+            const int end = std::min(anchors, base + block);
+            for (int a = base; a < end; ++a) {
+                if (gate[a] < conf_threshold || best[a] <= 0.0f) continue;
+                const float conf = Objectness ? gate[a] * best[a] : best[a];
+                if (debug && gate[a] >= debug_threshold) {
+                    CCM_LOG_TRACE("Decoder", "Score: %.3f | Combined: %.3f | Candidate class id: %d", best[a], conf,
+                                  static_cast<int>(best_class[a]));
+                }
+                if (conf < conf_threshold) continue;
+                push(cx[a], cy[a], w[a], h[a], conf, static_cast<int>(best_class[a]), letterbox, debug);
+            }
+        }
+        return;
+    }
+
+    // Row-major: each anchor is one row. With objectness, gather that column contiguously
+    // (reused across frames) so most rows can be rejected a SIMD block at a time.
+    const float* obj = nullptr;
+    if (Objectness) {
+        objectness_.resize(static_cast<size_t>(anchors));
+        for (int i = 0; i < anchors; ++i) {
+            objectness_[i] = output.ptr<float>(i)[4];
+        }
+        obj = objectness_.data();
+    }
+
+    for (int base = 0; base < anchors; base += block) {
+#if CV_SIMD
+        // Most rows are background: reject a whole block of rows with one reduction
+        if (Objectness && base < simd_anchors && cv::v_reduce_max(cv::vx_load(obj + base)) < conf_threshold) {
+            continue;
+        }
+#endif
+        const int end = std::min(anchors, base + block);
+        for (int i = base; i < end; ++i) {
+            const float obj_conf = Objectness ? obj[i] : 1.0f;
+            if (Objectness && obj_conf < conf_threshold) continue;
+
+            const float* data = output.ptr<float>(i);
+
+            float best_class_score = 0.0f;
+            const int best_class_id = argmaxScore(data + first_class, num_classes, best_class_score);
+            if (best_class_id < 0) continue;
+
+            // Combined confidence = objectness * class probability
+            const float combined_conf = Objectness ? obj_conf * best_class_score : best_class_score;
+
+            if (debug && (Objectness ? obj_conf : best_class_score) >= debug_threshold) {
+                CCM_LOG_TRACE("Decoder", "Obj: %.3f | Class Score: %.3f | Combined: %.3f | Candidate class id: %d",
+                              obj_conf, best_class_score, combined_conf, best_class_id);
+            }
+
+            if (combined_conf < conf_threshold) continue;
+            push(data[0], data[1], data[2], data[3], combined_conf, best_class_id, letterbox, debug);
+        }
+    }
+}
+
+bool YoloDecoder::push(float x, float y, float w, float h, float conf, int class_id, const LetterboxInfo& letterbox,
+                       bool debug) {
+    // Model gives coords in "model input" units (e.g. 640x640), including letterbox padding
+    const cv::Size& frame_size = letterbox.frame_size;
+    const float x_factor = 1.0f / letterbox.scale_x;
+    const float y_factor = 1.0f / letterbox.scale_y;
+
+    // Decode to pixel space
+    const float cx = (x - static_cast<float>(letterbox.pad_x)) * x_factor;
+    const float cy = (y - static_cast<float>(letterbox.pad_y)) * y_factor;
+    const float boxW = w * x_factor;
+    const float boxH = h * y_factor;
+
+    // Convert to top-left + size, in integer pixels
+    int left = static_cast<int>(cx - 0.5f * boxW);
+    int top = static_cast<int>(cy - 0.5f * boxH);
+    int widthPx = std::max(1, static_cast<int>(boxW));
+    int heightPx = std::max(1, static_cast<int>(boxH));
+
+    // Clamp to frame boundaries
+    if (left < 0) {
+        widthPx += left;
+        left = 0;
+    }
+    if (top < 0) {
+        heightPx += top;
+        top = 0;
+    }
+    if (left + widthPx > frame_size.width) widthPx = frame_size.width - left;
+    if (top + heightPx > frame_size.height) heightPx = frame_size.height - top;
+
+    if (widthPx <= 0 || heightPx <= 0) {
+        if (debug) {
+            CCM_LOG_TRACE("Decoder", "Skip: clamped box has non-positive size: left=%d top=%d "
+                          "width=%d height=%d (frame %dx%d)", left, top, widthPx, heightPx,
+                          frame_size.width, frame_size.height);
+        }
+        return false;
+    }
+
+    if (debug) {
+        CCM_LOG_TRACE("Decoder", "Decoded: left=%d top=%d width=%d height=%d (frame %dx%d)",
+                      left, top, widthPx, heightPx, frame_size.width, frame_size.height);
+    }
+
+    confidences_.push_back(conf);
+    boxes_.emplace_back(left, top, widthPx, heightPx);
+    class_ids_.push_back(class_id);
+    return true;
+}
+
+} // namespace CCM
@@ -0,0 +1,178 @@
+#include "zone_engine.hpp"
+#include <algorithm>
+#include <sstream>
+#include "logger.hpp"
+
+namespace CCM {
+
+const char* zoneEventName(ZoneEventType type) {
+    switch (type) {
+        case ZoneEventType::Enter: return "enter";
+        case ZoneEventType::Exit: return "exit";
+        case ZoneEventType::Dwell: return "dwell";
+        case ZoneEventType::Cross: return "cross";
+        default: return "unknown";
+    }
+}
+
+std::string ZoneEvent::toJSON() const {
+    std::ostringstream oss;
+    oss << "{"
+        << "\"type\":\"" << zoneEventName(type) << "\","
+        << "\"camera\":\"" << camera << "\","
+        << "\"zone\":\"" << zone << "\","
+        << "\"track_id\":" << track_id << ","
+        << "\"class_id\":" << class_id << ","
+        << "\"x\":" << position.x << ","
+        << "\"y\":" << position.y << ","
+        << "\"frame_id\":" << frame_id << ","
+        << "\"ts_ms\":" << timestamp_ms;
+    if (type == ZoneEventType::Cross) oss << ",\"direction\":\"" << (direction > 0 ? "in" : "out") << "\"";
+    if (type == ZoneEventType::Exit || type == ZoneEventType::Dwell) oss << ",\"dwell_s\":" << dwell_s;
+    if (lost) oss << ",\"lost\":true";
+    oss << "}";
+    return oss.str();
+}
+
+ZoneEngine::ZoneEngine(const std::string& camera, MpmcRing<ZoneEvent>& events)
+    : camera_(camera), events_(events) {}
+
+ZoneEvent ZoneEngine::makeEvent(ZoneEventType type, const std::string& name, int track_id,
+                                const TrackState& state) const {
+    ZoneEvent e;
+    e.type = type;
+    e.camera = camera_;
+    e.zone = name;
+    e.track_id = track_id;
+    e.class_id = state.class_id;
+    e.position = state.position;
+    e.frame_id = frame_id_;
+    e.timestamp_ms = wall_ms_;
+    return e;
+}
+
+void ZoneEngine::emit(ZoneEvent&& event) {
+    CCM_LOG_DEBUG("Zones", "[%s] %s %s track=%d", camera_.c_str(), zoneEventName(event.type), event.zone.c_str(),
+                  event.track_id);
+    if (!events_.try_push(std::move(event))) ++dropped_;
+}
+
+void ZoneEngine::closeVisits(int track_id, TrackState& state, std::chrono::steady_clock::time_point now) {
+    for (size_t z = 0; z < index_->size(); ++z) {
+        if (!state.inside.test(z)) continue;
+        ZoneEvent e = makeEvent(ZoneEventType::Exit, index_->zone(z).name, track_id, state);
+        e.lost = true;
+        e.dwell_s = std::chrono::duration<float>(now - state.entered_at[z]).count();
+        emit(std::move(e));
+    }
+    state.inside.reset();
+}
+
+void ZoneEngine::update(const AppConfig& config, const std::vector<TrackedObject>& tracks, uint64_t frame_id,
+                        std::chrono::steady_clock::time_point now) {
+    frame_id_ = frame_id;
+    wall_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // A new index (config reload) renumbers zones and lines: close open visits against the old one
+    if (config.zone_index != index_) {
+        if (index_) {
+            for (auto& entry : tracks_) closeVisits(entry.first, entry.second, now);
+        }
+        tracks_.clear();
+        index_ = config.zone_index;
+        line_counts_.assign(index_ ? index_->lineCount() : 0, LineCount());
+        for (size_t l = 0; l < line_counts_.size(); ++l) line_counts_[l].name = index_->line(l).name;
+    }
+    if (!index_ || (index_->size() == 0 && index_->lineCount() == 0)) return;
+
+    const int debounce = config.events.debounce_frames;   // [1, 255] (AppConfig::validate): streak is 8-bit
+    const float margin = static_cast<float>(std::max(0, config.events.line_margin));
+    const auto dwell = std::chrono::duration<float>(config.events.dwell_s);
+
+    for (const auto& t : tracks) {
+        auto inserted = tracks_.emplace(t.id, TrackState());
+        TrackState& s = inserted.first->second;
+        if (inserted.second) {
+            s.streak.assign(index_->size(), 0);
+            s.entered_at.resize(index_->size());
+            s.line_side.assign(index_->lineCount(), 0);
+            s.line_anchor.resize(index_->lineCount());
+        }
+        s.seen_frame = frame_id;
+        if (t.class_id >= 0) s.class_id = t.class_id;
+        s.position = (t.rect.tl() + t.rect.br()) / 2;
+
+        // Zones: raw membership from the raster, debounced per zone
+        const ZoneMask raw = index_->zonesAt(s.position) & index_->eventZones(s.class_id);
+        const ZoneMask changed = raw ^ s.inside;
+        if ((changed | s.pending).any()) {
+            for (size_t z = 0; z < index_->size(); ++z) {
+                if (!changed.test(z)) {
+                    s.streak[z] = 0;
+                } else if (++s.streak[z] >= debounce) {
+                    s.streak[z] = 0;
+                    const std::string& name = index_->zone(z).name;
+                    if (raw.test(z)) {
+                        s.inside.set(z);
+                        s.dwell_reported.reset(z);
+                        s.entered_at[z] = now;
+                        emit(makeEvent(ZoneEventType::Enter, name, t.id, s));
+                    } else {
+                        s.inside.reset(z);
+                        ZoneEvent e = makeEvent(ZoneEventType::Exit, name, t.id, s);
+                        e.dwell_s = std::chrono::duration<float>(now - s.entered_at[z]).count();
+                        emit(std::move(e));
+                    }
+                }
+                s.pending.set(z, s.streak[z] != 0);
+            }
+        }
+
+        // Dwell: once per visit
+        if (dwell.count() > 0.0f && (s.inside & ~s.dwell_reported).any()) {
+            for (size_t z = 0; z < index_->size(); ++z) {
+                if (!s.inside.test(z) || s.dwell_reported.test(z) || now - s.entered_at[z] < dwell) continue;
+                s.dwell_reported.set(z);
+                ZoneEvent e = makeEvent(ZoneEventType::Dwell, index_->zone(z).name, t.id, s);
+                e.dwell_s = std::chrono::duration<float>(now - s.entered_at[z]).count();
+                emit(std::move(e));
+            }
+        }
+
+        // Lines: side changes beyond the dead band that pass through the segment
+        const cv::Point2f p(static_cast<float>(s.position.x), static_cast<float>(s.position.y));
+        for (size_t l = 0; l < index_->lineCount(); ++l) {
+            const ZoneIndex::Line& line = index_->line(l);
+            if (line.class_id >= 0 && line.class_id != s.class_id) continue;
+
+            const float d = index_->side(l, p);
+            const int8_t side = d > margin ? 1 : (d < -margin ? -1 : 0);
+            if (side == 0) continue;   // On the line: keep the previous side
+            if (s.line_side[l] != 0 && side != s.line_side[l] && index_->crosses(l, s.line_anchor[l], p)) {
+                const int direction = side > 0 ? 1 : -1;
+                if (direction > 0) ++line_counts_[l].in;
+                else ++line_counts_[l].out;
+                if (line.direction == 0 || line.direction == direction) {
+                    ZoneEvent e = makeEvent(ZoneEventType::Cross, line.name, t.id, s);
+                    e.direction = direction;
+                    emit(std::move(e));
+                }
+            }
+            s.line_side[l] = side;
+            s.line_anchor[l] = p;
+        }
+    }
+
+    // Tracks the tracker dropped this frame
+    for (auto it = tracks_.begin(); it != tracks_.end();) {
+        if (it->second.seen_frame == frame_id) {
+            ++it;
+            continue;
+        }
+        closeVisits(it->first, it->second, now);
+        it = tracks_.erase(it);
+    }
+}
+
+} // namespace CCM
@@ -0,0 +1,186 @@
+#include "zone_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include "logger.hpp"
+#include "tiling.hpp"
+
+namespace CCM {
+
+static float cross(const cv::Point2f& u, const cv::Point2f& v) {
+    return u.x * v.y - u.y * v.x;
+}
+
+ZoneIndex::ZoneIndex(const std::vector<ZoneConfig>& zones, const std::vector<LineConfig>& lines,
+                     const std::vector<std::string>& active_search_zones, const std::vector<std::string>& class_names,
+                     int cell_size)
+    : cell_size_(std::max(1, cell_size)) {
+    if (zones.size() > kMaxZones) {
+        CCM_LOG_WARN("Zones", "%zu zones configured; only the first %zu are used", zones.size(), kMaxZones);
+    }
+    zones_.assign(zones.begin(), zones.begin() + std::min(zones.size(), kMaxZones));
+
+    // Active search zones and trigger classes become bit masks
+    restricted_ = !active_search_zones.empty();
+    triggers_.assign(class_names.size(), ZoneMask());
+    for (size_t i = 0; i < zones_.size(); ++i) {
+        const ZoneConfig& zone = zones_[i];
+        if (std::find(active_search_zones.begin(), active_search_zones.end(), zone.name) != active_search_zones.end()) {
+            active_.set(i);
+            active_regions_.push_back(zone.rect);
+        }
+        if (zone.trigger_class.empty()) {
+            any_class_.set(i);
+            continue;
+        }
+        const auto it = std::find(class_names.begin(), class_names.end(), zone.trigger_class);
+        if (it == class_names.end()) {
+            CCM_LOG_WARN("Zones", "Zone '%s': trigger_class '%s' is not a model class; it will never alert",
+                         zone.name.c_str(), zone.trigger_class.c_str());
+            continue;
+        }
+        triggers_[static_cast<size_t>(it - class_names.begin())].set(i);
+    }
+
+    active_regions_ = mergeRects(active_regions_);
+
+    for (const auto& l : lines) {
+        Line line;
+        line.name = l.name;
+        line.a = cv::Point2f(static_cast<float>(l.a.x), static_cast<float>(l.a.y));
+        line.d = cv::Point2f(static_cast<float>(l.b.x - l.a.x), static_cast<float>(l.b.y - l.a.y));
+        line.length = std::sqrt(line.d.x * line.d.x + line.d.y * line.d.y);
+        if (line.length < 1.0f) {
+            CCM_LOG_WARN("Zones", "Line '%s' has zero length, skipped", l.name.c_str());
+            continue;
+        }
+        line.class_id = -1;
+        if (!l.trigger_class.empty()) {
+            const auto it = std::find(class_names.begin(), class_names.end(), l.trigger_class);
+            if (it == class_names.end()) {
+                CCM_LOG_WARN("Zones", "Line '%s': trigger_class '%s' is not a model class; it will never count",
+                             l.name.c_str(), l.trigger_class.c_str());
+                continue;
+            }
+            line.class_id = static_cast<int>(it - class_names.begin());
+        }
+        line.direction = l.direction == "in" ? 1 : l.direction == "out" ? -1 : 0;
+        if (line.direction == 0 && l.direction != "both") {
+            CCM_LOG_WARN("Zones", "Line '%s': unknown direction '%s', using both", l.name.c_str(), l.direction.c_str());
+        }
+        lines_.push_back(line);
+    }
+
+    for (const auto& zone : zones_) {
+        if (zone.rect.area() > 0) bounds_ = bounds_.area() > 0 ? (bounds_ | zone.rect) : zone.rect;
+    }
+    if (bounds_.area() == 0) return;
+
+    cols_ = (bounds_.width + cell_size_ - 1) / cell_size_;
+    const int rows = (bounds_.height + cell_size_ - 1) / cell_size_;
+    std::vector<Cell> raw(static_cast<size_t>(cols_) * rows);
+
+    // Rasterise each zone over its bounding box and classify the cells it touches
+    for (size_t i = 0; i < zones_.size(); ++i) {
+        const ZoneConfig& zone = zones_[i];
+        const cv::Rect r = zone.rect & bounds_;
+        if (r.area() == 0) continue;
+
+        cv::Mat1b mask(r.size(), static_cast<uchar>(zone.polygon.empty() ? 255 : 0));
+        if (!zone.polygon.empty()) {
+            std::vector<std::vector<cv::Point>> poly(1);
+            for (const auto& p : zone.polygon) poly[0].push_back(p - r.tl());
+            cv::fillPoly(mask, poly, cv::Scalar(255));
+        }
+
+        const int cx0 = (r.x - bounds_.x) / cell_size_, cx1 = (r.br().x - 1 - bounds_.x) / cell_size_;
+        const int cy0 = (r.y - bounds_.y) / cell_size_, cy1 = (r.br().y - 1 - bounds_.y) / cell_size_;
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const cv::Rect cell = cv::Rect(bounds_.x + cx * cell_size_, bounds_.y + cy * cell_size_, cell_size_,
+                                               cell_size_) & bounds_;
+                const cv::Rect overlap = cell & r;
+                const int covered = cv::countNonZero(mask(overlap - r.tl()));
+                if (covered == 0) continue;
+                Cell& c = raw[static_cast<size_t>(cy) * cols_ + cx];
+                if (covered == cell.area()) c.full.set(i);
+                else c.edge.set(i);
+            }
+        }
+    }
+
+    // Most cells share a handful of distinct contents: store each once
+    struct CellHash {
+        size_t operator()(const Cell& c) const {
+            return std::hash<ZoneMask>()(c.full) * 31u ^ std::hash<ZoneMask>()(c.edge);
+        }
+    };
+    struct CellEqual {
+        bool operator()(const Cell& a, const Cell& b) const { return a.full == b.full && a.edge == b.edge; }
+    };
+    std::unordered_map<Cell, uint32_t, CellHash, CellEqual> ids;
+    palette_.push_back(Cell());
+    ids.emplace(Cell(), 0u);
+
+    cells_.resize(raw.size());
+    for (size_t k = 0; k < raw.size(); ++k) {
+        const auto inserted = ids.emplace(raw[k], static_cast<uint32_t>(palette_.size()));
+        if (inserted.second) palette_.push_back(raw[k]);
+        cells_[k] = inserted.first->second;
+    }
+
+    edge_zones_.resize(palette_.size());
+    for (size_t p = 0; p < palette_.size(); ++p) {
+        for (size_t i = 0; i < zones_.size(); ++i) {
+            if (palette_[p].edge.test(i)) edge_zones_[p].push_back(static_cast<uint8_t>(i));
+        }
+    }
+
+    CCM_LOG_DEBUG("Zones", "Indexed %zu zones: %dx%d cells of %d px, %zu distinct cells; %zu lines", zones_.size(),
+                  cols_, rows, cell_size_, palette_.size(), lines_.size());
+}
+
+bool ZoneIndex::containsExact(size_t zone, const cv::Point& p) const {
+    const ZoneConfig& z = zones_[zone];
+    if (z.polygon.empty()) return z.rect.contains(p);
+    return cv::pointPolygonTest(z.polygon, cv::Point2f(static_cast<float>(p.x), static_cast<float>(p.y)), false) >= 0;
+}
+
+ZoneMask ZoneIndex::zonesAt(const cv::Point& p) const {
+    if (cells_.empty() || !bounds_.contains(p)) return ZoneMask();
+    const uint32_t id = cells_[static_cast<size_t>((p.y - bounds_.y) / cell_size_) * cols_ +
+                               (p.x - bounds_.x) / cell_size_];
+    ZoneMask mask = palette_[id].full;
+    for (uint8_t zone : edge_zones_[id]) {
+        if (containsExact(zone, p)) mask.set(zone);
+    }
+    return mask;
+}
+
+ZoneMask ZoneIndex::alerts(const cv::Point& p, int class_id) const {
+    if (class_id < 0 || class_id >= static_cast<int>(triggers_.size()) || triggers_[class_id].none()) {
+        return ZoneMask();
+    }
+    return zonesAt(p) & triggers_[class_id];
+}
+
+ZoneMask ZoneIndex::eventZones(int class_id) const {
+    if (class_id < 0 || class_id >= static_cast<int>(triggers_.size())) return any_class_;
+    return triggers_[class_id] | any_class_;
+}
+
+float ZoneIndex::side(size_t i, const cv::Point2f& p) const {
+    const Line& l = lines_[i];
+    return cross(l.d, p - l.a) / l.length;
+}
+
+bool ZoneIndex::crosses(size_t i, const cv::Point2f& p0, const cv::Point2f& p1) const {
+    const Line& l = lines_[i];
+    const cv::Point2f m = p1 - p0;
+    // p0 and p1 on opposite sides of the line, and a and b on opposite sides of the motion
+    return cross(l.d, p0 - l.a) * cross(l.d, p1 - l.a) <= 0.0f &&
+           cross(m, l.a - p0) * cross(m, l.a + l.d - p0) <= 0.0f;
+}
+
+} // namespace CCM